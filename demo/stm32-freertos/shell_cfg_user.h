@@ -15,6 +15,7 @@
 #include "stm32f4xx_hal.h"
 #include "FreeRTOS.h"
 #include "portable.h"
+#include "task.h"
 
 /**
  * @brief 是否使用shell伴生对象
@@ -61,6 +62,12 @@
  */
 #define     SHELL_GET_TICK()            HAL_GetTick()
 
+/**
+ * @brief 获取当前任务标识
+ *        输出锁的嵌套由shell记录，输出锁使用普通互斥锁
+ */
+#define     SHELL_GET_TASK()            xTaskGetCurrentTaskHandle()
+
 /**
  * @brief 使用锁
  * @note 使用shell锁时，需要对加锁和解锁进行实现
@@ -23,6 +23,7 @@ Shell shell;
 char shellBuffer[512];
 
 static SemaphoreHandle_t shellMutex;
+static SemaphoreHandle_t shellWriteMutex;
 
 /**
  * @brief 用户shell写
@@ -61,7 +62,7 @@ short userShellRead(char *data, unsigned short len)
  */
 int userShellLock(Shell *shell)
 {
-    xSemaphoreTakeRecursive(shellMutex, portMAX_DELAY);
+    xSemaphoreTake(shellMutex, portMAX_DELAY);
     return 0;
 }
 
@@ -74,7 +75,33 @@ int userShellLock(Shell *shell)
  */
 int userShellUnlock(Shell *shell)
 {
-    xSemaphoreGiveRecursive(shellMutex);
+    xSemaphoreGive(shellMutex);
+    return 0;
+}
+
+/**
+ * @brief 用户shell输出上锁
+ * 
+ * @param shell shell
+ * 
+ * @return int 0
+ */
+int userShellWriteLock(Shell *shell)
+{
+    xSemaphoreTake(shellWriteMutex, portMAX_DELAY);
+    return 0;
+}
+
+/**
+ * @brief 用户shell输出解锁
+ * 
+ * @param shell shell
+ * 
+ * @return int 0
+ */
+int userShellWriteUnlock(Shell *shell)
+{
+    xSemaphoreGive(shellWriteMutex);
     return 0;
 }
 
@@ -85,11 +112,14 @@ int userShellUnlock(Shell *shell)
 void userShellInit(void)
 {
     shellMutex = xSemaphoreCreateMutex();
+    shellWriteMutex = xSemaphoreCreateMutex();
 
     shell.write = userShellWrite;
     shell.read = userShellRead;
     shell.lock = userShellLock;
     shell.unlock = userShellUnlock;
+    shell.writeLock = userShellWriteLock;
+    shell.writeUnlock = userShellWriteUnlock;
     shellInit(&shell, shellBuffer, 512);
     if (xTaskCreate(shellTask, "shell", 256, &shell, 5, NULL) != pdPASS)
     {
@@ -26,6 +26,13 @@ SHELL_EXPORT_KEY_AGENCY(SHELL_CMD_PERMISSION(0),
 
 static void signalHandler(int signal)
 {
+#if SHELL_USING_CANCEL == 1
+    if (shell.status.isActive)
+    {
+        shellCancel(&shell);
+        return;
+    }
+#endif
     demoExit(0);
 }
 
@@ -13,6 +13,8 @@
 #define __SHELL_CFG_USER_H__
 
 #include "stdlib.h"
+#include "pthread.h"
+#include "sched.h"
 unsigned int userGetTick();
 
 /**
@@ -26,6 +28,67 @@ unsigned int userGetTick();
  */
 #define     SHELL_SUPPORT_END_LINE      1
 
+/**
+ * @brief 使用可变长度的历史记录
+ */
+#define     SHELL_HISTORY_POOL          1
+
+/**
+ * @brief 历史记录反向搜索(Ctrl-R)的最大搜索长度
+ */
+#define     SHELL_HISTORY_SEARCH_LENGTH 32
+
+/**
+ * @brief 命令解析缓存数量
+ */
+#define     SHELL_EXEC_CACHE_SIZE       8
+
+/**
+ * @brief 使用锁
+ *        尾行输出会在日志线程中调用，需要使用输出锁
+ */
+#define     SHELL_USING_LOCK            1
+
+/**
+ * @brief 尾行输出合并缓冲大小
+ */
+#define     SHELL_END_LINE_BUFFER       1024
+
+/**
+ * @brief 是否支持后台执行命令
+ */
+#define     SHELL_USING_JOBS            1
+
+/**
+ * @brief 是否支持取消正在执行的命令
+ */
+#define     SHELL_USING_CANCEL          1
+
+/**
+ * @brief 命令提交队列长度
+ */
+#define     SHELL_SUBMIT_QUEUE_SIZE     8
+
+/**
+ * @brief 输入环形缓冲大小
+ */
+#define     SHELL_FEED_BUFFER_SIZE      64
+
+/**
+ * @brief 是否使用事件驱动的shell任务
+ */
+#define     SHELL_USING_POLL            1
+
+/**
+ * @brief 是否使用异步输出
+ */
+#define     SHELL_USING_TX              1
+
+/**
+ * @brief TX环形缓冲等待发送
+ */
+#define     SHELL_TX_WAIT(tx)           sched_yield()
+
 /**
  * @brief 使用执行未导出函数的功能
  *        启用后，可以通过`exec [addr] [args]`直接执行对应地址的函数
@@ -40,6 +103,11 @@ unsigned int userGetTick();
  */
 #define     SHELL_KEEP_RETURN_VALUE     1
 
+/**
+ * @brief shell格式化是否支持浮点数
+ */
+#define     SHELL_PRINT_FLOAT           1
+
 /**
  * @brief shell格式化输入的缓冲大小
  *        为0时不使用shell格式化输入
@@ -47,6 +115,21 @@ unsigned int userGetTick();
  */
 #define     SHELL_SCAN_BUFFER          128
 
+/**
+ * @brief shell任务每次读取的最大字节数
+ */
+#define     SHELL_READ_BUFFER           32
+
+/**
+ * @brief shell输出缓冲大小
+ */
+#define     SHELL_WRITE_BUFFER          256
+
+/**
+ * @brief 使用ANSI控制序列编辑命令行
+ */
+#define     SHELL_ANSI_EDIT             1
+
 /**
  * @brief 获取系统时间(ms)
  *        定义此宏为获取系统Tick，如`HAL_GetTick()`
@@ -54,6 +137,12 @@ unsigned int userGetTick();
  */
 #define     SHELL_GET_TICK()            userGetTick()
 
+/**
+ * @brief 获取当前任务标识
+ *        后台任务在其他线程中执行命令，`shellGetCurrent`需要区分线程
+ */
+#define     SHELL_GET_TASK()            pthread_self()
+
 /**
  * @brief shell内存分配
  *        shell本身不需要此接口，若使用shell伴生对象，需要进行定义
@@ -73,10 +162,62 @@ unsigned int userGetTick();
  */
 #define     SHELL_USING_FUNC_SIGNATURE  1
 
+/**
+ * @brief 命令参数内存池大小
+ */
+#define     SHELL_ARENA_SIZE            512
+
 /**
  * @brief 支持数组参数
  *        使能后，可以在命令中使用数组参数，如`cmd [1,2,3]`
  *        需要使能 `SHELL_USING_FUNC_SIGNATURE` 宏，并且配置 `SHELL_MALLOC`, `SHELL_FREE`
  */
 #define     SHELL_SUPPORT_ARRAY_PARAM   1
+
+/**
+ * @brief 命令索引大小
+ *        大于0时，shell在初始化时为命令表建立一个哈希索引，命令查找不再需要遍历命令表
+ */
+#define     SHELL_CMD_INDEX_SIZE        128
+
+/**
+ * @brief 使用排序的命令段
+ *        使能后，命令按照名称排序链接，shell对命令表的有序部分使用二分查找
+ */
+#define     SHELL_CMD_SORTED_SECTION    1
+
+/**
+ * @brief 使用紧凑的命令表
+ *        使能后，每个命令条目只包含属性和两个指针
+ */
+#define     SHELL_CMD_COMPACT           1
+
+/**
+ * @brief 动态命令表数量
+ *        大于0时，可以在运行时注册和注销命令表
+ */
+#define     SHELL_DYNAMIC_CMD_NUMBER    4
+
+/**
+ * @brief 动态命令表写者等待
+ */
+#define     SHELL_DYNAMIC_CMD_WAIT()    sched_yield()
+
+/**
+ * @brief 按键前缀树节点数量
+ *        大于0时，shell在初始化时将按键定义编译为前缀树
+ */
+#define     SHELL_KEY_TRIE_SIZE         64
+
+/**
+ * @brief 用户命令视图缓存数量
+ *        大于0时，shell在切换用户时为用户权限建立命令表的访问位图
+ */
+#define     SHELL_CMD_VIEW_NUMBER       2
+
+/**
+ * @brief 预编译函数签名的参数数量
+ *        大于0时，shell在初始化时将函数签名编译为参数类型数组
+ */
+#define     SHELL_SIGN_POOL_SIZE        32
 #endif
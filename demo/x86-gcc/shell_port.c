@@ -14,6 +14,7 @@
 #include "shell_fs.h"
 #include "shell_passthrough.h"
 #include "shell_secure_user.h"
+#include "shell_jobs.h"
 #include "log.h"
 #include "telnetd.h"
 #include <stdio.h>
@@ -23,11 +24,24 @@
 #include <string.h>
 #include <sys/time.h>
 #include <pthread.h>
+#include <poll.h>
+#include <fcntl.h>
 
 Shell shell;
 char shellBuffer[512];
 ShellFs shellFs;
+ShellJobs shellJobs;
 char shellPathBuffer[512] = "/";
+int shellNotifyPipe[2] = {-1, -1};
+ShellTx shellTx;
+char shellTxBuffer[1024];
+static struct
+{
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    char *data;
+    unsigned short len;
+} shellTxThread = {PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, NULL, 0};
 Log log = {
     .active = 1,
     .level = LOG_DEBUG
@@ -75,34 +89,171 @@ unsigned short userShellWrite(char *data, unsigned short len)
     return len;
 }
 
+/**
+ * @brief 用户shell启动发送
+ *        把需要发送的数据交给发送线程，立即返回
+ * 
+ * @param tx TX环形缓冲
+ * @param data 数据
+ * @param len 数据长度
+ */
+void userShellTxKick(ShellTx *tx, char *data, unsigned short len)
+{
+    pthread_mutex_lock(&shellTxThread.mutex);
+    shellTxThread.data = data;
+    shellTxThread.len = len;
+    pthread_cond_signal(&shellTxThread.cond);
+    pthread_mutex_unlock(&shellTxThread.mutex);
+}
+
+/**
+ * @brief 用户shell发送线程
+ *        模拟DMA发送，发送完成后调用`shellTxComplete`
+ * 
+ * @param param 参数
+ */
+void *userShellTxTask(void *param)
+{
+    char *data;
+    unsigned short len;
+
+    while (1)
+    {
+        pthread_mutex_lock(&shellTxThread.mutex);
+        while (shellTxThread.len == 0)
+        {
+            pthread_cond_wait(&shellTxThread.cond, &shellTxThread.mutex);
+        }
+        data = shellTxThread.data;
+        len = shellTxThread.len;
+        shellTxThread.len = 0;
+        pthread_mutex_unlock(&shellTxThread.mutex);
+
+        fwrite(data, 1, len, stdout);
+        fflush(stdout);
+        shellTxComplete(&shellTx, len);
+    }
+    return NULL;
+}
+
 /**
  * @brief 用户shell读
+ *        返回当前已经接收到的数据，配合`SHELL_READ_BUFFER`整块读取
+ *        shell任务中没有数据时立即返回，命令执行过程中最多等待100ms
  * 
  * @param data 数据
  * @return char 状态
  */
 unsigned short userShellRead(char *data, unsigned short len)
 {
-    unsigned short length = len;
-    while (length--)
+    struct pollfd fd = {.fd = STDIN_FILENO, .events = POLLIN};
+
+    fflush(stdout);
+    if (poll(&fd, 1, shell.status.isActive ? 100 : 0) <= 0)
     {
-        *data++ = getchar();
+        return 0;
     }
-    return len;
+    ssize_t length = read(STDIN_FILENO, data, len);
+    return length > 0 ? length : 0;
+}
+
+/**
+ * @brief 用户shell等待输入
+ *        等待标准输入或者通知管道可读
+ * 
+ * @param shell shell
+ * @param timeout 超时时间(ms)，-1表示一直等待
+ * 
+ * @return int 有数据返回1，超时返回0
+ */
+int userShellWait(struct shell_def *shell, int timeout)
+{
+    struct pollfd fd[2] = {
+        {.fd = STDIN_FILENO, .events = POLLIN},
+        {.fd = shellNotifyPipe[0], .events = POLLIN},
+    };
+    char buffer[16];
+
+    fflush(stdout);
+    if (poll(fd, 2, timeout) <= 0)
+    {
+        return 0;
+    }
+    if (fd[1].revents & POLLIN)
+    {
+        while (read(shellNotifyPipe[0], buffer, sizeof(buffer)) > 0);
+    }
+    return 1;
+}
+
+/**
+ * @brief 用户shell通知
+ *        向通知管道写入数据唤醒`userShellWait`，可以在信号处理中调用
+ * 
+ * @param shell shell
+ */
+void userShellNotify(struct shell_def *shell)
+{
+    char data = 0;
+    write(shellNotifyPipe[1], &data, 1);
 }
 
 #if SHELL_USING_LOCK == 1
-static int lockCount = 0;
+static pthread_mutex_t shellMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t shellWriteMutex = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * @brief 用户shell编辑锁上锁
+ * 
+ * @param shell shell
+ * 
+ * @return int 0
+ */
 int userShellLock(struct shell_def *shell)
 {
-    printf("lock: %d\r\n", lockCount);
+    pthread_mutex_lock(&shellMutex);
     return 0;
 }
 
 
+/**
+ * @brief 用户shell编辑锁解锁
+ * 
+ * @param shell shell
+ * 
+ * @return int 0
+ */
 int userShellUnlock(struct shell_def *shell)
 {
-    printf("unlock: %d\r\n", lockCount);
+    pthread_mutex_unlock(&shellMutex);
+    return 0;
+}
+
+
+/**
+ * @brief 用户shell输出锁上锁
+ * 
+ * @param shell shell
+ * 
+ * @return int 0
+ */
+int userShellWriteLock(struct shell_def *shell)
+{
+    pthread_mutex_lock(&shellWriteMutex);
+    return 0;
+}
+
+
+/**
+ * @brief 用户shell输出锁解锁
+ * 
+ * @param shell shell
+ * 
+ * @return int 0
+ */
+int userShellWriteUnlock(struct shell_def *shell)
+{
+    pthread_mutex_unlock(&shellWriteMutex);
     return 0;
 }
 #endif
@@ -122,7 +273,7 @@ size_t userShellListDir(char *path, char *buffer, size_t maxLen)
     int i;
     dir = opendir(path);
     memset(buffer, 0, maxLen);
-    while((ptr = readdir(dir)) != NULL)
+    while(!shellIsCancelled(shellGetCurrent()) && (ptr = readdir(dir)) != NULL)
     {
         strcat(buffer, ptr->d_name);
         strcat(buffer, "\t");
@@ -159,9 +310,21 @@ void userShellInit(void)
 
     shell.write = userShellWrite;
     shell.read = userShellRead;
+    shellTxInit(&shellTx, shellTxBuffer, sizeof(shellTxBuffer), userShellTxKick);
+    userNewThread(userShellTxTask, NULL);
+    shell.tx = &shellTx;
+    if (pipe(shellNotifyPipe) == 0)
+    {
+        fcntl(shellNotifyPipe[0], F_SETFL, O_NONBLOCK);
+        fcntl(shellNotifyPipe[1], F_SETFL, O_NONBLOCK);
+        shell.wait = userShellWait;
+        shell.notify = userShellNotify;
+    }
 #if SHELL_USING_LOCK == 1
     shell.lock = userShellLock;
     shell.unlock = userShellUnlock;
+    shell.writeLock = userShellWriteLock;
+    shell.writeUnlock = userShellWriteUnlock;
 #endif
     shellSetPath(&shell, shellPathBuffer);
     shellInit(&shell, shellBuffer, 512);
@@ -170,6 +333,8 @@ void userShellInit(void)
     log.write = terminalLogWrite;
     logRegister(&log, &shell);
 
+    shellJobsInit(&shellJobs, &shell, userNewThread);
+
     telentdInit(userNewThread);
 
     // logDebug("hello world");
@@ -222,8 +387,9 @@ void shellKeyTest(void)
     char data;
     Shell *shell = shellGetCurrent();
     SHELL_ASSERT(shell && shell->read, return);
-    while (1)
+    while (!shellIsCancelled(shell))
     {
+        shellFlush(shell);
         if (shell->read(&data, 1) == 1)
         {
             if (data == '\n' || data == '\r')
@@ -248,6 +414,81 @@ SHELL_EXPORT_CMD(
 SHELL_CMD_PERMISSION(0x00)|SHELL_CMD_TYPE(SHELL_TYPE_CMD_FUNC)|SHELL_CMD_DISABLE_RETURN,
 scanTest, shellScanTest, test scan);
 
+#if SHELL_USING_TX == 1
+static struct
+{
+    ShellTx tx;
+    char buffer[16];
+    char sent[32];
+    unsigned short length;
+    char *data;
+    unsigned short len;
+} shellTxTestState;
+
+/**
+ * @brief TX丢弃测试启动发送
+ *        只记录发送的数据，由测试调用`shellTxComplete`完成发送
+ * 
+ * @param tx TX环形缓冲
+ * @param data 数据
+ * @param len 数据长度
+ */
+static void shellTxTestKick(ShellTx *tx, char *data, unsigned short len)
+{
+    shellTxTestState.data = data;
+    shellTxTestState.len = len;
+}
+
+/**
+ * @brief TX丢弃测试完成一次发送
+ * 
+ * @param param 参数
+ */
+static void *shellTxTestComplete(void *param)
+{
+    char *data = shellTxTestState.data;
+    unsigned short len = shellTxTestState.len;
+
+    if (param)
+    {
+        usleep(50000);
+    }
+    shellTxTestState.len = 0;
+    memcpy(shellTxTestState.sent + shellTxTestState.length, data, len);
+    shellTxTestState.length += len;
+    shellTxComplete(&shellTxTestState.tx, len);
+    return NULL;
+}
+
+/**
+ * @brief TX丢弃测试
+ *        发送中的数据保持不完成，再写入超出缓冲的数据，检查只丢弃溢出部分的旧数据
+ */
+int shellTxTest(void)
+{
+    pthread_t thread;
+
+    memset(&shellTxTestState, 0, sizeof(shellTxTestState));
+    shellTxInit(&shellTxTestState.tx, shellTxTestState.buffer,
+                sizeof(shellTxTestState.buffer), shellTxTestKick);
+    shellTxTestState.tx.policy = SHELL_TX_DROP_OLDEST;
+    shellTxWrite(&shellTxTestState.tx, "abcd", 4);
+    shellTxWrite(&shellTxTestState.tx, "efghijkl", 8);
+    pthread_create(&thread, NULL, shellTxTestComplete, &shellTxTestState);
+    shellTxWrite(&shellTxTestState.tx, "mnopqrstuvwx", 12);
+    pthread_join(thread, NULL);
+    while (shellTxTestState.len > 0)
+    {
+        shellTxTestComplete(NULL);
+    }
+    shellTxTestState.sent[shellTxTestState.length] = 0;
+    shellPrint(shellGetCurrent(), "sent: %s\r\n", shellTxTestState.sent);
+    return strcmp(shellTxTestState.sent, "abcdijklmnopqrstuvwx") == 0 ? 0 : -1;
+}
+SHELL_EXPORT_CMD(SHELL_CMD_PERMISSION(0)|SHELL_CMD_TYPE(SHELL_TYPE_CMD_FUNC),
+txTest, shellTxTest, test tx drop oldest policy);
+#endif /** SHELL_USING_TX == 1 */
+
 
 void shellPassthroughTest(char *data, unsigned short len)
 {
@@ -353,3 +594,29 @@ int paramTest(int argc, char *argv[])
 }
 SHELL_EXPORT_CMD(SHELL_CMD_PERMISSION(0)|SHELL_CMD_TYPE(SHELL_TYPE_CMD_MAIN),
 paramTest, paramTest, test param);
+
+#if SHELL_DYNAMIC_CMD_NUMBER > 0
+int shellModuleHello(int argc, char *argv[])
+{
+    printf("hello from dynamic command table\r\n");
+    return 0;
+}
+
+ShellCommand shellModuleCommands[] =
+{
+    SHELL_CMD_ITEM(SHELL_CMD_PERMISSION(0)|SHELL_CMD_TYPE(SHELL_TYPE_CMD_MAIN),
+                   hello, shellModuleHello, dynamic command test),
+};
+
+int shellModuleTest(char *op)
+{
+    if (strcmp(op, "load") == 0)
+    {
+        return shellRegisterCommands(shellModuleCommands,
+                                     sizeof(shellModuleCommands) / sizeof(ShellCommand));
+    }
+    return shellUnregisterCommands(shellModuleCommands);
+}
+SHELL_EXPORT_CMD(SHELL_CMD_PERMISSION(0)|SHELL_CMD_TYPE(SHELL_TYPE_CMD_FUNC),
+moduleTest, shellModuleTest, dynamic command table test\r\nmoduleTest load|unload);
+#endif /** SHELL_DYNAMIC_CMD_NUMBER > 0 */
@@ -16,6 +16,204 @@ extern "C" {
 
 #include "shell.h"
 
+#if SHELL_CMD_COMPACT == 1
+/**
+ * @brief shell command cpp 支持 cmd 定义(紧凑命令表)
+ */
+typedef struct shell_command_cpp_cmd
+{
+    int attr;                                                   /**< 属性 */
+    const char *name;                                           /**< 命令名，格式为`命令名\0描述\0函数签名` */
+    int (*function)();                                          /**< 命令执行函数 */
+} ShellCommandCppCmd;
+
+/**
+ * @brief shell command cpp 支持 var 定义(紧凑命令表)
+ */
+typedef struct shell_command_cpp_var
+{
+    int attr;                                                   /**< 属性 */
+    const char *name;                                           /**< 变量名，格式为`变量名\0描述` */
+    void *value;                                                /**< 变量值 */
+} ShellCommandCppVar;
+
+/**
+ * @brief shell command cpp 支持 user 定义(紧凑命令表)
+ */
+typedef struct shell_command_cpp_user
+{
+    int attr;                                                   /**< 属性 */
+    const char *name;                                           /**< 用户名，格式为`用户名\0描述` */
+    const char *password;                                       /**< 用户密码 */
+} ShellCommandCppUser;
+
+/**
+ * @brief shell command cpp 支持 key 定义(紧凑命令表)
+ */
+typedef struct shell_command_cpp_key
+{
+    int attr;                                                   /**< 属性 */
+    const char *desc;                                           /**< 4字节按键键值，之后为描述 */
+    void (*function)(Shell *);                                  /**< 按键执行函数 */
+} ShellCommandCppKey;
+
+#if SHELL_USING_FUNC_SIGNATURE == 1
+typedef struct shell_command_cpp_param_parser
+{
+    int attr;                                                   /**< 属性 */
+    const char *type;                                           /**< 参数类型 */
+    const ShellParamParserFunc *func;                           /**< 解析函数和清理器 */
+} ShellCommandCppParamParser;
+#endif
+
+#if SHELL_USING_CMD_EXPORT == 1
+
+    #undef SHELL_EXPORT_CMD
+    /**
+     * @brief shell 命令定义
+     * 
+     * @param _attr 命令属性
+     * @param _name 命令名
+     * @param _func 命令函数
+     * @param _desc 命令描述
+     * @param ... 其他参数
+     */
+    #define SHELL_EXPORT_CMD(_attr, _name, _func, _desc, ...) \
+            extern "C" SHELL_USED const ShellCommandCppCmd \
+            shellCommand##_name SHELL_CMD_SECTION(_name) =  \
+            { \
+                _attr, \
+                #_name "\0" #_desc "\0", \
+                (int (*)())_func \
+            }
+
+#if SHELL_USING_FUNC_SIGNATURE == 1
+    #undef SHELL_EXPORT_CMD_SIGN
+    /**
+     * @brief shell 带签名的命令定义
+     * 
+     * @param _attr 命令属性
+     * @param _name 命令名
+     * @param _func 命令函数
+     * @param _desc 命令描述
+     * @param _sign 命令签名
+     */
+    #define SHELL_EXPORT_CMD_SIGN(_attr, _name, _func, _desc, _sign) \
+            extern "C" SHELL_USED const ShellCommandCppCmd \
+            shellCommand##_name SHELL_CMD_SECTION(_name) =  \
+            { \
+                _attr, \
+                #_name "\0" #_desc "\0" #_sign, \
+                (int (*)())_func \
+            }
+#endif /** SHELL_USING_FUNC_SIGNATURE == 1 */
+
+    #undef SHELL_EXPORT_VAR
+    /**
+     * @brief shell 变量定义
+     * 
+     * @param _attr 变量属性
+     * @param _name 变量名
+     * @param _value 变量值
+     * @param _desc 变量描述
+     */
+    #define SHELL_EXPORT_VAR(_attr, _name, _value, _desc) \
+            extern "C" SHELL_USED const ShellCommandCppVar \
+            shellVar##_name SHELL_CMD_SECTION(_name) =  \
+            { \
+                _attr, \
+                #_name "\0" #_desc, \
+                (void *)_value \
+            }
+
+    #undef SHELL_EXPORT_USER
+    /**
+     * @brief shell 用户定义
+     * 
+     * @param _attr 用户属性
+     * @param _name 用户名
+     * @param _password 用户密码
+     * @param _desc 用户描述
+     */
+    #define SHELL_EXPORT_USER(_attr, _name, _password, _desc) \
+            extern "C" SHELL_USED const ShellCommandCppUser \
+            shellUser##_name SHELL_CMD_SECTION(_name) =  \
+            { \
+                _attr|SHELL_CMD_TYPE(SHELL_TYPE_USER), \
+                #_name "\0" #_desc, \
+                #_password \
+            }
+
+    #undef SHELL_EXPORT_KEY
+    /**
+     * @brief shell 按键定义
+     * 
+     * @param _attr 按键属性
+     * @param _value 按键键值
+     * @param _func 按键函数
+     * @param _desc 按键描述
+     */
+    #define SHELL_EXPORT_KEY(_attr, _value, _func, _desc) \
+            const struct { char value[4]; char desc[sizeof(#_desc)]; } \
+            shellDesc##_value = {SHELL_KEY_BYTES(_value), #_desc}; \
+            extern "C" SHELL_USED const ShellCommandCppKey \
+            shellKey##_value SHELL_SECTION("shellCommand") =  \
+            { \
+                _attr|SHELL_CMD_TYPE(SHELL_TYPE_KEY), \
+                shellDesc##_value.value, \
+                (void (*)(Shell *))_func \
+            }
+
+#if SHELL_KEY_TRIE_SIZE > 0
+    #undef SHELL_EXPORT_KEY_SEQUENCE
+    /**
+     * @brief shell 按键序列定义
+     * 
+     * @param _attr 按键属性
+     * @param _name 按键名
+     * @param _sequence 按键序列(字符串)
+     * @param _func 按键函数
+     * @param _desc 按键描述
+     */
+    #define SHELL_EXPORT_KEY_SEQUENCE(_attr, _name, _sequence, _func, _desc) \
+            const struct { char value[4]; char desc[sizeof(#_desc "\0" _sequence)]; } \
+            shellDesc##_name = {{0, 0, 0, 0}, #_desc "\0" _sequence}; \
+            extern "C" SHELL_USED const ShellCommandCppKey \
+            shellKey##_name SHELL_SECTION("shellCommand") =  \
+            { \
+                _attr|SHELL_CMD_TYPE(SHELL_TYPE_KEY), \
+                shellDesc##_name.value, \
+                (void (*)(Shell *))_func \
+            }
+#endif /** SHELL_KEY_TRIE_SIZE > 0 */
+
+#if SHELL_USING_FUNC_SIGNATURE == 1
+    #undef SHELL_EXPORT_PARAM_PARSER
+    /**
+     * @brief shell 参数解析器定义
+     * 
+     * @param _attr 参数解析器属性
+     * @param _type 参数解析器类型
+     * @param _parser 参数解析器函数
+     * @param _cleaner 参数清理函数
+     */
+    #define SHELL_EXPORT_PARAM_PARSER(_attr, _type, _parser, _cleaner) \
+            const ShellParamParserFunc shellParamParser##_parser = \
+            { \
+                (int (*)(char *, void **))_parser, \
+                (int (*)(void *))_cleaner \
+            }; \
+            extern "C" SHELL_USED const ShellCommandCppParamParser \
+            shellCommand##_parser SHELL_SECTION("shellCommand") = \
+            { \
+                _attr|SHELL_CMD_TYPE(SHELL_TYPE_PARAM_PARSER), \
+                #_type, \
+                &shellParamParser##_parser \
+            }
+#endif
+#endif /** SHELL_USING_CMD_EXPORT == 1 */
+
+#else
 /**
  * @brief shell command cpp 支持 cmd 定义
  */
@@ -27,6 +225,8 @@ typedef struct shell_command_cpp_cmd
     const char *desc;                                           /**< 命令描述 */
 #if SHELL_USING_FUNC_SIGNATURE == 1
     const char *signature;                                      /**< 函数签名 */
+#elif SHELL_KEY_TRIE_SIZE > 0
+    void *unused;                                               /**< 未使用成员，需要保持和 ShellCommandCppKey 大小一致 */
 #endif
 } ShellCommandCppCmd;
 
@@ -39,7 +239,7 @@ typedef struct shell_command_cpp_var
     const char *name;                                           /**< 变量名 */
     void *value;                                                /**< 变量值 */
     const char *desc;                                           /**< 变量描述 */
-#if SHELL_USING_FUNC_SIGNATURE == 1
+#if SHELL_USING_FUNC_SIGNATURE == 1 || SHELL_KEY_TRIE_SIZE > 0
     void *unused;                                               /**< 未使用成员，需要保持和 ShellCommandCppCmd 大小一致 */
 #endif
 } ShellCommandCppVar;
@@ -53,7 +253,7 @@ typedef struct shell_command_cpp_user
     const char *name;                                           /**< 用户名 */
     const char *password;                                       /**< 用户密码 */
     const char *desc;                                           /**< 用户描述 */
-#if SHELL_USING_FUNC_SIGNATURE == 1
+#if SHELL_USING_FUNC_SIGNATURE == 1 || SHELL_KEY_TRIE_SIZE > 0
     void *unused;                                               /**< 未使用成员，需要保持和 ShellCommandCppCmd 大小一致 */
 #endif
 } ShellCommandCppUser;
@@ -67,7 +267,9 @@ typedef struct shell_command_cpp_key
     int value;                                                  /**< 按键键值 */
     void (*function)(Shell *);                                  /**< 按键执行函数 */
     const char *desc;                                           /**< 按键描述 */
-#if SHELL_USING_FUNC_SIGNATURE == 1
+#if SHELL_KEY_TRIE_SIZE > 0
+    const char *sequence;                                       /**< 按键序列 */
+#elif SHELL_USING_FUNC_SIGNATURE == 1
     void *unused;                                               /**< 未使用成员，需要保持和 ShellCommandCppCmd 大小一致 */
 #endif
 } ShellCommandCppKey;
@@ -97,9 +299,9 @@ typedef struct shell_command_cpp_param_parser
      */
     #define SHELL_EXPORT_CMD(_attr, _name, _func, _desc, ...) \
             const char shellCmd##_name[] = #_name; \
-            const char shellDesc##_name[] = #_desc; \
+            const char shellDesc##_name[] SHELL_DESC_SECTION = #_desc; \
             extern "C" SHELL_USED const ShellCommandCppCmd \
-            shellCommand##_name SHELL_SECTION("shellCommand") =  \
+            shellCommand##_name SHELL_CMD_SECTION(_name) =  \
             { \
                 _attr, \
                 shellCmd##_name, \
@@ -119,9 +321,9 @@ typedef struct shell_command_cpp_param_parser
      */
     #define SHELL_EXPORT_VAR(_attr, _name, _value, _desc) \
             const char shellCmd##_name[] = #_name; \
-            const char shellDesc##_name[] = #_desc; \
+            const char shellDesc##_name[] SHELL_DESC_SECTION = #_desc; \
             extern "C" SHELL_USED const ShellCommandCppVar \
-            shellVar##_name SHELL_SECTION("shellCommand") =  \
+            shellVar##_name SHELL_CMD_SECTION(_name) =  \
             { \
                 _attr, \
                 shellCmd##_name, \
@@ -141,9 +343,9 @@ typedef struct shell_command_cpp_param_parser
     #define SHELL_EXPORT_USER(_attr, _name, _password, _desc) \
             const char shellCmd##_name[] = #_name; \
             const char shellPassword##_name[] = #_password; \
-            const char shellDesc##_name[] = #_desc; \
+            const char shellDesc##_name[] SHELL_DESC_SECTION = #_desc; \
             extern "C" SHELL_USED const ShellCommandCppUser \
-            shellUser##_name SHELL_SECTION("shellCommand") =  \
+            shellUser##_name SHELL_CMD_SECTION(_name) =  \
             { \
                 _attr|SHELL_CMD_TYPE(SHELL_TYPE_USER), \
                 shellCmd##_name, \
@@ -161,7 +363,7 @@ typedef struct shell_command_cpp_param_parser
      * @param _desc 按键描述
      */
     #define SHELL_EXPORT_KEY(_attr, _value, _func, _desc) \
-            const char shellDesc##_value[] = #_desc; \
+            const char shellDesc##_value[] SHELL_DESC_SECTION = #_desc; \
             extern "C" SHELL_USED const ShellCommandCppKey \
             shellKey##_value SHELL_SECTION("shellCommand") =  \
             { \
@@ -171,6 +373,31 @@ typedef struct shell_command_cpp_param_parser
                 shellDesc##_value \
             }
 
+#if SHELL_KEY_TRIE_SIZE > 0
+    #undef SHELL_EXPORT_KEY_SEQUENCE
+    /**
+     * @brief shell 按键序列定义
+     * 
+     * @param _attr 按键属性
+     * @param _name 按键名
+     * @param _sequence 按键序列(字符串)
+     * @param _func 按键函数
+     * @param _desc 按键描述
+     */
+    #define SHELL_EXPORT_KEY_SEQUENCE(_attr, _name, _sequence, _func, _desc) \
+            const char shellKeySequence##_name[] = _sequence; \
+            const char shellDesc##_name[] SHELL_DESC_SECTION = #_desc; \
+            extern "C" SHELL_USED const ShellCommandCppKey \
+            shellKey##_name SHELL_SECTION("shellCommand") =  \
+            { \
+                _attr|SHELL_CMD_TYPE(SHELL_TYPE_KEY), \
+                0, \
+                (void (*)(Shell *))_func, \
+                shellDesc##_name, \
+                shellKeySequence##_name \
+            }
+#endif /** SHELL_KEY_TRIE_SIZE > 0 */
+
 #if SHELL_USING_FUNC_SIGNATURE == 1
     #undef SHELL_EXPORT_PARAM_PARSER
     /**
@@ -193,6 +420,7 @@ typedef struct shell_command_cpp_param_parser
             }
 #endif
 #endif /** SHELL_USING_CMD_EXPORT == 1 */
+#endif /** SHELL_CMD_COMPACT == 1 */
 
 }
 #endif /**< defined __cplusplus */
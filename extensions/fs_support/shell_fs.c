@@ -51,7 +51,10 @@ void shellLS(void)
     SHELL_ASSERT(buffer, return);
     count = shellFs->listdir(shellGetPath(shell), buffer, SHELL_FS_LIST_FILE_BUFFER_MAX);
 
-    shellWriteString(shell, buffer);
+    if (!shellIsCancelled(shell))
+    {
+        shellWriteString(shell, buffer);
+    }
 
     SHELL_FREE(buffer);
 }
@@ -24,6 +24,7 @@ Shell *shell2048 = NULL;
 
 char shellGetChar(Shell *shell) {
     char data;
+    shellFlush(shell);
     if (shell->read && shell->read(&data, 1) == 1) {
         return data;
     } else {
@@ -14,6 +14,7 @@ Shell *shellPushbox = NULL;
 
 static char shellGetChar(Shell *shell) {
     char data;
+    shellFlush(shell);
     if (shell->read && shell->read(&data, 1) == 1) {
         return data;
     } else {
@@ -9,7 +9,7 @@
  * 
  */
 #include "log.h"
-#include "stdio.h"
+#include "string.h"
 #include "stdarg.h"
 #include "shell.h"
 
@@ -27,6 +27,16 @@
 Log *logList[LOG_MAX_NUMBER] = {0};
 static char logBuffer[LOG_BUFFER_SIZE];
 
+/**
+ * @brief log格式化输出状态
+ */
+typedef struct
+{
+    Log *log;                                       /**< log对象 */
+    LogLevel level;                                 /**< 日志级别 */
+    short length;                                   /**< log缓冲中的数据长度 */
+} LogFormatter;
+
 #if LOG_USING_LOCK == 1
 /**
  * @brief   上锁log对象
@@ -165,21 +175,93 @@ static void logWriteBuffer(Log *log, LogLevel level, char *buffer, short len)
                 && logList[i]->active
                 && logList[i]->level >= level)
             {
-                logList[i]->write(logBuffer, len);
+                logList[i]->write(buffer, len);
             }
         }
     }
     else if (log && log->active && log->level >= level)
     {
-        log->write(logBuffer, len);
+        log->write(buffer, len);
     }
 #if LOG_USING_LOCK == 1
     logUnlock(log);
 #endif /* LOG_USING_LOCK == 1 */
 }
 
+/**
+ * @brief 判断log是否需要输出
+ * 
+ * @param log log对象
+ * @param level 日志级别
+ * 
+ * @return char 1 需要输出 0 不需要输出
+ */
+static char logEnabled(Log *log, LogLevel level)
+{
+    if (log == LOG_ALL_OBJ)
+    {
+        for (short i = 0; i < LOG_MAX_NUMBER; i++)
+        {
+            if (logList[i] 
+                && logList[i]->active
+                && logList[i]->level >= level)
+            {
+                return 1;
+            }
+        }
+        return 0;
+    }
+    return log && log->active && log->level >= level;
+}
+
+/**
+ * @brief log格式化输出写数据
+ *        格式化结果写入log缓冲，缓冲满时输出，超过缓冲大小的log分多次输出
+ * 
+ * @param context log格式化输出状态
+ * @param data 数据
+ * @param len 数据长度
+ */
+static void logFormatWrite(void *context, const char *data, unsigned short len)
+{
+    LogFormatter *formatter = (LogFormatter *)context;
+    short count;
+
+    while (len > 0)
+    {
+        count = LOG_BUFFER_SIZE - formatter->length;
+        count = count > len ? len : count;
+        memcpy(logBuffer + formatter->length, data, count);
+        formatter->length += count;
+        data += count;
+        len -= count;
+        if (formatter->length == LOG_BUFFER_SIZE)
+        {
+            logWriteBuffer(formatter->log, formatter->level, logBuffer, formatter->length);
+            formatter->length = 0;
+        }
+    }
+}
+
+/**
+ * @brief log格式化写入log缓冲(调用者持有log锁)
+ * 
+ * @param formatter log格式化输出状态
+ * @param fmt 格式
+ * @param ... 参数
+ */
+static void logFormatBuffer(LogFormatter *formatter, const char *fmt, ...)
+{
+    va_list vargs;
+
+    va_start(vargs, fmt);
+    shellFormat(logFormatWrite, formatter, fmt, vargs);
+    va_end(vargs);
+}
+
 /**
  * @brief log格式化写入数据
+ *        log级别不需要输出时不进行格式化
  * 
  * @param log log对象
  * @param level log级别
@@ -189,21 +271,23 @@ static void logWriteBuffer(Log *log, LogLevel level, char *buffer, short len)
 void logWrite(Log *log, LogLevel level, const char *fmt, ...)
 {
     va_list vargs;
-    int len;
-    
+    LogFormatter formatter = {log, level, 0};
+
+    if (!logEnabled(log, level))
+    {
+        return;
+    }
 #if LOG_USING_LOCK == 1
     logLock(log);
 #endif /* LOG_USING_LOCK == 1 */
     va_start(vargs, fmt);
-    len = vsnprintf(logBuffer, LOG_BUFFER_SIZE - 1, fmt, vargs);
+    shellFormat(logFormatWrite, &formatter, fmt, vargs);
     va_end(vargs);
 
-    if (len > LOG_BUFFER_SIZE)
+    if (formatter.length > 0)
     {
-        len = LOG_BUFFER_SIZE;
+        logWriteBuffer(log, level, logBuffer, formatter.length);
     }
-
-    logWriteBuffer(log, level, logBuffer, len);
 #if LOG_USING_LOCK == 1
     logUnlock(log);
 #endif /* LOG_USING_LOCK == 1 */
@@ -221,7 +305,8 @@ void logHexDump(Log *log, LogLevel level, void *base, unsigned int length)
 {
     unsigned char *address;
     unsigned int len;
-    unsigned int printLen = 0;
+    LogFormatter formatter = {log, level, 0};
+    Shell *shell = shellGetCurrent();
 
     if (length == 0 || (log != LOG_ALL_OBJ && log->level < level))
     {
@@ -230,9 +315,10 @@ void logHexDump(Log *log, LogLevel level, void *base, unsigned int length)
 #if LOG_USING_LOCK == 1
     logLock(log);
 #endif /* LOG_USING_LOCK == 1 */
-    len = snprintf(logBuffer, LOG_BUFFER_SIZE - 1, "memory of 0x%08x, size: %d:\r\n%s",
-                   (unsigned int)base, length, memPrintHead);
-    logWriteBuffer(log, level, logBuffer, len);
+    logFormatBuffer(&formatter, "memory of 0x%08x, size: %d:\r\n%s",
+                    (unsigned int)base, length, memPrintHead);
+    logWriteBuffer(log, level, logBuffer, formatter.length);
+    formatter.length = 0;
 
     len = length;
     
@@ -242,50 +328,54 @@ void logHexDump(Log *log, LogLevel level, void *base, unsigned int length)
 
     while (length)
     {
-        printLen += sprintf(logBuffer + printLen, memPrintAddr, (unsigned int)address);
+        if (shell && shellIsCancelled(shell))
+        {
+            break;
+        }
+        logFormatBuffer(&formatter, memPrintAddr, (unsigned int)address);
         for (int i = 0; i < 16; i++)
         {
             if ((unsigned int)(address + i) < (unsigned int)base
                 || (unsigned int)(address + i) >= (unsigned int)base + len)
             {
-                logBuffer[printLen ++] = ' ';
-                logBuffer[printLen ++] = ' ';
-                logBuffer[printLen ++] = ' ';
+                logBuffer[formatter.length ++] = ' ';
+                logBuffer[formatter.length ++] = ' ';
+                logBuffer[formatter.length ++] = ' ';
             }
             else
             {
-                printLen += sprintf(logBuffer + printLen, "%02x ", *(address + i));
+                logFormatBuffer(&formatter, "%02x ", *(address + i));
             }
         }
-        logBuffer[printLen ++] = '|';
-        logBuffer[printLen ++] = ' ';
+        logBuffer[formatter.length ++] = '|';
+        logBuffer[formatter.length ++] = ' ';
         for (int i = 0; i < 16; i++)
         {
             if ((unsigned int)(address + i) < (unsigned int)base
                 || (unsigned int)(address + i) >= (unsigned int)base + len)
             {
-                logBuffer[printLen ++] = ' ';
+                logBuffer[formatter.length ++] = ' ';
             }
             else
             {
                 if (*(address + i) >= 32 && *(address + i) <= 126)
                 {
-                    printLen += sprintf(logBuffer + printLen, "%c", *(address + i));
+                    logBuffer[formatter.length ++] = *(address + i);
                 }
                 else
                 {
-                    logBuffer[printLen ++] = '.';
+                    logBuffer[formatter.length ++] = '.';
                 }
             }
         }
-        logBuffer[printLen ++] = ' ';
-        logBuffer[printLen ++] = '|';
-        logBuffer[printLen ++] = '\r';
-        logBuffer[printLen ++] = '\n';
-        logWriteBuffer(log, level, logBuffer, printLen);
+        logBuffer[formatter.length ++] = ' ';
+        logBuffer[formatter.length ++] = '|';
+        logBuffer[formatter.length ++] = '\r';
+        logBuffer[formatter.length ++] = '\n';
+        logWriteBuffer(log, level, logBuffer, formatter.length);
         address += 16;
         length -= 16;
-        printLen = 0;
+        formatter.length = 0;
     }
 #if LOG_USING_LOCK == 1
     logUnlock(log);
@@ -22,7 +22,7 @@ extern "C" {
 #define     SHELL_COMPANION_ID_LOG          -2
 
 #define     LOG_USING_LOCK     0
-#define     LOG_BUFFER_SIZE    256              /**< log输出缓冲大小 */
+#define     LOG_BUFFER_SIZE    256              /**< log输出缓冲大小，超出的log分多次输出 */
 #define     LOG_USING_COLOR    1                /**< 是否使用颜色 */
 #define     LOG_MAX_NUMBER     5                /**< 允许注册的最大log对象数量 */
 #define     LOG_AUTO_TAG       1                /**< 是否自动添加TAG */
@@ -73,9 +73,13 @@ static void shellCmdGroupHelp(Shell *shell, char *name, ShellCommand *group)
     {
         shellWriteString(shell, item->data.cmd.name);
         shellWriteString(shell, ": ");
+#if SHELL_CMD_COMPACT == 1
+        shellWriteString(shell, item->data.cmd.name + strlen(item->data.cmd.name) + 1);
+#else
         if (item->data.cmd.desc) {
             shellWriteString(shell, item->data.cmd.desc);
         }
+#endif
         shellWriteString(shell, "\r\n\r\n");
         item++;
     }
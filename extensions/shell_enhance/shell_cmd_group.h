@@ -45,6 +45,15 @@
  * @param _desc 命令描述
  * @param ... 其他参数
  */
+#if SHELL_CMD_COMPACT == 1
+#define SHELL_CMD_GROUP_ITEM(_type, _name, _func, _desc, ...) \
+        { \
+            .attr.value = SHELL_CMD_PERMISSION(0)|SHELL_CMD_TYPE(_type), \
+            .data.cmd.name = #_name "\0" #_desc "\0", \
+            .data.cmd.function = (int (*)())_func, \
+            ##__VA_ARGS__ \
+        }
+#else
 #define SHELL_CMD_GROUP_ITEM(_type, _name, _func, _desc, ...) \
         { \
             .attr.value = SHELL_CMD_PERMISSION(0)|SHELL_CMD_TYPE(_type), \
@@ -53,6 +62,7 @@
             .data.cmd.desc = #_desc, \
             ##__VA_ARGS__ \
         }
+#endif /** SHELL_CMD_COMPACT == 1 */
 
 #if SHELL_USING_FUNC_SIGNATURE == 1
     /**
@@ -63,6 +73,14 @@
     * @param _desc 命令描述
     * @param _sign 命令签名
     */
+    #if SHELL_CMD_COMPACT == 1
+    #define SHELL_CMD_GROUP_ITEM_SIGN(_type, _name, _func, _desc, _sign) \
+            { \
+            .attr.value = SHELL_CMD_PERMISSION(0)|SHELL_CMD_TYPE(_type)|SHELL_CMD_DISABLE_RETURN, \
+            .data.cmd.name = #_name "\0" #_desc "\0" #_sign, \
+            .data.cmd.function = (int (*)())_func, \
+            }
+    #else
     #define SHELL_CMD_GROUP_ITEM_SIGN(_type, _name, _func, _desc, _sign) \
             { \
             .attr.value = SHELL_CMD_PERMISSION(0)|SHELL_CMD_TYPE(_type)|SHELL_CMD_DISABLE_RETURN, \
@@ -71,6 +89,7 @@
             .data.cmd.desc = #_desc, \
             .data.cmd.signature = #_sign, \
             }
+    #endif /** SHELL_CMD_COMPACT == 1 */
 #endif
 
 /**
@@ -0,0 +1,516 @@
+/**
+ * @file shell_jobs.c
+ * @author Letter(nevermindzzt@gmail.com)
+ * @brief shell background jobs
+ * @version 0.1
+ * @date 2026-10-17
+ * 
+ * @copyright (c) 2026 Letter
+ * 
+ */
+#include "shell_jobs.h"
+#include "string.h"
+#include "stdio.h"
+#include "stdlib.h"
+
+#if SHELL_USING_COMPANION != 1
+#error shell jobs can not be used while shell companion is disabled
+#endif
+
+#if SHELL_USING_JOBS != 1
+#error shell jobs can not be used while SHELL_USING_JOBS is disabled
+#endif
+
+#if SHELL_SUPPORT_END_LINE != 1
+#error shell jobs can not be used while shell end line is disabled
+#endif
+
+unsigned int shellRunCommand(Shell *shell, ShellCommand *command);
+
+static int shellJobsRun(Shell *shell, ShellCommand *command);
+
+
+/**
+ * @brief 后台任务初始化
+ *        初始化后，shell中以`&`结尾的命令会在新线程中执行
+ * 
+ * @param jobs 后台任务表
+ * @param shell shell对象
+ * @param newThread 新线程接口
+ * 
+ * @return int 0 初始化成功 -1 初始化失败
+ */
+int shellJobsInit(ShellJobs *jobs, Shell *shell, ShellJobsNewThread newThread)
+{
+    SHELL_ASSERT(jobs && shell && newThread, return -1);
+
+    memset(jobs, 0, sizeof(ShellJobs));
+    jobs->shell = shell;
+    jobs->newThread = newThread;
+    pthread_mutex_init(&jobs->mutex, NULL);
+    pthread_cond_init(&jobs->cond, NULL);
+    for (short i = 0; i < SHELL_JOBS_MAX_NUMBER; i++)
+    {
+        jobs->job[i].jobs = jobs;
+    }
+    if (shellCompanionAdd(shell, SHELL_COMPANION_ID_JOBS, jobs) != 0)
+    {
+        return -1;
+    }
+    shell->background = shellJobsRun;
+    return 0;
+}
+
+
+/**
+ * @brief 获取后台任务的命令行
+ * 
+ * @param job 后台任务
+ * @param buffer 缓冲
+ * @param size 缓冲大小
+ * 
+ * @return unsigned short 命令行长度
+ */
+static unsigned short shellJobsLine(ShellJob *job, char *buffer, unsigned short size)
+{
+    unsigned short length = 0;
+
+    buffer[0] = 0;
+    for (short i = 0; i < job->shell.parser.paramCount; i++)
+    {
+        length += snprintf(buffer + length, size - length, i == 0 ? "%s" : " %s",
+                           job->shell.parser.param[i]);
+        if (length >= size)
+        {
+            return size - 1;
+        }
+    }
+    return length;
+}
+
+
+/**
+ * @brief 后台任务结束
+ *        释放任务并通过尾行输出任务结束通知
+ * 
+ * @param job 后台任务
+ * @param state 结束状态
+ */
+static void shellJobsFinish(ShellJob *job, const char *state)
+{
+    ShellJobs *jobs = job->jobs;
+    char text[SHELL_JOBS_BUFFER_SIZE + 24];
+    unsigned short length;
+
+    shellFlush(&job->shell);
+    shellRemove(&job->shell);
+    length = snprintf(text, sizeof(text), "[%d] %s\t", job->id, state);
+    length += shellJobsLine(job, text + length, sizeof(text) - length - 2);
+    text[length++] = '\r';
+    text[length++] = '\n';
+
+    pthread_mutex_lock(&jobs->mutex);
+    job->state = SHELL_JOB_FREE;
+    pthread_cond_broadcast(&jobs->cond);
+    pthread_mutex_unlock(&jobs->mutex);
+
+    shellWriteEndLine(jobs->shell, text, length);
+}
+
+
+/**
+ * @brief 后台任务被终止
+ *        `pthread_cancel`只会在任务线程没有持有输出锁时生效，此时可以正常输出
+ * 
+ * @param param 后台任务
+ */
+static void shellJobsKilled(void *param)
+{
+    shellJobsFinish((ShellJob *)param, "Killed");
+}
+
+
+/**
+ * @brief 后台任务线程
+ * 
+ * @param param 后台任务
+ * 
+ * @return void* NULL
+ */
+static void *shellJobsEntry(void *param)
+{
+    ShellJob *job = (ShellJob *)param;
+    ShellJobs *jobs = job->jobs;
+
+    pthread_detach(pthread_self());
+    pthread_mutex_lock(&jobs->mutex);
+    job->thread = pthread_self();
+    job->state = SHELL_JOB_RUNNING;
+    pthread_mutex_unlock(&jobs->mutex);
+
+    pthread_cleanup_push(shellJobsKilled, job);
+#if SHELL_USING_CANCEL == 1
+    if (!job->shell.info.cancelled)
+#endif
+    {
+        shellRunCommand(&job->shell, job->command);
+    }
+    pthread_cleanup_pop(0);
+#if SHELL_USING_CANCEL == 1
+    shellJobsFinish(job, job->shell.info.cancelled ? "Killed" : "Done");
+#else
+    shellJobsFinish(job, "Done");
+#endif
+    return NULL;
+}
+
+
+#if SHELL_USING_LOCK == 1
+/**
+ * @brief 后台任务输出锁加锁
+ *        使用前台shell的输出锁，持有输出锁期间禁止线程取消，避免`kill -9`时线程在持有锁的情况下退出
+ * 
+ * @param shell 后台任务使用的shell对象
+ * 
+ * @return int 0
+ */
+static int shellJobsWriteLock(Shell *shell)
+{
+    ShellJob *job = (ShellJob *)shell;
+    int cancelState;
+
+    pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, &cancelState);
+    SHELL_WRITE_LOCK(job->jobs->shell);
+    if (job->lockDepth++ == 0)
+    {
+        job->cancelState = cancelState;
+    }
+    return 0;
+}
+
+
+/**
+ * @brief 后台任务输出锁解锁
+ * 
+ * @param shell 后台任务使用的shell对象
+ * 
+ * @return int 0
+ */
+static int shellJobsWriteUnlock(Shell *shell)
+{
+    ShellJob *job = (ShellJob *)shell;
+
+    SHELL_WRITE_UNLOCK(job->jobs->shell);
+    if (--job->lockDepth == 0)
+    {
+        pthread_setcancelstate(job->cancelState, NULL);
+    }
+    return 0;
+}
+#endif /** SHELL_USING_LOCK == 1 */
+
+
+/**
+ * @brief 建立后台任务使用的shell对象
+ *        只继承前台shell的用户，路径，伴生对象，命令表和输出接口，
+ *        不使用前台shell的输入，历史记录和编辑锁
+ * 
+ * @param job 后台任务
+ * @param shell 前台shell对象
+ * @param size 命令行长度
+ * 
+ * @return int 0 成功 -1 参数内存池不足
+ */
+static int shellJobsProxy(ShellJob *job, Shell *shell, unsigned short size)
+{
+    Shell *proxy = &job->shell;
+
+    memset(proxy, 0, sizeof(Shell));
+    proxy->info.user = shell->info.user;
+    proxy->info.path = shell->info.path;
+    proxy->info.companions = shell->info.companions;
+#if SHELL_CMD_VIEW_NUMBER > 0
+    proxy->info.view = SHELL_CMD_VIEW_NUMBER;
+#endif
+    memcpy(job->buffer, shell->parser.buffer, size);
+    proxy->parser.buffer = job->buffer;
+    proxy->parser.bufferSize = SHELL_JOBS_BUFFER_SIZE;
+    proxy->parser.paramCount = shell->parser.paramCount;
+#if SHELL_ARENA_SIZE > 0
+    proxy->parser.param = shellArenaAlloc(proxy,
+        (shell->parser.paramCount + 1) * sizeof(char *));
+    if (proxy->parser.param == NULL)
+    {
+        return -1;
+    }
+#endif
+    for (short i = 0; i < shell->parser.paramCount; i++)
+    {
+        proxy->parser.param[i] = job->buffer
+            + (shell->parser.param[i] - shell->parser.buffer);
+    }
+#if SHELL_ARENA_SIZE > 0
+    proxy->parser.param[shell->parser.paramCount] = NULL;
+#endif
+    proxy->commandList.base = shell->commandList.base;
+    proxy->commandList.count = shell->commandList.count;
+#if SHELL_CMD_SORTED_SECTION == 1
+    proxy->commandList.sorted = shell->commandList.sorted;
+#endif
+    proxy->status.isChecked = shell->status.isChecked;
+    proxy->write = shell->write;
+#if SHELL_USING_LOCK == 1
+    proxy->writeLock = shellJobsWriteLock;
+    proxy->writeUnlock = shellJobsWriteUnlock;
+#endif
+#if SHELL_USING_TX == 1
+    proxy->tx = shell->tx;
+#endif
+    return 0;
+}
+
+
+/**
+ * @brief 后台执行命令
+ *        复制当前解析的命令参数到空闲任务，在新线程中执行
+ * 
+ * @param shell shell对象
+ * @param command 命令
+ * 
+ * @return int 0 启动成功 -1 启动失败
+ */
+static int shellJobsRun(Shell *shell, ShellCommand *command)
+{
+    ShellJobs *jobs = shellCompanionGet(shell, SHELL_COMPANION_ID_JOBS);
+    ShellJob *job = NULL;
+    char *last;
+    unsigned short size;
+
+    SHELL_ASSERT(jobs, return -1);
+
+    last = shell->parser.param[shell->parser.paramCount - 1];
+    size = last + strlen(last) + 1 - shell->parser.buffer;
+    if (size > SHELL_JOBS_BUFFER_SIZE)
+    {
+        shellWriteString(shell, "command too long for background job\r\n");
+        return -1;
+    }
+
+    pthread_mutex_lock(&jobs->mutex);
+    for (short i = 0; i < SHELL_JOBS_MAX_NUMBER; i++)
+    {
+        if (jobs->job[i].state == SHELL_JOB_FREE)
+        {
+            job = &jobs->job[i];
+            job->state = SHELL_JOB_STARTING;
+            if (++jobs->lastId == 0)
+            {
+                jobs->lastId = 1;
+            }
+            job->id = jobs->lastId;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&jobs->mutex);
+    if (!job)
+    {
+        shellWriteString(shell, "no free background job\r\n");
+        return -1;
+    }
+
+    if (shellJobsProxy(job, shell, size) != 0)
+    {
+        pthread_mutex_lock(&jobs->mutex);
+        job->state = SHELL_JOB_FREE;
+        pthread_mutex_unlock(&jobs->mutex);
+        shellWriteString(shell, "too many parameters for background job\r\n");
+        return -1;
+    }
+    job->command = command;
+
+    if (shellAdd(&job->shell) != 0)
+    {
+        pthread_mutex_lock(&jobs->mutex);
+        job->state = SHELL_JOB_FREE;
+        pthread_mutex_unlock(&jobs->mutex);
+        shellWriteString(shell, "no free shell for background job, increase SHELL_MAX_NUMBER\r\n");
+        return -1;
+    }
+    if (jobs->newThread(shellJobsEntry, job) != 0)
+    {
+        shellRemove(&job->shell);
+        pthread_mutex_lock(&jobs->mutex);
+        job->state = SHELL_JOB_FREE;
+        pthread_mutex_unlock(&jobs->mutex);
+        shellWriteString(shell, "start background job failed\r\n");
+        return -1;
+    }
+    shellPrint(shell, "[%d]\r\n", job->id);
+    return 0;
+}
+
+
+/**
+ * @brief 查找后台任务
+ * 
+ * @param jobs 后台任务表
+ * @param id 任务ID，为0时查找最近启动的任务
+ * 
+ * @return ShellJob* 后台任务，没有匹配的任务时返回NULL
+ */
+static ShellJob *shellJobsFind(ShellJobs *jobs, unsigned short id)
+{
+    ShellJob *job = NULL;
+
+    for (short i = 0; i < SHELL_JOBS_MAX_NUMBER; i++)
+    {
+        if (jobs->job[i].state == SHELL_JOB_FREE)
+        {
+            continue;
+        }
+        if (jobs->job[i].id == id)
+        {
+            return &jobs->job[i];
+        }
+        if (id == 0 && (!job || (unsigned short)(jobs->job[i].id - job->id) < 0x8000))
+        {
+            job = &jobs->job[i];
+        }
+    }
+    return job;
+}
+
+
+/**
+ * @brief 列出后台任务
+ * 
+ * @return int 0
+ */
+static int shellJobsList(void)
+{
+    ShellJobs *jobs = shellCompanionGet(shellGetCurrent(), SHELL_COMPANION_ID_JOBS);
+    char line[SHELL_JOBS_BUFFER_SIZE];
+    int cancelState;
+
+    SHELL_ASSERT(jobs, return -1);
+    pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, &cancelState);
+    pthread_mutex_lock(&jobs->mutex);
+    for (short i = 0; i < SHELL_JOBS_MAX_NUMBER; i++)
+    {
+        if (jobs->job[i].state != SHELL_JOB_FREE)
+        {
+            shellJobsLine(&jobs->job[i], line, sizeof(line));
+            shellPrint(jobs->shell, "[%d] Running\t%s\r\n", jobs->job[i].id, line);
+        }
+    }
+    pthread_mutex_unlock(&jobs->mutex);
+    pthread_setcancelstate(cancelState, NULL);
+    return 0;
+}
+SHELL_EXPORT_CMD(
+SHELL_CMD_PERMISSION(0)|SHELL_CMD_TYPE(SHELL_TYPE_CMD_MAIN)|SHELL_CMD_DISABLE_RETURN,
+jobs, shellJobsList, list background jobs);
+
+
+/**
+ * @brief 等待后台任务结束
+ * 
+ * @param argc 参数数量
+ * @param argv 参数 `fg [id]`，不指定id时等待最近启动的任务
+ * 
+ * @return int 0 任务已结束 -1 没有匹配的任务
+ */
+static int shellJobsForeground(int argc, char *argv[])
+{
+    Shell *shell = shellGetCurrent();
+    ShellJobs *jobs = shellCompanionGet(shell, SHELL_COMPANION_ID_JOBS);
+    ShellJob *job;
+    unsigned short id;
+    int cancelState;
+
+    SHELL_ASSERT(jobs, return -1);
+    pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, &cancelState);
+    pthread_mutex_lock(&jobs->mutex);
+    job = shellJobsFind(jobs, argc > 1 ? atoi(argv[1]) : 0);
+    if (!job)
+    {
+        pthread_mutex_unlock(&jobs->mutex);
+        pthread_setcancelstate(cancelState, NULL);
+        shellWriteString(shell, "no such job\r\n");
+        return -1;
+    }
+    id = job->id;
+    shellFlush(shell);
+    while (job->state != SHELL_JOB_FREE && job->id == id)
+    {
+        pthread_cond_wait(&jobs->cond, &jobs->mutex);
+    }
+    pthread_mutex_unlock(&jobs->mutex);
+    pthread_setcancelstate(cancelState, NULL);
+    return 0;
+}
+SHELL_EXPORT_CMD(
+SHELL_CMD_PERMISSION(0)|SHELL_CMD_TYPE(SHELL_TYPE_CMD_MAIN)|SHELL_CMD_DISABLE_RETURN,
+fg, shellJobsForeground, wait background job);
+
+
+/**
+ * @brief 终止后台任务
+ *        使能`SHELL_USING_CANCEL`时，默认设置任务的取消标志，由命令自行结束，
+ *        使用`kill -9 id`时，使用`pthread_cancel`终止任务线程，
+ *        任务线程还没有开始执行命令时，只设置取消标志，命令不会被执行
+ * 
+ * @param argc 参数数量
+ * @param argv 参数 `kill [-9] id`
+ * 
+ * @return int 0 已发送终止请求 -1 没有匹配的任务
+ */
+static int shellJobsKill(int argc, char *argv[])
+{
+    Shell *shell = shellGetCurrent();
+    ShellJobs *jobs = shellCompanionGet(shell, SHELL_COMPANION_ID_JOBS);
+    ShellJob *job;
+    char force = 0;
+    unsigned short id;
+    int ret = -1;
+
+    SHELL_ASSERT(jobs, return -1);
+    if (argc > 2 && strcmp(argv[1], "-9") == 0)
+    {
+        force = 1;
+        argv++;
+        argc--;
+    }
+    if (argc < 2)
+    {
+        shellWriteString(shell, "usage: kill [-9] id\r\n");
+        return -1;
+    }
+    id = atoi(argv[1]);
+    pthread_mutex_lock(&jobs->mutex);
+    job = shellJobsFind(jobs, id);
+    if (job && job->id == id)
+    {
+    #if SHELL_USING_CANCEL == 1
+        if (!force || job->state == SHELL_JOB_STARTING)
+        {
+            shellCancel(&job->shell);
+            ret = 0;
+        }
+        else
+    #endif
+        if (job->state == SHELL_JOB_RUNNING)
+        {
+            ret = pthread_cancel(job->thread) == 0 ? 0 : -1;
+        }
+    }
+    pthread_mutex_unlock(&jobs->mutex);
+    if (ret != 0)
+    {
+        shellWriteString(shell, "no such job\r\n");
+    }
+    return ret;
+}
+SHELL_EXPORT_CMD(
+SHELL_CMD_PERMISSION(0)|SHELL_CMD_TYPE(SHELL_TYPE_CMD_MAIN)|SHELL_CMD_DISABLE_RETURN,
+kill, shellJobsKill, kill background job);
@@ -0,0 +1,83 @@
+/**
+ * @file shell_jobs.h
+ * @author Letter(nevermindzzt@gmail.com)
+ * @brief shell background jobs
+ * @version 0.1
+ * @date 2026-10-17
+ * 
+ * @copyright (c) 2026 Letter
+ * 
+ */
+#ifndef __SHELL_JOBS_H__
+#define __SHELL_JOBS_H__
+
+#include "shell.h"
+#include "pthread.h"
+
+/**
+ * @brief 后台任务 shell伴生对象ID
+ */
+#define     SHELL_COMPANION_ID_JOBS         -4
+
+/**
+ * @brief 每个shell最大后台任务数量
+ */
+#define     SHELL_JOBS_MAX_NUMBER           4
+
+/**
+ * @brief 后台任务命令行缓冲大小
+ */
+#define     SHELL_JOBS_BUFFER_SIZE          128
+
+/**
+ * @brief 新线程接口，和telnetd的`NewThread`相同
+ * 
+ * @param void * 线程执行函数
+ * @param void * 线程参数
+ * 
+ * @reutrn int 0 启动线程成功 -1 启动线程失败
+ */
+typedef int (*ShellJobsNewThread)(void *, void *);
+
+/**
+ * @brief 后台任务状态
+ */
+typedef enum
+{
+    SHELL_JOB_FREE = 0,                                 /**< 空闲 */
+    SHELL_JOB_STARTING,                                 /**< 等待线程启动 */
+    SHELL_JOB_RUNNING,                                  /**< 运行中 */
+} ShellJobState;
+
+/**
+ * @brief 后台任务
+ */
+typedef struct
+{
+    Shell shell;                                        /**< 任务使用的shell对象 */
+    ShellCommand *command;                              /**< 任务执行的命令 */
+    struct shell_jobs_def *jobs;                        /**< 所属任务表 */
+    pthread_t thread;                                   /**< 任务线程 */
+    unsigned short id;                                  /**< 任务ID */
+    unsigned char state;                                /**< 任务状态 */
+    int cancelState;                                    /**< 持有输出锁之前的线程取消状态 */
+    unsigned char lockDepth;                            /**< 输出锁嵌套深度 */
+    char buffer[SHELL_JOBS_BUFFER_SIZE];                /**< 命令行 */
+} ShellJob;
+
+/**
+ * @brief 后台任务表
+ */
+typedef struct shell_jobs_def
+{
+    Shell *shell;                                       /**< 前台shell对象 */
+    ShellJobsNewThread newThread;                       /**< 新线程接口 */
+    pthread_mutex_t mutex;                              /**< 任务表锁 */
+    pthread_cond_t cond;                                /**< 任务结束通知 */
+    unsigned short lastId;                              /**< 最近分配的任务ID */
+    ShellJob job[SHELL_JOBS_MAX_NUMBER];                /**< 任务 */
+} ShellJobs;
+
+int shellJobsInit(ShellJobs *jobs, Shell *shell, ShellJobsNewThread newThread);
+
+#endif
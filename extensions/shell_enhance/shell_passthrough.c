@@ -36,6 +36,7 @@ unsigned int shellPassthrough(Shell *shell, const char *prompt, ShellPassthrough
         shellWriteString(shell, prompt);
         while (1)
         {
+            shellFlush(shell);
             if (shell->read && shell->read(&data, 1) == 1)
             {
                 if (data == '\r' || data == '\n')
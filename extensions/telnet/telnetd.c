@@ -10,6 +10,7 @@
  */
 #include "telnetd.h"
 
+#include "string.h"
 #include "sys/socket.h"
 #include "arpa/inet.h"
 #include "netinet/in.h"
@@ -142,9 +143,10 @@ static void telnetdServer(void)
 static void telnetdConnection(int client)
 {
     int len = 0;
-    char *data = SHELL_MALLOC(16);
+    char *data = SHELL_MALLOC(TELNETD_RECV_BUFFER_SIZE);
     char *shellBuffer = SHELL_MALLOC(TELNETD_SHELL_BUFFER_SIZE);
     telnetdShell = SHELL_MALLOC(sizeof(Shell));
+    memset(telnetdShell, 0, sizeof(Shell));
 
     /** 处理 telent 协议 */
     send(client, telnetCmd, 9, 0);
@@ -161,15 +163,12 @@ static void telnetdConnection(int client)
 
     while (1)
     {
-        len = recv(client, data, 1, 0);
-        if (len == 0)
+        len = recv(client, data, TELNETD_RECV_BUFFER_SIZE, 0);
+        if (len <= 0)
         {
             break;
         }
-        else if (len == 1)
-        {
-            shellHandler(telnetdShell, data[0]);
-        }
+        shellHandlerBlock(telnetdShell, data, len);
     }
     shellDeInit(telnetdShell);
     SHELL_FREE(data);
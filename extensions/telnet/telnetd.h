@@ -36,6 +36,11 @@
  */
 #define TELNETD_SHELL_BUFFER_SIZE   512
 
+/**
+ * @brief telnet 每次接收数据的缓冲区大小
+ */
+#define TELNETD_RECV_BUFFER_SIZE    64
+
 /**
  * @brief telnet shell的用户名，使用默认shell用户设置为NULL即可
  */
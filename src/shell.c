@@ -13,6 +13,7 @@
 #include "string.h"
 #include "stdio.h"
 #include "stdarg.h"
+#include "float.h"
 #include "shell_ext.h"
 
 
@@ -20,28 +21,53 @@
 /**
  * @brief 默认用户
  */
+#if SHELL_CMD_COMPACT == 0
 const char shellCmdDefaultUser[] = SHELL_DEFAULT_USER;
 const char shellPasswordDefaultUser[] = SHELL_DEFAULT_USER_PASSWORD;
-const char shellDesDefaultUser[] = "default user";
+const char shellDesDefaultUser[] SHELL_DESC_SECTION = "default user";
+#endif
+#if SHELL_CMD_SORTED_SECTION == 1
+SHELL_USED const ShellCommand shellUserDefault SHELL_SECTION("shellCommand." SHELL_DEFAULT_USER) =
+#else
 SHELL_USED const ShellCommand shellUserDefault SHELL_SECTION("shellCommand") =
+#endif
 {
     .attr.value = SHELL_CMD_PERMISSION(0)|SHELL_CMD_TYPE(SHELL_TYPE_USER),
+#if SHELL_CMD_COMPACT == 1
+    .data.user.name = SHELL_DEFAULT_USER "\0" "default user",
+    .data.user.password = SHELL_DEFAULT_USER_PASSWORD
+#else
     .data.user.name = shellCmdDefaultUser,
     .data.user.password = shellPasswordDefaultUser,
     .data.user.desc = shellDesDefaultUser
+#endif
 };
 #endif
 
 #if SHELL_USING_CMD_EXPORT == 1
     #if defined(__CC_ARM) || (defined(__ARMCC_VERSION) && __ARMCC_VERSION >= 6000000)
+        #if SHELL_CMD_SORTED_SECTION == 1
+        extern const unsigned int Image$$SHELL_COMMAND$$Base;
+        extern const unsigned int Image$$SHELL_COMMAND$$Limit;
+        #else
         extern const unsigned int shellCommand$$Base;
         extern const unsigned int shellCommand$$Limit;
+        #endif
     #elif defined(__ICCARM__) || defined(__ICCRX__)
         #pragma section="shellCommand"
     #elif defined(__GNUC__)
         extern const unsigned int _shell_command_start;
         extern const unsigned int _shell_command_end;
     #endif
+    #if SHELL_DESC_STRIP == 1
+        #if defined(__CC_ARM) || (defined(__ARMCC_VERSION) && __ARMCC_VERSION >= 6000000)
+        extern const char shellDesc$$Base;
+        #elif defined(__ICCARM__) || defined(__ICCRX__)
+        #pragma section="shellDesc"
+        #elif defined(__GNUC__)
+        extern const char __start_shellDesc;
+        #endif
+    #endif
 #else
     extern const ShellCommand shellCommandList[];
     extern const unsigned short shellCommandCount;
@@ -76,9 +102,26 @@ enum
     SHELL_TEXT_TYPE_USER,                               /**< 用户类型 */
     SHELL_TEXT_TYPE_KEY,                                /**< 按键类型 */
     SHELL_TEXT_TYPE_NONE,                               /**< 非法类型 */
+    SHELL_TEXT_SHELL_LIST_FULL,                         /**< shell列表已满 */
+#if SHELL_ARENA_SIZE > 0
+    SHELL_TEXT_PARAM_TOO_MANY,                          /**< 参数过多 */
+#endif
 #if SHELL_EXEC_UNDEF_FUNC == 1
     SHELL_TEXT_PARAM_ERROR,                             /**< 参数错误 */
 #endif
+#if SHELL_CMD_SORTED_SECTION == 1
+    SHELL_TEXT_CMD_NOT_SORTED,                          /**< 命令表未排序 */
+#endif
+#if SHELL_USING_CANCEL == 1
+    SHELL_TEXT_CMD_CANCELLED,                           /**< 命令被取消 */
+#endif
+#if SHELL_HISTORY_SEARCH_LENGTH > 0
+    SHELL_TEXT_HISTORY_SEARCH,                          /**< 历史记录搜索 */
+    SHELL_TEXT_HISTORY_SEARCH_FAILED,                   /**< 历史记录搜索失败 */
+#endif
+#if SHELL_USING_JOBS == 1
+    SHELL_TEXT_BACKGROUND_FAILED,                       /**< 命令不能后台执行 */
+#endif
 };
 
 
@@ -137,10 +180,34 @@ static const char *shellText[] =
         "KEY ",
     [SHELL_TEXT_TYPE_NONE] = 
         "NONE",
+    [SHELL_TEXT_SHELL_LIST_FULL] =
+        "\r\nWarning: shell list is full, increase SHELL_MAX_NUMBER\r\n",
+#if SHELL_ARENA_SIZE > 0
+    [SHELL_TEXT_PARAM_TOO_MANY] =
+        "\r\nToo many parameters\r\n",
+#endif
 #if SHELL_EXEC_UNDEF_FUNC == 1
     [SHELL_TEXT_PARAM_ERROR] = 
         "Parameter error\r\n",
 #endif
+#if SHELL_CMD_SORTED_SECTION == 1
+    [SHELL_TEXT_CMD_NOT_SORTED] =
+        "\r\nWarning: command table is not sorted or has duplicate names\r\n",
+#endif
+#if SHELL_USING_CANCEL == 1
+    [SHELL_TEXT_CMD_CANCELLED] =
+        "Command cancelled\r\n",
+#endif
+#if SHELL_HISTORY_SEARCH_LENGTH > 0
+    [SHELL_TEXT_HISTORY_SEARCH] =
+        "(reverse-i-search)`",
+    [SHELL_TEXT_HISTORY_SEARCH_FAILED] =
+        "(failed reverse-i-search)`",
+#endif
+#if SHELL_USING_JOBS == 1
+    [SHELL_TEXT_BACKGROUND_FAILED] =
+        "Command can not run in background\r\n",
+#endif
 };
 
 
@@ -162,8 +229,158 @@ unsigned char pairedChars[][2] = {
  */
 static Shell *shellList[SHELL_MAX_NUMBER] = {NULL};
 
+#if SHELL_SUBMIT_QUEUE_SIZE > 0 \
+    && (SHELL_SUBMIT_QUEUE_SIZE & (SHELL_SUBMIT_QUEUE_SIZE - 1)) != 0
+    #error SHELL_SUBMIT_QUEUE_SIZE must be a power of 2
+#endif
+
+#if SHELL_FEED_BUFFER_SIZE > 0 \
+    && (SHELL_FEED_BUFFER_SIZE & (SHELL_FEED_BUFFER_SIZE - 1)) != 0
+    #error SHELL_FEED_BUFFER_SIZE must be a power of 2
+#endif
+
+#if SHELL_HISTORY_SEARCH_LENGTH > 0 && SHELL_HISTORY_POOL != 1
+    #error SHELL_HISTORY_SEARCH_LENGTH requires SHELL_HISTORY_POOL
+#endif
+
+#if SHELL_END_LINE_BUFFER > 0 && SHELL_SUPPORT_END_LINE != 1
+    #error SHELL_END_LINE_BUFFER requires SHELL_SUPPORT_END_LINE
+#endif
+
+#if SHELL_SIGN_POOL_SIZE > 0 \
+    && (SHELL_USING_FUNC_SIGNATURE != 1 || SHELL_CMD_INDEX_SIZE == 0)
+    #error SHELL_SIGN_POOL_SIZE requires SHELL_USING_FUNC_SIGNATURE and SHELL_CMD_INDEX_SIZE
+#endif
+
+#if SHELL_DESC_STRIP == 1 \
+    && (SHELL_USING_CMD_EXPORT != 1 || SHELL_CMD_COMPACT == 1)
+    #error SHELL_DESC_STRIP requires SHELL_USING_CMD_EXPORT and can not be used with SHELL_CMD_COMPACT
+#endif
+
+#if SHELL_EXEC_CACHE_SIZE > 0 \
+    && (SHELL_EXEC_CACHE_SIZE & (SHELL_EXEC_CACHE_SIZE - 1)) != 0
+    #error SHELL_EXEC_CACHE_SIZE must be a power of 2
+#endif
+#if SHELL_EXEC_CACHE_SIZE > 0
+static void shellExecCacheFlush(Shell *shell);
+#endif
+#if SHELL_END_LINE_BUFFER > 0
+static void shellEndLinePut(Shell *shell);
+#endif
+
+#if SHELL_USING_TX == 1
+    #define SHELL_WRITABLE(shell)   ((shell)->write || (shell)->tx)
+#else
+    #define SHELL_WRITABLE(shell)   ((shell)->write)
+#endif
+
+
+#if SHELL_CMD_INDEX_SIZE > 0
+#if (SHELL_CMD_INDEX_SIZE & (SHELL_CMD_INDEX_SIZE - 1)) != 0
+    #error SHELL_CMD_INDEX_SIZE must be a power of 2
+#endif
+/**
+ * @brief shell命令索引
+ *        开放寻址的哈希表，查找时需要的数据(名称哈希，类型，权限)分开存放，
+ *        只有在哈希命中后才会访问命令表本身
+ *        另外保存一份按名称排序的命令和变量序号，用于tab补全的范围查找
+ */
+static struct
+{
+    ShellCommand *base;                                 /**< 建立索引的命令表基址 */
+    unsigned short count;                               /**< 建立索引的命令表条目数量 */
+    unsigned short orderCount;                          /**< 排序表条目数量 */
+    unsigned short order[SHELL_CMD_INDEX_SIZE];         /**< 按名称排序的命令和变量序号 */
+    unsigned int hash[SHELL_CMD_INDEX_SIZE];            /**< 命令名哈希 */
+    unsigned short command[SHELL_CMD_INDEX_SIZE];       /**< 命令在命令表中的序号 + 1，0表示空槽位 */
+    unsigned char type[SHELL_CMD_INDEX_SIZE];           /**< 命令类型 */
+    unsigned char permission[SHELL_CMD_INDEX_SIZE];     /**< 命令权限 */
+} shellCmdIndex;
+
+static void shellCmdIndexBuild(Shell *shell);
+#endif /** SHELL_CMD_INDEX_SIZE > 0 */
+
+#if SHELL_CMD_VIEW_NUMBER > 0
+#if SHELL_CMD_INDEX_SIZE == 0
+    #error SHELL_CMD_VIEW_NUMBER requires SHELL_CMD_INDEX_SIZE
+#endif
+/**
+ * @brief shell命令视图位图测试
+ */
+#define SHELL_CMD_VIEW_TEST(view, index) \
+        (((view)[(index) >> 5] & (1u << ((index) & 0x1F))) != 0)
+
+/**
+ * @brief shell命令视图
+ *        按用户权限缓存的命令表访问位图，分别对应密码校验通过和未通过两种状态
+ *        视图只在持有选择锁并且没有shell引用时重建，使用中的视图不会被修改
+ */
+static struct
+{
+    unsigned int lock;                                  /**< 视图选择锁 */
+    unsigned char replace;                              /**< 下一个被替换的视图 */
+    struct
+    {
+        unsigned int refs;                              /**< 引用视图的shell数量 */
+        ShellCommand *base;                             /**< 命令表基址 */
+        unsigned short count;                           /**< 命令表条目数量 */
+        unsigned char permission;                       /**< 用户权限 */
+        unsigned int checked[(SHELL_CMD_INDEX_SIZE + 31) / 32];     /**< 校验通过时可访问的命令 */
+        unsigned int unchecked[(SHELL_CMD_INDEX_SIZE + 31) / 32];   /**< 校验未通过时可访问的命令 */
+    } view[SHELL_CMD_VIEW_NUMBER];
+} shellCmdView;
+
+static void shellCmdViewSelect(Shell *shell);
+static void shellCmdViewRelease(Shell *shell);
+static unsigned int* shellCmdViewGet(Shell *shell);
+#endif /** SHELL_CMD_VIEW_NUMBER > 0 */
+
+#if SHELL_DYNAMIC_CMD_NUMBER > 0
+static void shellCmdDynamicRelease(Shell *shell);
+#endif /** SHELL_DYNAMIC_CMD_NUMBER > 0 */
+
+#if SHELL_CMD_SORTED_SECTION == 1
+static int shellCmdSortedCheck(Shell *shell);
+#endif /** SHELL_CMD_SORTED_SECTION == 1 */
+
+/**
+ * @brief shell按键首字节位图
+ *        记录所有按键序列的第一个字节，用于快速判断输入字节是否可能是按键
+ */
+static struct
+{
+    ShellCommand *base;                                 /**< 建立位图的命令表基址 */
+    unsigned short count;                               /**< 建立位图的命令表条目数量 */
+    unsigned char map[32];                              /**< 首字节位图 */
+} shellKeyFirst;
+
+static void shellKeyFirstBuild(Shell *shell);
+
+#if SHELL_KEY_TRIE_SIZE > 0
+/**
+ * @brief shell按键前缀树
+ *        每个节点对应按键序列中的一个字节，子节点通过兄弟链表连接，
+ *        首字节使用按键首字节位图过滤，普通字符输入只需要一次位图查询
+ *        节点0作为空节点，不使用
+ */
+static struct
+{
+    ShellCommand *base;                                 /**< 建立前缀树的命令表基址 */
+    unsigned short count;                               /**< 建立前缀树的命令表条目数量 */
+    unsigned short root;                                /**< 首字节节点链表 */
+    struct
+    {
+        unsigned char byte;                             /**< 节点字节 */
+        unsigned short child;                           /**< 第一个子节点 */
+        unsigned short sibling;                         /**< 下一个兄弟节点 */
+        unsigned short key;                             /**< 按键在命令表中的序号 + 1，0表示非终止节点 */
+    } node[SHELL_KEY_TRIE_SIZE];
+} shellKeyTrie;
+
+static void shellKeyTrieBuild(Shell *shell);
+#endif /** SHELL_KEY_TRIE_SIZE > 0 */
+
 
-static void shellAdd(Shell *shell);
 static void shellWritePrompt(Shell *shell, unsigned char newline);
 static void shellWriteReturnValue(Shell *shell, int value);
 static int shellShowVar(Shell *shell, ShellCommand *command);
@@ -183,28 +400,81 @@ void shellInit(Shell *shell, char *buffer, unsigned short size)
 {
     shell->parser.length = 0;
     shell->parser.cursor = 0;
+#if SHELL_ARENA_SIZE > 0
+    shell->parser.param = NULL;
+    shell->parser.paramCount = 0;
+    shell->arena.used = 0;
+#endif
     shell->info.user = NULL;
     shell->status.isChecked = 1;
+    shell->status.isLocked = 0;
+#if SHELL_WRITE_BUFFER > 0
+    shell->output.length = 0;
+#endif
+    shell->output.block = 0;
+    shell->output.inHandler = 0;
+    shell->output.redrawPending = 0;
+#if SHELL_END_LINE_BUFFER > 0
+    shell->endLine.length = 0;
+#endif
+#if SHELL_CMD_VIEW_NUMBER > 0
+    shell->info.view = SHELL_CMD_VIEW_NUMBER;
+#endif
+#if SHELL_SUBMIT_QUEUE_SIZE > 0
+    shell->submit.head = 0;
+    shell->submit.tail = 0;
+    for (unsigned int i = 0; i < SHELL_SUBMIT_QUEUE_SIZE; i++)
+    {
+        shell->submit.cell[i].sequence = i;
+    }
+#endif
+#if SHELL_FEED_BUFFER_SIZE > 0
+    shell->feed.head = 0;
+    shell->feed.tail = 0;
+#endif
 
     shell->parser.buffer = buffer;
+#if SHELL_HISTORY_MAX_NUMBER > 0 && SHELL_HISTORY_POOL == 1
+    shell->parser.bufferSize = SHELL_COMMAND_MAX_LENGTH < size / 2
+                             ? SHELL_COMMAND_MAX_LENGTH : size / 2;
+#else
     shell->parser.bufferSize = size / (SHELL_HISTORY_MAX_NUMBER + 1);
+#endif
     
 #if SHELL_HISTORY_MAX_NUMBER > 0
     shell->history.offset = 0;
+#if SHELL_HISTORY_POOL == 1
+    shell->history.pool = buffer + shell->parser.bufferSize;
+    shell->history.size = size - shell->parser.bufferSize;
+    shell->history.used = 0;
+    shell->history.position = 0;
+#else
     shell->history.number = 0;
     shell->history.record = 0;
     for (short i = 0; i < SHELL_HISTORY_MAX_NUMBER; i++)
     {
         shell->history.item[i] = buffer + shell->parser.bufferSize * (i + 1);
     }
+#endif
+#if SHELL_HISTORY_SEARCH_LENGTH > 0
+    shell->history.search.active = 0;
+    shell->history.search.length = 0;
+#endif
 #endif /** SHELL_HISTORY_MAX_NUMBER > 0 */
 
 #if SHELL_USING_CMD_EXPORT == 1
     #if defined(__CC_ARM) || (defined(__ARMCC_VERSION) && __ARMCC_VERSION >= 6000000)
+    #if SHELL_CMD_SORTED_SECTION == 1
+        shell->commandList.base = (ShellCommand *)(&Image$$SHELL_COMMAND$$Base);
+        shell->commandList.count = ((size_t)(&Image$$SHELL_COMMAND$$Limit)
+                                - (size_t)(&Image$$SHELL_COMMAND$$Base))
+                                / sizeof(ShellCommand);
+    #else
         shell->commandList.base = (ShellCommand *)(&shellCommand$$Base);
         shell->commandList.count = ((size_t)(&shellCommand$$Limit)
                                 - (size_t)(&shellCommand$$Base))
                                 / sizeof(ShellCommand);
+    #endif
 
     #elif defined(__ICCARM__) || defined(__ICCRX__)
         shell->commandList.base = (ShellCommand *)(__section_begin("shellCommand"));
@@ -224,1654 +494,5917 @@ void shellInit(Shell *shell, char *buffer, unsigned short size)
     shell->commandList.count = shellCommandCount;
 #endif
 
-    shellAdd(shell);
+#if SHELL_CMD_SORTED_SECTION == 1
+    int sorted = shellCmdSortedCheck(shell);
+#endif
+#if SHELL_CMD_INDEX_SIZE > 0
+    shellCmdIndexBuild(shell);
+#endif
+    shellKeyFirstBuild(shell);
+#if SHELL_KEY_TRIE_SIZE > 0
+    shellKeyTrieBuild(shell);
+#endif
+#if SHELL_SIGN_POOL_SIZE > 0
+    shellExtSignBuild(shell);
+#endif
+
+    if (shellAdd(shell) != 0)
+    {
+        shellWriteString(shell, shellText[SHELL_TEXT_SHELL_LIST_FULL]);
+    }
 
     shellSetUser(shell, shellSeekCommand(shell,
                                          SHELL_DEFAULT_USER,
                                          shell->commandList.base,
                                          0));
+#if SHELL_EXEC_CACHE_SIZE > 0
+    shellExecCacheFlush(shell);
+#endif
+#if SHELL_CMD_SORTED_SECTION == 1
+    if (sorted != 0)
+    {
+        shellWriteString(shell, shellText[SHELL_TEXT_CMD_NOT_SORTED]);
+    }
+#endif
     shellWritePrompt(shell, 1);
 }
 
 
 /**
  * @brief 添加shell
+ *        `shellInit`会自动添加shell，其他shell对象(如后台任务使用的shell)
+ *        可以直接调用此函数添加，使`shellGetCurrent`可以获取到，可以在不同的线程中调用
  * 
  * @param shell shell对象
+ * 
+ * @return int 0 添加成功 -1 shell列表已满
  */
-static void shellAdd(Shell *shell)
+int shellAdd(Shell *shell)
 {
+    Shell *expected;
+
     for (short i = 0; i < SHELL_MAX_NUMBER; i++)
     {
-        if (shellList[i] == NULL)
+        expected = NULL;
+        while (expected == NULL)
         {
-            shellList[i] = shell;
-            return;
+            if (SHELL_ATOMIC_CAS(&shellList[i], &expected, shell))
+            {
+                return 0;
+            }
         }
     }
+    return -1;
 }
 
 /**
  * @brief 移除shell
+ *        shell在动态命令表读者临界区中被终止时(如被终止的后台任务)，同时退出临界区
  * 
  * @param shell shell对象
  * 
  */
 void shellRemove(Shell *shell)
 {
+#if SHELL_CMD_VIEW_NUMBER > 0
+    shellCmdViewRelease(shell);
+#endif
+#if SHELL_DYNAMIC_CMD_NUMBER > 0
+    shellCmdDynamicRelease(shell);
+#endif
+    Shell *expected;
+
     for (short i = 0; i < SHELL_MAX_NUMBER; i++)
     {
-        if (shellList[i] == shell)
+        expected = shell;
+        while (expected == shell)
         {
-            shellList[i] = NULL;
-            return;
+            if (SHELL_ATOMIC_CAS(&shellList[i], &expected, NULL))
+            {
+                return;
+            }
         }
     }
 }
 
 /**
  * @brief 获取当前活动shell
+ *        优先返回在当前任务中执行命令的shell，没有时返回第一个活动的shell
  * 
  * @return Shell* 当前活动shell对象
  */
 Shell* shellGetCurrent(void)
 {
+    size_t task = (size_t)SHELL_GET_TASK();
+    Shell *active = NULL;
+    Shell *shell;
+
     for (short i = 0; i < SHELL_MAX_NUMBER; i++)
     {
-        if (shellList[i] && shellList[i]->status.isActive)
+        shell = SHELL_ATOMIC_LOAD(&shellList[i]);
+        if (shell && shell->status.isActive)
         {
-            return shellList[i];
+            if (shell->info.task == task)
+            {
+                return shell;
+            }
+            if (active == NULL)
+            {
+                active = shell;
+            }
         }
     }
-    return NULL;
+    return active;
 }
 
 
 /**
- * @brief shell写字符
+ * @brief shell 输出锁加锁
+ *        每次输出都加锁，持有输出块的任务可以继续输出，其他任务的输出等待输出块结束，
+ *        定义`SHELL_GET_TASK()`时，嵌套由shell记录持有输出锁的任务和深度，输出锁使用普通互斥锁即可，
+ *        否则每次都调用`writeLock`，输出锁需要支持嵌套
  * 
  * @param shell shell对象
- * @param data 字符数据
  */
-static void shellWriteByte(Shell *shell, char data)
+static void shellWriteLock(Shell *shell)
 {
-    shell->write(&data, 1);
+#if SHELL_USING_LOCK == 1
+    size_t task = (size_t)SHELL_GET_TASK();
+
+    if (task != 0 && SHELL_ATOMIC_LOAD(&shell->output.lockOwner) == task)
+    {
+        shell->output.lockDepth++;
+        return;
+    }
+    SHELL_WRITE_LOCK(shell);
+    if (task != 0)
+    {
+        SHELL_ATOMIC_STORE(&shell->output.lockOwner, task);
+        shell->output.lockDepth = 1;
+    }
+#else
+    (void)shell;
+#endif
 }
 
 
 /**
- * @brief shell 写字符串
+ * @brief shell 输出锁解锁
  * 
  * @param shell shell对象
- * @param string 字符串数据
- * 
- * @return unsigned short 写入字符的数量
  */
-unsigned short shellWriteString(Shell *shell, const char *string)
+static void shellWriteUnlock(Shell *shell)
 {
-    unsigned short count = 0;
-    const char *p = string;
-    SHELL_ASSERT(shell->write, return 0);
-    while(*p++)
+#if SHELL_USING_LOCK == 1
+    if ((size_t)SHELL_GET_TASK() != 0)
     {
-        count ++;
+        if (--shell->output.lockDepth > 0)
+        {
+            return;
+        }
+        SHELL_ATOMIC_STORE(&shell->output.lockOwner, 0);
     }
-    return shell->write((char *)string, count);
+    SHELL_WRITE_UNLOCK(shell);
+#else
+    (void)shell;
+#endif
 }
 
 
+#if SHELL_USING_TX == 1
 /**
- * @brief shell 写命令描述字符串
+ * @brief TX环形缓冲 初始化
  * 
- * @param shell shell对象
- * @param string 字符串数据
+ * @param tx TX环形缓冲
+ * @param buffer 缓冲
+ * @param size 缓冲大小，必须为2的幂
+ * @param kick 启动发送，发送`data`开始的`len`字节，发送完成后调用`shellTxComplete()`
+ */
+void shellTxInit(ShellTx *tx, char *buffer, unsigned short size,
+                 void (*kick)(ShellTx *, char *, unsigned short))
+{
+    SHELL_ASSERT((size & (size - 1)) == 0, return);
+    tx->buffer = buffer;
+    tx->size = size;
+    tx->policy = SHELL_TX_BLOCK;
+    tx->sending = 0;
+    tx->head = 0;
+    tx->next = 0;
+    tx->tail = 0;
+    tx->spin = 0;
+    tx->kick = kick;
+}
+
+
+/**
+ * @brief TX环形缓冲 获取下一段需要发送的数据(调用者处于临界区)
+ *        数据从`next`开始发送，`head`和`next`之间被丢弃的数据不会发送
  * 
- * @return unsigned short 写入字符的数量
+ * @param tx TX环形缓冲
+ * 
+ * @return unsigned short 需要发送的数据长度，正在发送或者没有数据时返回0
  */
-static unsigned short shellWriteCommandDesc(Shell *shell, const char *string)
+static unsigned short shellTxNext(ShellTx *tx)
 {
-    unsigned short count = 0;
-    const char *p = string;
-    SHELL_ASSERT(shell->write, return 0);
-    while (*p && *p != '\r' && *p != '\n')
-    {
-        p++;
-        count++;
-    }
-    
-    if (count > 36)
+    unsigned short offset = tx->next & (tx->size - 1);
+    unsigned int length = tx->tail - tx->next;
+
+    if (tx->sending > 0 || length == 0)
     {
-        shell->write((char *)string, 36);
-        shell->write("...", 3);
+        return 0;
     }
-    else
+    if (length > (unsigned int)(tx->size - offset))
     {
-        shell->write((char *)string, count);
+        length = tx->size - offset;
     }
-    return count > 36 ? 36 : 39;
+    tx->head = tx->next;
+    tx->next += length;
+    tx->sending = length;
+    return length;
 }
 
 
 /**
- * @brief shell写命令提示符
+ * @brief TX环形缓冲 写入数据
+ *        数据写入缓冲后返回，没有正在进行的发送时调用`kick`启动发送，
+ *        缓冲满时按照`policy`等待或者丢弃数据，`SHELL_TX_DROP_OLDEST`每次写入只丢弃一次，
+ *        丢弃的数量为新数据长度减去空闲空间和正在发送的数据长度(正在发送的数据发送完成后会释放)，
+ *        之后等待当前发送完成
  * 
- * @param shell shell对象
- * @param newline 新行
+ * @param tx TX环形缓冲
+ * @param data 数据
+ * @param len 数据长度
  * 
+ * @return unsigned short 写入缓冲的数据长度
  */
-static void shellWritePrompt(Shell *shell, unsigned char newline)
+unsigned short shellTxWrite(ShellTx *tx, const char *data, unsigned short len)
 {
-    if (shell->status.isChecked)
+    unsigned short written = 0;
+    unsigned char dropped = tx->policy != SHELL_TX_DROP_OLDEST;
+    unsigned int space;
+    unsigned int queued;
+    unsigned short offset;
+    unsigned short count;
+    unsigned short start;
+    unsigned short run;
+
+    while (len > 0)
     {
-        if (newline)
+        SHELL_TX_CRITICAL_ENTER(tx);
+        if (!dropped)
         {
-            shellWriteString(shell, "\r\n");
+            dropped = 1;
+            queued = tx->tail - tx->next;
+            if (len > tx->size - queued)
+            {
+                tx->next += len - (tx->size - queued) < queued
+                    ? len - (tx->size - queued) : queued;
+                if (tx->sending == 0)
+                {
+                    tx->head = tx->next;
+                }
+            }
         }
-        shellWriteString(shell, shell->info.user->data.user.name);
-        shellWriteString(shell, ":");
-        shellWriteString(shell, shell->info.path ? shell->info.path : "/");
-        shellWriteString(shell, "$ ");
-    }
-    else
-    {
-        shellWriteString(shell, shellText[SHELL_TEXT_PASSWORD_HINT]);
+        space = tx->size - (tx->tail - tx->head);
+        if (space == 0)
+        {
+            SHELL_TX_CRITICAL_EXIT(tx);
+            if (tx->policy == SHELL_TX_DROP_NEWEST)
+            {
+                break;
+            }
+            SHELL_TX_WAIT(tx);
+            continue;
+        }
+        count = space > len ? len : space;
+        offset = tx->tail & (tx->size - 1);
+        run = tx->size - offset;
+        if (run >= count)
+        {
+            memcpy(tx->buffer + offset, data, count);
+        }
+        else
+        {
+            memcpy(tx->buffer + offset, data, run);
+            memcpy(tx->buffer, data + run, count - run);
+        }
+        tx->tail += count;
+        run = shellTxNext(tx);
+        start = tx->head & (tx->size - 1);
+        SHELL_TX_CRITICAL_EXIT(tx);
+
+        if (run > 0)
+        {
+            tx->kick(tx, tx->buffer + start, run);
+        }
+        data += count;
+        len -= count;
+        written += count;
     }
+    return written;
 }
 
 
-#if SHELL_PRINT_BUFFER > 0
 /**
- * @brief shell格式化输出
+ * @brief TX环形缓冲 发送完成
+ *        在发送完成中断或者发送线程中调用，释放已经发送的数据和发送期间被丢弃的数据，还有数据时启动下一次发送
  * 
- * @param shell shell对象
- * @param fmt 格式化字符串
- * @param ... 参数
+ * @param tx TX环形缓冲
+ * @param len 已经发送的数据长度
  */
-void shellPrint(Shell *shell, const char *fmt, ...)
+void shellTxComplete(ShellTx *tx, unsigned short len)
 {
-    char buffer[SHELL_PRINT_BUFFER];
-    va_list vargs;
-    int len;
+    unsigned short start;
+    unsigned short run;
 
-    SHELL_ASSERT(shell, return);
+    SHELL_TX_CRITICAL_ENTER(tx);
+    if (len > tx->sending)
+    {
+        len = tx->sending;
+    }
+    tx->head += len;
+    tx->sending -= len;
+    if (tx->sending == 0)
+    {
+        tx->head = tx->next;
+    }
+    run = shellTxNext(tx);
+    start = tx->head & (tx->size - 1);
+    SHELL_TX_CRITICAL_EXIT(tx);
 
-    va_start(vargs, fmt);
-    len = vsnprintf(buffer, SHELL_PRINT_BUFFER, fmt, vargs);
-    va_end(vargs);
-    if (len > SHELL_PRINT_BUFFER)
+    if (run > 0)
     {
-        len = SHELL_PRINT_BUFFER;
+        tx->kick(tx, tx->buffer + start, run);
     }
-    shell->write(buffer, len);
 }
-#endif
+#endif /** SHELL_USING_TX == 1 */
 
 
-#if SHELL_SCAN_BUFFER > 0
 /**
- * @brief shell格式化输入
+ * @brief shell 调用写函数输出数据
+ *        设置了TX环形缓冲时写入缓冲
  * 
  * @param shell shell对象
- * @param fmt 格式化字符串
- * @param ... 参数
+ * @param data 数据
+ * @param len 数据长度
+ * 
+ * @return unsigned short 写入数据的长度
  */
-void shellScan(Shell *shell, char *fmt, ...)
+static unsigned short shellPutRaw(Shell *shell, const char *data, unsigned short len)
 {
-    char buffer[SHELL_SCAN_BUFFER];
-    va_list vargs;
-    short index = 0;
-
-    SHELL_ASSERT(shell, return);
-
-    if (shell->read)
+#if SHELL_USING_TX == 1
+    if (shell->tx)
     {
-        do {
-            if (shell->read(&buffer[index], 1) == 1)
-            {
-                shell->write(&buffer[index], 1);
-                index++;
-            }
-        } while (buffer[index -1] != '\r' && buffer[index -1] != '\n' && index < SHELL_SCAN_BUFFER);
-        shellWriteString(shell, "\r\n");
-        buffer[index] = '\0';
+        return shellTxWrite(shell->tx, data, len);
     }
-
-    va_start(vargs, fmt);
-    vsscanf(buffer, fmt, vargs);
-    va_end(vargs);
-}
 #endif
+    return shell->write((char *)data, len);
+}
 
 
 /**
- * @brief shell 检查命令权限
+ * @brief shell 输出缓冲中的数据(调用者持有输出锁)
  * 
  * @param shell shell对象
- * @param command ShellCommand
- * 
- * @return signed char 0 当前用户具有该命令权限
- * @return signec char -1 当前用户不具有该命令权限
  */
-signed char shellCheckPermission(Shell *shell, ShellCommand *command)
+static void shellPutFlush(Shell *shell)
 {
-    return ((!command->attr.attrs.permission
-                || command->attr.attrs.type == SHELL_TYPE_USER
-                || (shell->info.user
-                    && (command->attr.attrs.permission 
-                        & shell->info.user->attr.attrs.permission)))
-            && (shell->status.isChecked
-                || command->attr.attrs.enableUnchecked))
-            ? 0 : -1;
+#if SHELL_WRITE_BUFFER > 0
+    if (shell->output.length > 0)
+    {
+        shellPutRaw(shell, shell->output.buffer, shell->output.length);
+        shell->output.length = 0;
+    }
+#else
+    (void)shell;
+#endif
 }
 
 
 /**
- * @brief int转16进制字符串
+ * @brief shell 写数据(调用者持有输出锁)
+ *        使用输出缓冲时，数据写入缓冲，缓冲满时输出
  * 
- * @param value 数值
- * @param buffer 缓冲
+ * @param shell shell对象
+ * @param data 数据
+ * @param len 数据长度
  * 
- * @return signed char 转换后有效数据长度
+ * @return unsigned short 写入数据的长度
  */
-signed char shellToHex(unsigned int value, char *buffer)
+static unsigned short shellPutData(Shell *shell, const char *data, unsigned short len)
 {
-    char byte;
-    unsigned char i = 8;
-    buffer[8] = 0;
-    while (value)
+#if SHELL_WRITE_BUFFER > 0
+    unsigned short count;
+    unsigned short written = len;
+
+    while (len > 0)
     {
-        byte = value & 0x0000000F;
-        buffer[--i] = (byte > 9) ? (byte + 87) : (byte + 48);
-        value >>= 4;
+        if (shell->output.length == 0 && len >= SHELL_WRITE_BUFFER)
+        {
+            shellPutRaw(shell, data, len);
+            break;
+        }
+        count = SHELL_WRITE_BUFFER - shell->output.length;
+        count = count > len ? len : count;
+        memcpy(shell->output.buffer + shell->output.length, data, count);
+        shell->output.length += count;
+        data += count;
+        len -= count;
+        if (shell->output.length == SHELL_WRITE_BUFFER)
+        {
+            shellPutFlush(shell);
+        }
     }
-    return 8 - i;
+    return written;
+#else
+    return shellPutRaw(shell, data, len);
+#endif
 }
 
 
 /**
-* @brief int转10进制字符串
- * 
- * @param value 数值
- * @param buffer 缓冲
+ * @brief shell 写字符串(调用者持有输出锁)
  * 
- * @return signed char 转换后有效数据长度
+ * @param shell shell对象
+ * @param string 字符串
  */
-signed char shellToDec(int value, char *buffer)
+static void shellPutString(Shell *shell, const char *string)
 {
-    unsigned char i = 11;
-    int v = value;
-    if (value < 0)
-    {
-        v = -value;
-    }
-    buffer[11] = 0;
-    while (v)
-    {
-        buffer[--i] = v % 10 + 48;
-        v /= 10;
-    }
-    if (value < 0)
-    {
-        buffer[--i] = '-';
-    }
-    if (value == 0) {
-        buffer[--i] = '0';
-    }
-    return 11 - i;
+    shellPutData(shell, string, strlen(string));
 }
 
 
 /**
- * @brief shell字符串复制
+ * @brief shell 写数据
  * 
- * @param dest 目标字符串
- * @param src 源字符串
- * @return unsigned short 字符串长度
+ * @param shell shell对象
+ * @param data 数据
+ * @param len 数据长度
+ * 
+ * @return unsigned short 写入数据的长度
  */
-static unsigned short shellStringCopy(char *dest, char* src)
+static unsigned short shellWriteData(Shell *shell, const char *data, unsigned short len)
 {
-    unsigned short count = 0;
-    while (*(src + count))
-    {
-        *(dest + count) = *(src + count);
-        count++;
-    }
-    *(dest + count) = 0;
-    return count;
+    unsigned short written;
+
+    shellWriteLock(shell);
+    written = shellPutData(shell, data, len);
+    shellWriteUnlock(shell);
+    return written;
 }
 
 
 /**
- * @brief shell字符串比较
+ * @brief shell 输出缓冲中的数据
  * 
- * @param dest 目标字符串
- * @param src 源字符串
- * @return unsigned short 匹配长度
+ * @param shell shell对象
  */
-static unsigned short shellStringCompare(char* dest, char *src)
+void shellFlush(Shell *shell)
 {
-    unsigned short match = 0;
-    unsigned short i = 0;
-
-    while (*(dest +i) && *(src + i))
-    {
-        if (*(dest + i) != *(src +i))
-        {
-            break;
-        }
-        match ++;
-        i++;
-    }
-    return match;
+#if SHELL_WRITE_BUFFER > 0
+    shellWriteLock(shell);
+    shellPutFlush(shell);
+    shellWriteUnlock(shell);
+#else
+    (void)shell;
+#endif
 }
 
 
 /**
- * @brief shell获取命令名
+ * @brief shell 在输出点输出缓冲
+ *        处于输出块中时不输出，由`shellWriteBlockEnd()`统一输出
  * 
- * @param command 命令
- * @return const char* 命令名
+ * @param shell shell对象
  */
-static const char* shellGetCommandName(ShellCommand *command)
+static void shellFlushPoint(Shell *shell)
 {
-    static char buffer[9];
-    for (unsigned char i = 0; i < 9; i++)
-    {
-        buffer[i] = '0';
-    }
-    if (command->attr.attrs.type <= SHELL_TYPE_CMD_FUNC)
-    {
-        return command->data.cmd.name;
-    }
-    else if (command->attr.attrs.type <= SHELL_TYPE_VAR_NODE)
-    {
-        return command->data.var.name;
-    }
-    else if (command->attr.attrs.type <= SHELL_TYPE_USER)
-    {
-        return command->data.user.name;
-    }
-#if SHELL_USING_FUNC_SIGNATURE == 1
-    else if (command->attr.attrs.type == SHELL_TYPE_PARAM_PARSER)
+#if SHELL_WRITE_BUFFER > 0
+    if (shell->output.block == 0)
     {
-        return command->data.paramParser.type;
+        shellFlush(shell);
     }
+#else
+    (void)shell;
 #endif
-    else
-    {
-        shellToHex(command->data.key.value, buffer);
-        return buffer;
-    }
 }
 
 
 /**
- * @brief shell获取命令描述
+ * @brief shell 开始输出块
+ *        输出块中的输出只会在缓冲满或者输出块结束时输出，并且输出块期间持有输出锁，
+ *        不会和其他任务的输出交错，输出块可以嵌套
+ * @note 输出块中不能调用`shellWriteEndLine()`
  * 
- * @param command 命令
- * @return const char* 命令描述
+ * @param shell shell对象
  */
-static const char* shellGetCommandDesc(ShellCommand *command)
+void shellWriteBlockBegin(Shell *shell)
 {
-    if (command->attr.attrs.type <= SHELL_TYPE_CMD_FUNC)
-    {
-        return command->data.cmd.desc;
-    }
-    else if (command->attr.attrs.type <= SHELL_TYPE_VAR_NODE)
-    {
-        return command->data.var.desc;
-    }
-    else if (command->attr.attrs.type <= SHELL_TYPE_USER)
-    {
-        return command->data.user.desc;
-    }
-    else
-    {
-        return command->data.key.desc;
-    }
+    shellWriteLock(shell);
+    shell->output.block++;
 }
 
+
 /**
- * @brief shell 列出命令条目
+ * @brief shell 结束输出块
  * 
  * @param shell shell对象
- * @param item 命令条目
  */
-void shellListItem(Shell *shell, ShellCommand *item)
+void shellWriteBlockEnd(Shell *shell)
 {
-    short spaceLength;
-
-    spaceLength = 22 - shellWriteString(shell, shellGetCommandName(item));
-    spaceLength = (spaceLength > 0) ? spaceLength : 4;
-    do {
-        shellWriteByte(shell, ' ');
-    } while (--spaceLength);
-    if (item->attr.attrs.type <= SHELL_TYPE_CMD_FUNC)
-    {
-        shellWriteString(shell, shellText[SHELL_TEXT_TYPE_CMD]);
-    }
-    else if (item->attr.attrs.type <= SHELL_TYPE_VAR_NODE)
-    {
-        shellWriteString(shell, shellText[SHELL_TEXT_TYPE_VAR]);
-    }
-    else if (item->attr.attrs.type <= SHELL_TYPE_USER)
-    {
-        shellWriteString(shell, shellText[SHELL_TEXT_TYPE_USER]);
-    }
-    else if (item->attr.attrs.type <= SHELL_TYPE_KEY)
-    {
-        shellWriteString(shell, shellText[SHELL_TEXT_TYPE_KEY]);
-    }
-    else
-    {
-        shellWriteString(shell, shellText[SHELL_TEXT_TYPE_NONE]);
-    }
-#if SHELL_HELP_SHOW_PERMISSION == 1
-    shellWriteString(shell, "  ");
-    for (signed char i = 7; i >= 0; i--)
+    if (shell->output.block > 0)
     {
-        shellWriteByte(shell, item->attr.attrs.permission & (1 << i) ? 'x' : '-');
+        if (--shell->output.block == 0)
+        {
+            shellPutFlush(shell);
+        }
+        shellWriteUnlock(shell);
     }
-#endif
-    shellWriteString(shell, "  ");
-    shellWriteCommandDesc(shell, shellGetCommandDesc(item));
-    shellWriteString(shell, "\r\n");
 }
 
 
 /**
- * @brief shell列出可执行命令
+ * @brief shell写字符
  * 
  * @param shell shell对象
+ * @param data 字符数据
  */
-void shellListCommand(Shell *shell)
+static void shellWriteByte(Shell *shell, char data)
 {
-    ShellCommand *base = (ShellCommand *)shell->commandList.base;
-    shellWriteString(shell, shellText[SHELL_TEXT_CMD_LIST]);
-    for (short i = 0; i < shell->commandList.count; i++)
-    {
-        if (base[i].attr.attrs.type <= SHELL_TYPE_CMD_FUNC
-            && shellCheckPermission(shell, &base[i]) == 0)
-        {
-            shellListItem(shell, &base[i]);
-        }
-    }
+    shellWriteData(shell, &data, 1);
 }
 
 
 /**
- * @brief shell列出变量
+ * @brief shell 写字符串
  * 
  * @param shell shell对象
+ * @param string 字符串数据
+ * 
+ * @return unsigned short 写入字符的数量
  */
-void shellListVar(Shell *shell)
+unsigned short shellWriteString(Shell *shell, const char *string)
 {
-    ShellCommand *base = (ShellCommand *)shell->commandList.base;
-    shellWriteString(shell, shellText[SHELL_TEXT_VAR_LIST]);
-    for (short i = 0; i < shell->commandList.count; i++)
+    unsigned short count = 0;
+    const char *p = string;
+    SHELL_ASSERT(SHELL_WRITABLE(shell), return 0);
+    while(*p++)
     {
-        if (base[i].attr.attrs.type > SHELL_TYPE_CMD_FUNC
-            && base[i].attr.attrs.type <= SHELL_TYPE_VAR_NODE
-            && shellCheckPermission(shell, &base[i]) == 0)
-        {
-            shellListItem(shell, &base[i]);
-        }
+        count ++;
     }
+    return shellWriteData(shell, string, count);
 }
 
 
+#if SHELL_DESC_STRIP == 0
 /**
- * @brief shell列出用户
+ * @brief shell 写命令描述字符串
  * 
  * @param shell shell对象
+ * @param string 字符串数据
+ * 
+ * @return unsigned short 写入字符的数量
  */
-void shellListUser(Shell *shell)
+static unsigned short shellWriteCommandDesc(Shell *shell, const char *string)
 {
-    ShellCommand *base = (ShellCommand *)shell->commandList.base;
-    shellWriteString(shell, shellText[SHELL_TEXT_USER_LIST]);
-    for (short i = 0; i < shell->commandList.count; i++)
+    unsigned short count = 0;
+    const char *p = string;
+    SHELL_ASSERT(SHELL_WRITABLE(shell), return 0);
+    while (*p && *p != '\r' && *p != '\n')
     {
-        if (base[i].attr.attrs.type > SHELL_TYPE_VAR_NODE
-            && base[i].attr.attrs.type <= SHELL_TYPE_USER
-            && shellCheckPermission(shell, &base[i]) == 0)
-        {
-            shellListItem(shell, &base[i]);
-        }
+        p++;
+        count++;
+    }
+    
+    if (count > 36)
+    {
+        shellWriteData(shell, string, 36);
+        shellWriteData(shell, "...", 3);
+    }
+    else
+    {
+        shellWriteData(shell, string, count);
     }
+    return count > 36 ? 36 : 39;
 }
+#endif /** SHELL_DESC_STRIP == 0 */
 
 
 /**
- * @brief shell列出按键
+ * @brief shell写命令提示符(调用者持有输出锁)
  * 
  * @param shell shell对象
+ * @param newline 新行
+ * 
  */
-void shellListKey(Shell *shell)
+static void shellPutPrompt(Shell *shell, unsigned char newline)
 {
-    ShellCommand *base = (ShellCommand *)shell->commandList.base;
-    shellWriteString(shell, shellText[SHELL_TEXT_KEY_LIST]);
-    for (short i = 0; i < shell->commandList.count; i++)
+    if (shell->status.isChecked)
     {
-        if (base[i].attr.attrs.type > SHELL_TYPE_USER
-            && base[i].attr.attrs.type <= SHELL_TYPE_KEY
-            && shellCheckPermission(shell, &base[i]) == 0)
+        if (newline)
         {
-            shellListItem(shell, &base[i]);
+            shellPutString(shell, "\r\n");
         }
+        shellPutString(shell, shell->info.user->data.user.name);
+        shellPutString(shell, ":");
+        shellPutString(shell, shell->info.path ? shell->info.path : "/");
+        shellPutString(shell, "$ ");
+    }
+    else
+    {
+        shellPutString(shell, shellText[SHELL_TEXT_PASSWORD_HINT]);
     }
 }
 
 
 /**
- * @brief shell列出所有命令
+ * @brief shell写命令提示符
  * 
  * @param shell shell对象
+ * @param newline 新行
+ * 
  */
-void shellListAll(Shell *shell)
+static void shellWritePrompt(Shell *shell, unsigned char newline)
 {
-#if SHELL_HELP_LIST_USER == 1
-    shellListUser(shell);
-#endif
-    shellListCommand(shell);
-#if SHELL_HELP_LIST_VAR == 1
-    shellListVar(shell);
-#endif
-#if SHELL_HELP_LIST_KEY == 1
-    shellListKey(shell);
-#endif
+    shellWriteLock(shell);
+    shellPutPrompt(shell, newline);
+    shellWriteUnlock(shell);
+    shellFlushPoint(shell);
 }
 
 
 /**
- * @brief shell删除命令行数据
- * 
- * @param shell shell对象
- * @param length 删除长度
+ * @brief 两位十进制数字表，整数转换时每次查表得到两位数字
  */
-void shellDeleteCommandLine(Shell *shell, unsigned char length)
-{
-    while (length--)
-    {
-        shellWriteString(shell, "\b \b");
-    }
-}
+static const char shellDigitPairs[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+/**
+ * @brief 16进制数字表，前16个为小写，后16个为大写
+ */
+static const char shellHexDigits[] = "0123456789abcdef0123456789ABCDEF";
 
 
 /**
- * @brief shell 清空命令行输入
+ * @brief 无符号整数转10进制字符串
+ *        从缓冲末尾向前写入，每次除以100查表得到两位数字，数值小于2^32后使用32位运算
  * 
- * @param shell shell对象
+ * @param value 数值
+ * @param end 缓冲末尾
+ * 
+ * @return char* 转换结果的起始位置
  */
-void shellClearCommandLine(Shell *shell)
+static char *shellFormatDec(unsigned long long value, char *end)
 {
-    for (short i = shell->parser.length - shell->parser.cursor; i > 0; i--)
+    unsigned long small;
+    unsigned short pair;
+
+    while (value > 0xFFFFFFFFUL)
     {
-        shellWriteByte(shell, ' ');
+        pair = (unsigned short)(value % 100) * 2;
+        value /= 100;
+        *--end = shellDigitPairs[pair + 1];
+        *--end = shellDigitPairs[pair];
     }
-    shellDeleteCommandLine(shell, shell->parser.length);
+    small = (unsigned long)value;
+    while (small >= 100)
+    {
+        pair = (unsigned short)(small % 100) * 2;
+        small /= 100;
+        *--end = shellDigitPairs[pair + 1];
+        *--end = shellDigitPairs[pair];
+    }
+    if (small >= 10)
+    {
+        *--end = shellDigitPairs[small * 2 + 1];
+        *--end = shellDigitPairs[small * 2];
+    }
+    else
+    {
+        *--end = '0' + small;
+    }
+    return end;
 }
 
 
 /**
- * @brief shell插入一个字符到光标位置
+ * @brief 无符号整数转2的幂进制字符串
  * 
- * @param shell shell对象
- * @param data 字符数据
+ * @param value 数值
+ * @param end 缓冲末尾
+ * @param shift 每位数字的位数，8进制为3，16进制为4
+ * @param digits 数字表
+ * 
+ * @return char* 转换结果的起始位置
  */
-void shellInsertByte(Shell *shell, char data)
+static char *shellFormatRadix(unsigned long long value, char *end,
+                              unsigned char shift, const char *digits)
 {
-    /* 判断输入数据是否过长 */
-    if (shell->parser.length >= shell->parser.bufferSize - 1)
-    {
-        shellWriteString(shell, shellText[SHELL_TEXT_CMD_TOO_LONG]);
-        shellWritePrompt(shell, 1);
-        shellWriteString(shell, shell->parser.buffer);
-        return;
-    }
+    do {
+        *--end = digits[value & ((1 << shift) - 1)];
+        value >>= shift;
+    } while (value);
+    return end;
+}
 
-    /* 插入数据 */
-    if (shell->parser.cursor == shell->parser.length)
-    {
-        shell->parser.buffer[shell->parser.length++] = data;
-        shell->parser.buffer[shell->parser.length] = 0;
-        shell->parser.cursor++;
-        shellWriteByte(shell, shell->status.isChecked ? data : '*');
-    }
-    else if (shell->parser.cursor < shell->parser.length)
+
+/**
+ * @brief shell格式化输出标志
+ */
+enum
+{
+    SHELL_FORMAT_LEFT = 0x01,                           /**< `-` 左对齐 */
+    SHELL_FORMAT_PLUS = 0x02,                           /**< `+` 正数输出符号 */
+    SHELL_FORMAT_SPACE = 0x04,                          /**< ` ` 正数输出空格 */
+    SHELL_FORMAT_ALT = 0x08,                            /**< `#` 替代形式 */
+    SHELL_FORMAT_ZERO = 0x10,                           /**< `0` 使用0填充 */
+};
+
+/**
+ * @brief shell格式化输出状态
+ */
+typedef struct
+{
+    ShellFormatWrite write;                             /**< 输出函数 */
+    void *context;                                      /**< 输出函数上下文 */
+    int count;                                          /**< 已输出的字符数 */
+    unsigned char flags;                                /**< 当前转换的标志 */
+    int width;                                          /**< 当前转换的宽度 */
+    int precision;                                      /**< 当前转换的精度，-1表示未指定 */
+} ShellFormatter;
+
+
+/**
+ * @brief shell格式化输出数据
+ * 
+ * @param formatter 格式化输出状态
+ * @param data 数据
+ * @param len 数据长度
+ */
+static void shellFormatPut(ShellFormatter *formatter, const char *data, size_t len)
+{
+    unsigned short count;
+
+    while (len > 0)
     {
-        for (short i = shell->parser.length - shell->parser.cursor; i > 0; i--)
-        {
-            shell->parser.buffer[shell->parser.cursor + i] = 
-                shell->parser.buffer[shell->parser.cursor + i - 1];
-        }
-        shell->parser.buffer[shell->parser.cursor++] = data;
-        shell->parser.buffer[++shell->parser.length] = 0;
-        for (short i = shell->parser.cursor - 1; i < shell->parser.length; i++)
-        {
-            shellWriteByte(shell, 
-                           shell->status.isChecked ? shell->parser.buffer[i] : '*');
-        }
-        for (short i = shell->parser.length - shell->parser.cursor; i > 0; i--)
-        {
-            shellWriteByte(shell, '\b');
-        }
+        count = len > 0x7FFF ? 0x7FFF : len;
+        formatter->write(formatter->context, data, count);
+        formatter->count += count;
+        data += count;
+        len -= count;
     }
 }
 
 
 /**
- * @brief shell 删除字节
+ * @brief shell格式化输出填充字符
  * 
- * @param shell shell对象
- * @param direction 删除方向 {@code 1}删除光标前字符 {@code -1}删除光标处字符
+ * @param formatter 格式化输出状态
+ * @param fill 填充字符，空格或者0
+ * @param count 填充数量
  */
-void shellDeleteByte(Shell *shell, signed char direction)
+static void shellFormatFill(ShellFormatter *formatter, char fill, int count)
 {
-    char offset = (direction == -1) ? 1 : 0;
+    static const char spaces[] = "                ";
+    static const char zeros[] = "0000000000000000";
 
-    if ((shell->parser.cursor == 0 && direction == 1)
-        || (shell->parser.cursor == shell->parser.length && direction == -1))
-    {
-        return;
-    }
-    if (shell->parser.cursor == shell->parser.length && direction == 1)
+    while (count > 0)
     {
-        shell->parser.cursor--;
-        shell->parser.length--;
-        shell->parser.buffer[shell->parser.length] = 0;
-        shellDeleteCommandLine(shell, 1);
-    }
-    else
-    {
-        for (short i = offset; i < shell->parser.length - shell->parser.cursor; i++)
-        {
-            shell->parser.buffer[shell->parser.cursor + i - 1] = 
-                shell->parser.buffer[shell->parser.cursor + i];
-        }
-        shell->parser.length--;
-        if (!offset)
-        {
-            shell->parser.cursor--;
-            shellWriteByte(shell, '\b');
-        }
-        shell->parser.buffer[shell->parser.length] = 0;
-        for (short i = shell->parser.cursor; i < shell->parser.length; i++)
-        {
-            shellWriteByte(shell, shell->parser.buffer[i]);
-        }
-        shellWriteByte(shell, ' ');
-        for (short i = shell->parser.length - shell->parser.cursor + 1; i > 0; i--)
-        {
-            shellWriteByte(shell, '\b');
-        }
+        shellFormatPut(formatter, fill == '0' ? zeros : spaces, count > 16 ? 16 : count);
+        count -= 16;
     }
 }
 
 
 /**
- * @brief shell 字符串分割
- * 
- * @param string 字符串
- * @param array 分割后保存的字符串数组
- * @param splitKey 分隔符
- * @param maxNum 最大分割数量
+ * @brief shell格式化输出字段头部
+ *        按照宽度输出左侧空格，前缀(符号，进制)和补0
  * 
- * @return int 分割得到的字串数量
+ * @param formatter 格式化输出状态
+ * @param prefix 前缀
+ * @param length 字段长度，包含前缀
  */
-int shellSplit(char *string, unsigned short strLen, char *array[], char splitKey, short maxNum)
+static void shellFormatHead(ShellFormatter *formatter, const char *prefix, int length)
 {
-    unsigned char record = 1;
-    unsigned char pairedLeft[16] = {0};
-    unsigned char pariedCount = 0;
-    int count = 0;
+    int pad = formatter->width > length ? formatter->width - length : 0;
 
-    for (short i = 0; i < maxNum; i++)
+    if (!(formatter->flags & (SHELL_FORMAT_LEFT | SHELL_FORMAT_ZERO)))
     {
-        array[i] = NULL;
+        shellFormatFill(formatter, ' ', pad);
     }
-
-    for (unsigned short i = 0; i < strLen; i++)
+    shellFormatPut(formatter, prefix, strlen(prefix));
+    if ((formatter->flags & (SHELL_FORMAT_LEFT | SHELL_FORMAT_ZERO)) == SHELL_FORMAT_ZERO)
     {
-        if (pariedCount == 0)
-        {
-            if (string[i] != splitKey && record == 1 && count < maxNum)
-            {
-                array[count++] = &(string[i]);
-                record = 0;
-            }
-            else if ((string[i] == splitKey || string[i] == ' ') && record == 0)
-            {
-                string[i] = 0;
-                if (string[i + 1] != ' ')
-                {
-                    record = 1;
-                }
-                continue;
-            }
-        }
-
-        for (unsigned char j = 0; j < sizeof(pairedChars) / 2; j++)
-        {
-            if (pariedCount > 0
-                && string[i] == pairedChars[j][1]
-                && pairedLeft[pariedCount - 1] == pairedChars[j][0])
-            {
-                --pariedCount;
-                break;
-            }
-            else if (string[i] == pairedChars[j][0])
-            {
-                pairedLeft[pariedCount++] = pairedChars[j][0];
-                pariedCount &= 0x0F;
-                break;
-            }
-        }
-        
-        if (string[i] == '\\' && string[i + 1] != 0)
-        {
-            i++;
-        }
+        shellFormatFill(formatter, '0', pad);
     }
-    return count;
 }
 
 
 /**
- * @brief shell 解析参数
+ * @brief shell格式化输出字段尾部
+ *        左对齐时输出右侧空格
  * 
- * @param shell shell对象
+ * @param formatter 格式化输出状态
+ * @param length 字段长度
  */
-static void shellParserParam(Shell *shell)
+static void shellFormatTail(ShellFormatter *formatter, int length)
 {
-    shell->parser.paramCount = 
-        shellSplit(shell->parser.buffer, shell->parser.length, 
-                   shell->parser.param, ' ', SHELL_PARAMETER_MAX_NUMBER);
+    if ((formatter->flags & SHELL_FORMAT_LEFT) && formatter->width > length)
+    {
+        shellFormatFill(formatter, ' ', formatter->width - length);
+    }
 }
 
 
 /**
- * @brief shell去除字符串参数头尾的双引号
+ * @brief shell格式化输出整数
  * 
- * @param shell shell对象
+ * @param formatter 格式化输出状态
+ * @param value 绝对值
+ * @param negative 是否为负数
+ * @param conversion 转换字符 `d` `u` `o` `x` `X` `p`
  */
-static void shellRemoveParamQuotes(Shell *shell)
+static void shellFormatInteger(ShellFormatter *formatter, unsigned long long value,
+                               char negative, char conversion)
 {
-    unsigned short paramLength;
-    for (unsigned short i = 0; i < shell->parser.paramCount; i++)
+    char buffer[24];
+    char prefix[4] = {0};
+    char *end = buffer + sizeof(buffer);
+    char *start = end;
+    unsigned char index = 0;
+    int zeros = 0;
+    int digits;
+
+    if (negative)
     {
-        if (shell->parser.param[i][0] == '\"')
-        {
-            shell->parser.param[i][0] = 0;
-            shell->parser.param[i] = &shell->parser.param[i][1];
-        }
-        paramLength = strlen(shell->parser.param[i]);
-        if (shell->parser.param[i][paramLength - 1] == '\"')
+        prefix[index++] = '-';
+    }
+    else if (formatter->flags & SHELL_FORMAT_PLUS)
+    {
+        prefix[index++] = '+';
+    }
+    else if (formatter->flags & SHELL_FORMAT_SPACE)
+    {
+        prefix[index++] = ' ';
+    }
+    if (value != 0 || formatter->precision != 0)
+    {
+        switch (conversion)
         {
-            shell->parser.param[i][paramLength - 1] = 0;
+        case 'o':
+            start = shellFormatRadix(value, end, 3, shellHexDigits);
+            break;
+        case 'x':
+        case 'p':
+            start = shellFormatRadix(value, end, 4, shellHexDigits);
+            break;
+        case 'X':
+            start = shellFormatRadix(value, end, 4, shellHexDigits + 16);
+            break;
+        default:
+            start = shellFormatDec(value, end);
+            break;
         }
     }
+    digits = end - start;
+    if (formatter->precision > digits)
+    {
+        zeros = formatter->precision - digits;
+    }
+    if (conversion == 'p'
+        || ((formatter->flags & SHELL_FORMAT_ALT)
+            && (conversion == 'x' || conversion == 'X') && value != 0))
+    {
+        prefix[index++] = '0';
+        prefix[index++] = conversion == 'X' ? 'X' : 'x';
+    }
+    else if ((formatter->flags & SHELL_FORMAT_ALT) && conversion == 'o'
+             && zeros == 0 && (digits == 0 || *start != '0'))
+    {
+        zeros = 1;
+    }
+    shellFormatHead(formatter, prefix, index + zeros + digits);
+    shellFormatFill(formatter, '0', zeros);
+    shellFormatPut(formatter, start, digits);
+    shellFormatTail(formatter, index + zeros + digits);
 }
 
 
 /**
- * @brief shell匹配命令
+ * @brief shell格式化输出字符串
  * 
- * @param shell shell对象
- * @param cmd 命令
- * @param base 匹配命令表基址
- * @param compareLength 匹配字符串长度
- * @return ShellCommand* 匹配到的命令
+ * @param formatter 格式化输出状态
+ * @param string 字符串
+ * @param length 字符串长度
  */
-ShellCommand* shellSeekCommand(Shell *shell,
-                               const char *cmd,
-                               ShellCommand *base,
-                               unsigned short compareLength)
+static void shellFormatText(ShellFormatter *formatter, const char *string, size_t length)
 {
-    const char *name;
-    unsigned short count = shell->commandList.count -
-        ((size_t)base - (size_t)shell->commandList.base) / sizeof(ShellCommand);
-    for (unsigned short i = 0; i < count; i++)
+    formatter->flags &= ~SHELL_FORMAT_ZERO;
+    shellFormatHead(formatter, "", length);
+    shellFormatPut(formatter, string, length);
+    shellFormatTail(formatter, length);
+}
+
+
+#if SHELL_PRINT_FLOAT == 1
+/**
+ * @brief 浮点数转换的有效数字位数
+ */
+#define     SHELL_FORMAT_DIGITS     17
+
+/**
+ * @brief 浮点数精确转换使用的32位大整数字数，可以容纳最小的非规格化数按照完整尾数缩放后的二进制小数
+ */
+#define     SHELL_FORMAT_WORDS      ((DBL_MANT_DIG * 2 - DBL_MIN_EXP + 32) / 32)
+
+/**
+ * @brief 追加一段10进制数字到有效数字
+ *        跳过第一个非0数字之前的0，已经有`SHELL_FORMAT_DIGITS + 1`位时只记录后面是否有非0数字
+ * 
+ * @param digits 有效数字
+ * @param count 已有的有效数字位数
+ * @param sticky 舍去的数字是否非0
+ * @param text 数字
+ * @param length 数字位数
+ * 
+ * @return int 跳过的0的位数
+ */
+static int shellFormatAppend(char *digits, int *count, char *sticky,
+                             const char *text, int length)
+{
+    int skipped = 0;
+
+    for (int i = 0; i < length; i++)
     {
-        if (base[i].attr.attrs.type == SHELL_TYPE_KEY
-            || shellCheckPermission(shell, &base[i]) != 0)
+        if (*count == 0 && text[i] == '0')
         {
-            continue;
+            skipped++;
         }
-        name = shellGetCommandName(&base[i]);
-        if (!compareLength)
+        else if (*count <= SHELL_FORMAT_DIGITS)
         {
-            if (strcmp(cmd, name) == 0)
-            {
-                return &base[i];
-            }
+            digits[(*count)++] = text[i];
         }
-        else
+        else if (text[i] != '0')
         {
-            if (strncmp(cmd, name, compareLength) == 0)
-            {
-                return &base[i];
-            }
+            *sticky = 1;
         }
     }
-    return NULL;
+    return skipped;
 }
 
 
 /**
- * @brief shell 获取变量值
+ * @brief 9位10进制数字块转字符串，不足9位时前面补0
  * 
- * @param shell shell对象
- * @param command 命令
- * @return int 变量值
+ * @param chunk 数字块
+ * @param text 字符串，长度为9
  */
-int shellGetVarValue(Shell *shell, ShellCommand *command)
+static void shellFormatChunk(unsigned int chunk, char *text)
 {
-    int value = 0;
-    switch (command->attr.attrs.type)
+    char *start = shellFormatDec(chunk, text + 9);
+
+    memset(text, '0', start - text);
+}
+
+
+/**
+ * @brief 浮点数转换为有效数字
+ *        按照2的幂次方缩放得到整数尾数和2进制指数，再用大整数精确计算10进制数字，
+ *        得到`SHELL_FORMAT_DIGITS + 1`位有效数字，之后的数字只记录是否非0，用于正确舍入
+ * 
+ * @param value 数值，非负有限值
+ * @param digits 有效数字，长度为`SHELL_FORMAT_DIGITS + 1`
+ * @param sticky 有效数字之后的数字是否非0
+ * 
+ * @return int 10进制指数
+ */
+static int shellFormatDigits(double value, char *digits, char *sticky)
+{
+    const double high = (double)(1ULL << (DBL_MANT_DIG - 1));
+    unsigned int words[SHELL_FORMAT_WORDS] = {0};
+    unsigned int chunks[3];
+    unsigned long long mantissa;
+    unsigned long long carry;
+    char text[20];
+    char *start;
+    int binary = 0;
+    int size;
+    int n;
+    int count = 0;
+    int length = 0;
+    int skipped;
+    int i;
+
+    *sticky = 0;
+    memset(digits, '0', SHELL_FORMAT_DIGITS + 1);
+    if (value == 0)
     {
-    case SHELL_TYPE_VAR_INT:
-        value = *((int *)(command->data.var.value));
-        break;
-    case SHELL_TYPE_VAR_SHORT:
-        value = *((short *)(command->data.var.value));
-        break;
-    case SHELL_TYPE_VAR_CHAR:
-        value = *((char *)(command->data.var.value));
-        break;
-    case SHELL_TYPE_VAR_STRING:
-    case SHELL_TYPE_VAR_POINT:
-        value = (size_t)(command->data.var.value);
-        break;
-    case SHELL_TYPE_VAR_NODE: {
-      int (*func)(void *) =
-          (int (*)(void *))((ShellNodeVarAttr *)command->data.var.value)->get;
-        value = func ? func(((ShellNodeVarAttr *)command->data.var.value)->var) : 0;
-        break;
+        return 0;
     }
-    default:
-        break;
+    while (value >= high * 8589934592.0)
+    {
+        value *= 1.0 / 4294967296.0;
+        binary += 32;
     }
-    return value;
+    while (value >= high * 2)
+    {
+        value *= 0.5;
+        binary++;
+    }
+    while (value * 4294967296.0 < high)
+    {
+        value *= 4294967296.0;
+        binary -= 32;
+    }
+    while (value < high)
+    {
+        value *= 2;
+        binary--;
+    }
+    mantissa = (unsigned long long)value;
+
+    if (binary >= 0)
+    {
+        /* 整数: mantissa << binary，每次除以10^9，保留最高的三块，更低的块只记录是否非0 */
+        words[binary / 32] = (unsigned int)(mantissa << (binary % 32));
+        words[binary / 32 + 1] = (unsigned int)((mantissa << (binary % 32)) >> 32);
+        words[binary / 32 + 2] = binary % 32 ? (unsigned int)(mantissa >> (64 - binary % 32)) : 0;
+        for (size = binary / 32 + 3; size > 0 && words[size - 1] == 0; size--)
+        {
+        }
+        for (n = 0; size > 0; n++)
+        {
+            carry = 0;
+            for (i = size - 1; i >= 0; i--)
+            {
+                carry = (carry << 32) | words[i];
+                words[i] = (unsigned int)(carry / 1000000000u);
+                carry %= 1000000000u;
+            }
+            while (size > 0 && words[size - 1] == 0)
+            {
+                size--;
+            }
+            if (n >= 3 && chunks[n % 3] != 0)
+            {
+                *sticky = 1;
+            }
+            chunks[n % 3] = (unsigned int)carry;
+        }
+        start = shellFormatDec(chunks[(n - 1) % 3], text + 9);
+        length = text + 9 - start;
+        shellFormatAppend(digits, &count, sticky, start, length);
+        for (i = n - 2; i >= 0 && i >= n - 3; i--)
+        {
+            shellFormatChunk(chunks[i % 3], text);
+            shellFormatAppend(digits, &count, sticky, text, 9);
+        }
+        return length + 9 * (n - 1) - 1;
+    }
+
+    /* 整数部分直接转换，小数部分左对齐到字边界，每次乘以10^9得到9位数字 */
+    binary = -binary;
+    if (binary < 64 && (mantissa >> binary) > 0)
+    {
+        start = shellFormatDec(mantissa >> binary, text + sizeof(text));
+        length = text + sizeof(text) - start;
+        shellFormatAppend(digits, &count, sticky, start, length);
+        mantissa &= (1ULL << binary) - 1;
+    }
+    size = (binary + 31) / 32;
+    words[0] = (unsigned int)(mantissa << (size * 32 - binary));
+    words[1] = (unsigned int)((mantissa << (size * 32 - binary)) >> 32);
+    words[2] = size * 32 - binary ? (unsigned int)(mantissa >> (64 - (size * 32 - binary))) : 0;
+    skipped = 0;
+    while (count <= SHELL_FORMAT_DIGITS)
+    {
+        carry = 0;
+        for (i = 0; i < size; i++)
+        {
+            carry += (unsigned long long)words[i] * 1000000000u;
+            words[i] = (unsigned int)carry;
+            carry >>= 32;
+        }
+        shellFormatChunk((unsigned int)carry, text);
+        skipped += shellFormatAppend(digits, &count, sticky, text, 9);
+        for (i = 0; i < size && words[i] == 0; i++)
+        {
+        }
+        if (i == size)
+        {
+            break;
+        }
+    }
+    for (i = 0; i < size; i++)
+    {
+        if (words[i] != 0)
+        {
+            *sticky = 1;
+        }
+    }
+    return length - 1 - skipped;
 }
 
 
 /**
- * @brief shell设置变量值
+ * @brief 有效数字舍入
+ *        按照精确值舍入，正好在中间时舍入到偶数，和C库默认的舍入方式相同，
+ *        最多保留`SHELL_FORMAT_DIGITS`位有效数字
  * 
- * @param shell shell对象
- * @param command 命令
- * @param value 值
- * @return int 返回变量值
+ * @param digits 有效数字
+ * @param count 保留的位数
+ * @param sticky 有效数字之后的数字是否非0
+ * 
+ * @return int 进位时返回1，指数需要加1
  */
-int shellSetVarValue(Shell *shell, ShellCommand *command, int value)
+static int shellFormatRound(char *digits, int count, char sticky)
 {
-    if (command->attr.attrs.readOnly)
+    char up;
+    int i;
+
+    if (count > SHELL_FORMAT_DIGITS)
     {
-        shellWriteString(shell, shellText[SHELL_TEXT_VAR_READ_ONLY_CANNOT_MODIFY]);
+        count = SHELL_FORMAT_DIGITS;
+    }
+    if (count < 0)
+    {
+        memset(digits, '0', SHELL_FORMAT_DIGITS + 1);
+        return 0;
+    }
+    up = digits[count] > '5';
+    if (digits[count] == '5')
+    {
+        for (i = count + 1; i <= SHELL_FORMAT_DIGITS && digits[i] == '0'; i++)
+        {
+        }
+        up = sticky || i <= SHELL_FORMAT_DIGITS || (count > 0 && (digits[count - 1] & 1));
+    }
+    memset(digits + count, '0', SHELL_FORMAT_DIGITS + 1 - count);
+    if (up)
+    {
+        for (i = count - 1; i >= 0 && digits[i] == '9'; i--)
+        {
+            digits[i] = '0';
+        }
+        if (i < 0)
+        {
+            digits[0] = '1';
+            return 1;
+        }
+        digits[i]++;
+    }
+    return 0;
+}
+
+
+/**
+ * @brief 输出有效数字
+ *        超出有效数字范围的位置输出0
+ * 
+ * @param formatter 格式化输出状态
+ * @param digits 有效数字
+ * @param start 起始位置
+ * @param count 输出位数
+ */
+static void shellFormatDigitRun(ShellFormatter *formatter, const char *digits, int start, int count)
+{
+    int run;
+
+    if (start < 0 && count > 0)
+    {
+        run = -start < count ? -start : count;
+        shellFormatFill(formatter, '0', run);
+        start += run;
+        count -= run;
+    }
+    if (start < SHELL_FORMAT_DIGITS && count > 0)
+    {
+        run = SHELL_FORMAT_DIGITS - start < count ? SHELL_FORMAT_DIGITS - start : count;
+        shellFormatPut(formatter, digits + start, run);
+        count -= run;
+    }
+    shellFormatFill(formatter, '0', count);
+}
+
+
+/**
+ * @brief 按照小数形式输出浮点数 `%f`
+ * 
+ * @param formatter 格式化输出状态
+ * @param prefix 符号
+ * @param digits 已舍入的有效数字
+ * @param exponent 10进制指数
+ * @param precision 小数位数
+ */
+static void shellFormatFixed(ShellFormatter *formatter, const char *prefix,
+                             const char *digits, int exponent, int precision)
+{
+    int dot = precision > 0 || (formatter->flags & SHELL_FORMAT_ALT);
+    int length = strlen(prefix) + (exponent >= 0 ? exponent + 1 : 1) + dot + precision;
+
+    shellFormatHead(formatter, prefix, length);
+    if (exponent >= 0)
+    {
+        shellFormatDigitRun(formatter, digits, 0, exponent + 1);
     }
     else
     {
-        switch (command->attr.attrs.type)
+        shellFormatPut(formatter, "0", 1);
+    }
+    shellFormatPut(formatter, ".", dot);
+    shellFormatDigitRun(formatter, digits, exponent + 1, precision);
+    shellFormatTail(formatter, length);
+}
+
+
+/**
+ * @brief 按照指数形式输出浮点数 `%e`
+ * 
+ * @param formatter 格式化输出状态
+ * @param prefix 符号
+ * @param digits 已舍入的有效数字
+ * @param exponent 10进制指数
+ * @param precision 小数位数
+ * @param e 指数字符 `e` 或 `E`
+ */
+static void shellFormatExp(ShellFormatter *formatter, const char *prefix,
+                           const char *digits, int exponent, int precision, char e)
+{
+    char buffer[8];
+    char *end = buffer + sizeof(buffer);
+    char *start = shellFormatDec(exponent < 0 ? -exponent : exponent, end);
+    int dot = precision > 0 || (formatter->flags & SHELL_FORMAT_ALT);
+    int length;
+
+    if (end - start < 2)
+    {
+        *--start = '0';
+    }
+    *--start = exponent < 0 ? '-' : '+';
+    *--start = e;
+    length = strlen(prefix) + 1 + dot + precision + (end - start);
+    shellFormatHead(formatter, prefix, length);
+    shellFormatDigitRun(formatter, digits, 0, 1);
+    shellFormatPut(formatter, ".", dot);
+    shellFormatDigitRun(formatter, digits, 1, precision);
+    shellFormatPut(formatter, start, end - start);
+    shellFormatTail(formatter, length);
+}
+
+
+/**
+ * @brief shell格式化输出浮点数
+ *        按照精确值转换和舍入，最多输出17位有效数字，更多的位数输出0，C库会输出完整的精确值
+ * 
+ * @param formatter 格式化输出状态
+ * @param value 数值
+ * @param conversion 转换字符 `f` `e` `g` 及其大写
+ */
+static void shellFormatFloat(ShellFormatter *formatter, double value, char conversion)
+{
+    char digits[SHELL_FORMAT_DIGITS + 1];
+    char sticky;
+    char prefix[2] = {0};
+    char upper = conversion >= 'A' && conversion <= 'Z';
+    int precision = formatter->precision < 0 ? 6 : formatter->precision;
+    int exponent;
+    int last;
+
+    if (value < 0)
+    {
+        prefix[0] = '-';
+        value = -value;
+    }
+    else if (formatter->flags & SHELL_FORMAT_PLUS)
+    {
+        prefix[0] = '+';
+    }
+    else if (formatter->flags & SHELL_FORMAT_SPACE)
+    {
+        prefix[0] = ' ';
+    }
+    if (value != value || value - value != 0)
+    {
+        formatter->flags &= ~SHELL_FORMAT_ZERO;
+        shellFormatHead(formatter, prefix, strlen(prefix) + 3);
+        shellFormatPut(formatter, value != value ? (upper ? "NAN" : "nan") : (upper ? "INF" : "inf"), 3);
+        shellFormatTail(formatter, strlen(prefix) + 3);
+        return;
+    }
+    exponent = shellFormatDigits(value, digits, &sticky);
+    switch (conversion | 0x20)
+    {
+    case 'f':
+        exponent += shellFormatRound(digits, exponent + 1 + precision, sticky);
+        shellFormatFixed(formatter, prefix, digits, exponent, precision);
+        break;
+    case 'e':
+        exponent += shellFormatRound(digits, precision + 1, sticky);
+        shellFormatExp(formatter, prefix, digits, exponent, precision, upper ? 'E' : 'e');
+        break;
+    default:
+        precision = precision == 0 ? 1 : precision;
+        exponent += shellFormatRound(digits, precision, sticky);
+        last = precision;
+        if (!(formatter->flags & SHELL_FORMAT_ALT))
+        {
+            last = last > SHELL_FORMAT_DIGITS ? SHELL_FORMAT_DIGITS : last;
+            while (last > 1 && digits[last - 1] == '0')
+            {
+                last--;
+            }
+        }
+        if (exponent >= -4 && exponent < precision)
+        {
+            shellFormatFixed(formatter, prefix, digits, exponent,
+                             last - 1 - exponent > 0 ? last - 1 - exponent : 0);
+        }
+        else
+        {
+            shellFormatExp(formatter, prefix, digits, exponent, last - 1, upper ? 'E' : 'e');
+        }
+        break;
+    }
+}
+#endif /** SHELL_PRINT_FLOAT == 1 */
+
+
+/**
+ * @brief shell格式化
+ *        格式化结果分段交给输出函数，不使用格式化缓冲，输出长度不受限制
+ *        支持标志`-+ #0`，宽度，精度(包括`*`)，长度修饰`hh h l ll j z t L`，
+ *        转换`d i u o x X c s p f F e E g G %`，不支持的转换原样输出
+ * 
+ * @param write 输出函数
+ * @param context 输出函数上下文
+ * @param fmt 格式化字符串
+ * @param vargs 参数
+ * 
+ * @return int 输出的字符数
+ */
+int shellFormat(ShellFormatWrite write, void *context, const char *fmt, va_list vargs)
+{
+    ShellFormatter formatter = {write, context, 0, 0, 0, -1};
+    const char *p;
+    char size;
+
+    while (*fmt)
+    {
+        for (p = fmt; *p && *p != '%'; p++)
+        {
+        }
+        shellFormatPut(&formatter, fmt, p - fmt);
+        if (*p == 0)
         {
-        case SHELL_TYPE_VAR_INT:
-            *((int *)(command->data.var.value)) = value;
-            break;
-        case SHELL_TYPE_VAR_SHORT:
-            *((short *)(command->data.var.value)) = value;
             break;
-        case SHELL_TYPE_VAR_CHAR:
-            *((char *)(command->data.var.value)) = value;
+        }
+        fmt = p++;
+
+        formatter.flags = 0;
+        formatter.width = 0;
+        formatter.precision = -1;
+        for (;; p++)
+        {
+            if (*p == '-')
+            {
+                formatter.flags |= SHELL_FORMAT_LEFT;
+            }
+            else if (*p == '+')
+            {
+                formatter.flags |= SHELL_FORMAT_PLUS;
+            }
+            else if (*p == ' ')
+            {
+                formatter.flags |= SHELL_FORMAT_SPACE;
+            }
+            else if (*p == '#')
+            {
+                formatter.flags |= SHELL_FORMAT_ALT;
+            }
+            else if (*p == '0')
+            {
+                formatter.flags |= SHELL_FORMAT_ZERO;
+            }
+            else
+            {
+                break;
+            }
+        }
+        if (*p == '*')
+        {
+            formatter.width = va_arg(vargs, int);
+            if (formatter.width < 0)
+            {
+                formatter.flags |= SHELL_FORMAT_LEFT;
+                formatter.width = -formatter.width;
+            }
+            p++;
+        }
+        while (*p >= '0' && *p <= '9')
+        {
+            formatter.width = formatter.width * 10 + (*p++ - '0');
+        }
+        if (*p == '.')
+        {
+            formatter.precision = 0;
+            if (*++p == '*')
+            {
+                formatter.precision = va_arg(vargs, int);
+                formatter.precision = formatter.precision < 0 ? -1 : formatter.precision;
+                p++;
+            }
+            while (*p >= '0' && *p <= '9')
+            {
+                formatter.precision = formatter.precision * 10 + (*p++ - '0');
+            }
+        }
+
+        size = 0;
+        switch (*p)
+        {
+        case 'h':
+            size = (*++p == 'h') ? (p++, 'H') : 'h';
             break;
-        case SHELL_TYPE_VAR_STRING:
-            shellStringCopy(((char *)(command->data.var.value)), (char *) (size_t) value);
+        case 'l':
+            size = (*++p == 'l') ? (p++, 'q') : 'l';
             break;
-        case SHELL_TYPE_VAR_POINT:
-            shellWriteString(shell, shellText[SHELL_TEXT_POINT_CANNOT_MODIFY]);
+        case 'j':
+            size = 'q';
+            p++;
             break;
-        case SHELL_TYPE_VAR_NODE:
-            if (((ShellNodeVarAttr *)command->data.var.value)->set)
-            {
-                if (((ShellNodeVarAttr *)command->data.var.value)->var)
-                {
-                    int (*func)(void *, int) = (int (*)(void *, int))((ShellNodeVarAttr *)command->data.var.value)->set;
-                    func(((ShellNodeVarAttr *)command->data.var.value)->var, value);
-                }
-                else
-                {
-                  int (*func)(int) = (int (*)(
-                      int))((ShellNodeVarAttr *)command->data.var.value)->set;
-                    func(value);
-                }
-            }
+        case 'z':
+        case 't':
+        case 'L':
+            size = *p++;
             break;
         default:
             break;
         }
-    }
-    return shellShowVar(shell, command);
-}
 
+        switch (*p)
+        {
+        case 'd':
+        case 'i':
+        {
+            long long value;
+            if (size == 'q')
+            {
+                value = va_arg(vargs, long long);
+            }
+            else if (size == 'l')
+            {
+                value = va_arg(vargs, long);
+            }
+            else if (size == 'z' || size == 't')
+            {
+                value = va_arg(vargs, ptrdiff_t);
+            }
+            else
+            {
+                value = va_arg(vargs, int);
+                value = size == 'H' ? (signed char)value : size == 'h' ? (short)value : value;
+            }
+            if (formatter.precision >= 0)
+            {
+                formatter.flags &= ~SHELL_FORMAT_ZERO;
+            }
+            shellFormatInteger(&formatter,
+                               value < 0 ? 0 - (unsigned long long)value : (unsigned long long)value,
+                               value < 0, 'd');
+            break;
+        }
+        case 'u':
+        case 'o':
+        case 'x':
+        case 'X':
+        case 'p':
+        {
+            unsigned long long value;
+            if (*p == 'p')
+            {
+                value = (size_t)va_arg(vargs, void *);
+            }
+            else if (size == 'q')
+            {
+                value = va_arg(vargs, unsigned long long);
+            }
+            else if (size == 'l')
+            {
+                value = va_arg(vargs, unsigned long);
+            }
+            else if (size == 'z' || size == 't')
+            {
+                value = va_arg(vargs, size_t);
+            }
+            else
+            {
+                value = va_arg(vargs, unsigned int);
+                value = size == 'H' ? (unsigned char)value : size == 'h' ? (unsigned short)value : value;
+            }
+            formatter.flags &= ~(SHELL_FORMAT_PLUS | SHELL_FORMAT_SPACE);
+            if (formatter.precision >= 0)
+            {
+                formatter.flags &= ~SHELL_FORMAT_ZERO;
+            }
+            shellFormatInteger(&formatter, value, 0, *p);
+            break;
+        }
+        case 'c':
+        {
+            char value = (char)va_arg(vargs, int);
+            shellFormatText(&formatter, &value, 1);
+            break;
+        }
+        case 's':
+        {
+            const char *value = va_arg(vargs, const char *);
+            size_t length = 0;
+            value = value ? value : "(null)";
+            while (value[length] && (formatter.precision < 0 || length < (size_t)formatter.precision))
+            {
+                length++;
+            }
+            shellFormatText(&formatter, value, length);
+            break;
+        }
+        case 'f':
+        case 'F':
+        case 'e':
+        case 'E':
+        case 'g':
+        case 'G':
+        {
+            double value = size == 'L' ? (double)va_arg(vargs, long double) : va_arg(vargs, double);
+        #if SHELL_PRINT_FLOAT == 1
+            shellFormatFloat(&formatter, value, *p);
+        #else
+            (void)value;
+            shellFormatPut(&formatter, fmt, p + 1 - fmt);
+        #endif
+            break;
+        }
+        case '%':
+            shellFormatPut(&formatter, "%", 1);
+            break;
+        default:
+            shellFormatPut(&formatter, fmt, p - fmt + (*p != 0));
+            break;
+        }
+        fmt = *p ? p + 1 : p;
+    }
+    return formatter.count;
+}
+
+
+#if SHELL_PRINT_BUFFER > 0
+#if SHELL_WRITE_BUFFER == 0
+/**
+ * @brief shell格式化输出分块
+ */
+typedef struct
+{
+    Shell *shell;                                       /**< shell对象 */
+    unsigned short length;                              /**< 分块中的数据长度 */
+    char buffer[SHELL_PRINT_BUFFER];                    /**< 分块缓冲 */
+} ShellPrintChunk;
+#endif /** SHELL_WRITE_BUFFER == 0 */
+
+
+/**
+ * @brief shell格式化输出写数据(调用者持有输出锁)
+ *        使用输出缓冲时直接写入输出缓冲，否则按照`SHELL_PRINT_BUFFER`分块输出
+ * 
+ * @param context shell对象或者输出分块
+ * @param data 数据
+ * @param len 数据长度
+ */
+static void shellPrintWrite(void *context, const char *data, unsigned short len)
+{
+#if SHELL_WRITE_BUFFER > 0
+    shellPutData((Shell *)context, data, len);
+#else
+    ShellPrintChunk *chunk = (ShellPrintChunk *)context;
+    unsigned short count;
+
+    while (len > 0)
+    {
+        if (chunk->length == 0 && len >= SHELL_PRINT_BUFFER)
+        {
+            shellPutRaw(chunk->shell, data, len);
+            break;
+        }
+        count = SHELL_PRINT_BUFFER - chunk->length;
+        count = count > len ? len : count;
+        memcpy(chunk->buffer + chunk->length, data, count);
+        chunk->length += count;
+        data += count;
+        len -= count;
+        if (chunk->length == SHELL_PRINT_BUFFER)
+        {
+            shellPutRaw(chunk->shell, chunk->buffer, chunk->length);
+            chunk->length = 0;
+        }
+    }
+#endif
+}
+
+
+/**
+ * @brief shell格式化输出
+ *        格式化结果直接写入shell输出，输出长度不受限制
+ * 
+ * @param shell shell对象
+ * @param fmt 格式化字符串
+ * @param ... 参数
+ */
+void shellPrint(Shell *shell, const char *fmt, ...)
+{
+    va_list vargs;
+
+    SHELL_ASSERT(shell, return);
+
+    va_start(vargs, fmt);
+    shellWriteLock(shell);
+#if SHELL_WRITE_BUFFER > 0
+    shellFormat(shellPrintWrite, shell, fmt, vargs);
+#else
+    ShellPrintChunk chunk;
+    chunk.shell = shell;
+    chunk.length = 0;
+    shellFormat(shellPrintWrite, &chunk, fmt, vargs);
+    if (chunk.length > 0)
+    {
+        shellPutRaw(shell, chunk.buffer, chunk.length);
+    }
+#endif
+    shellWriteUnlock(shell);
+    va_end(vargs);
+}
+#endif
+
+
+#if SHELL_SCAN_BUFFER > 0
+/**
+ * @brief shell格式化输入
+ * 
+ * @param shell shell对象
+ * @param fmt 格式化字符串
+ * @param ... 参数
+ */
+void shellScan(Shell *shell, char *fmt, ...)
+{
+    char buffer[SHELL_SCAN_BUFFER];
+    va_list vargs;
+    short index = 0;
+
+    SHELL_ASSERT(shell, return);
+
+    if (shell->read)
+    {
+        shellFlush(shell);
+        do {
+            if (shell->read(&buffer[index], 1) == 1)
+            {
+                shellWriteData(shell, &buffer[index], 1);
+                shellFlush(shell);
+                index++;
+            }
+        } while (buffer[index -1] != '\r' && buffer[index -1] != '\n' && index < SHELL_SCAN_BUFFER);
+        shellWriteString(shell, "\r\n");
+        buffer[index] = '\0';
+    }
+
+    va_start(vargs, fmt);
+    vsscanf(buffer, fmt, vargs);
+    va_end(vargs);
+}
+#endif
+
+
+#if SHELL_CMD_VIEW_NUMBER > 0
+/**
+ * @brief shell 修改命令视图的引用计数
+ * 
+ * @param refs 引用计数
+ * @param delta 增量
+ */
+static void shellCmdViewRef(unsigned int *refs, int delta)
+{
+    unsigned int value = SHELL_ATOMIC_LOAD(refs);
+    while (!SHELL_ATOMIC_CAS(refs, &value, value + delta))
+    {
+    }
+}
+
+
+/**
+ * @brief shell 释放当前用户的命令视图
+ * 
+ * @param shell shell对象
+ */
+static void shellCmdViewRelease(Shell *shell)
+{
+    unsigned char index = shell->info.view;
+
+    shell->info.view = SHELL_CMD_VIEW_NUMBER;
+    if (index < SHELL_CMD_VIEW_NUMBER)
+    {
+        shellCmdViewRef(&shellCmdView.view[index].refs, -1);
+    }
+}
+
+
+/**
+ * @brief shell 选择当前用户的命令视图
+ *        优先使用缓存中权限相同的视图，否则选择一个没有被引用的视图重新建立，
+ *        其他shell正在选择视图或者所有视图都在使用中时，不使用视图
+ * 
+ * @param shell shell对象
+ */
+static void shellCmdViewSelect(Shell *shell)
+{
+    ShellCommand *base = (ShellCommand *)shell->commandList.base;
+    unsigned short count = shell->commandList.count;
+    unsigned char permission = shell->info.user
+                               ? shell->info.user->attr.attrs.permission : 0;
+    unsigned int expected = 0;
+    unsigned char index;
+
+    shellCmdViewRelease(shell);
+    if (count > SHELL_CMD_INDEX_SIZE)
+    {
+        return;
+    }
+    while (!SHELL_ATOMIC_CAS(&shellCmdView.lock, &expected, 1))
+    {
+        if (expected != 0)
+        {
+            return;
+        }
+    }
+    for (index = 0; index < SHELL_CMD_VIEW_NUMBER; index++)
+    {
+        if (shellCmdView.view[index].base == base
+            && shellCmdView.view[index].count == count
+            && shellCmdView.view[index].permission == permission)
+        {
+            break;
+        }
+    }
+    if (index == SHELL_CMD_VIEW_NUMBER)
+    {
+        for (unsigned char i = 0; i < SHELL_CMD_VIEW_NUMBER; i++)
+        {
+            index = (shellCmdView.replace + i) % SHELL_CMD_VIEW_NUMBER;
+            if (SHELL_ATOMIC_LOAD(&shellCmdView.view[index].refs) == 0)
+            {
+                break;
+            }
+            index = SHELL_CMD_VIEW_NUMBER;
+        }
+        if (index == SHELL_CMD_VIEW_NUMBER)
+        {
+            SHELL_ATOMIC_STORE(&shellCmdView.lock, 0);
+            return;
+        }
+        shellCmdView.replace = (index + 1) % SHELL_CMD_VIEW_NUMBER;
+        shellCmdView.view[index].base = NULL;
+        for (unsigned short i = 0; i < (SHELL_CMD_INDEX_SIZE + 31) / 32; i++)
+        {
+            shellCmdView.view[index].checked[i] = 0;
+            shellCmdView.view[index].unchecked[i] = 0;
+        }
+        for (unsigned short i = 0; i < count; i++)
+        {
+            if (!base[i].attr.attrs.permission
+                || base[i].attr.attrs.type == SHELL_TYPE_USER
+                || (base[i].attr.attrs.permission & permission))
+            {
+                shellCmdView.view[index].checked[i >> 5] |= 1u << (i & 0x1F);
+                if (base[i].attr.attrs.enableUnchecked)
+                {
+                    shellCmdView.view[index].unchecked[i >> 5] |= 1u << (i & 0x1F);
+                }
+            }
+        }
+        shellCmdView.view[index].base = base;
+        shellCmdView.view[index].count = count;
+        shellCmdView.view[index].permission = permission;
+    }
+    shellCmdViewRef(&shellCmdView.view[index].refs, 1);
+    SHELL_ATOMIC_STORE(&shellCmdView.lock, 0);
+    shell->info.view = index;
+}
+
+
+/**
+ * @brief shell 获取当前用户的命令视图
+ *        shell持有视图的引用，视图不会被替换，仍然确认视图对应当前的命令表和用户
+ * 
+ * @param shell shell对象
+ * @return unsigned int* 命令访问位图，视图无效时返回NULL
+ */
+static unsigned int* shellCmdViewGet(Shell *shell)
+{
+    if (shell->info.view >= SHELL_CMD_VIEW_NUMBER)
+    {
+        return NULL;
+    }
+    if (shellCmdView.view[shell->info.view].base != shell->commandList.base
+        || shellCmdView.view[shell->info.view].count != shell->commandList.count
+        || shellCmdView.view[shell->info.view].permission
+            != (shell->info.user ? shell->info.user->attr.attrs.permission : 0))
+    {
+        return NULL;
+    }
+    return shell->status.isChecked
+           ? shellCmdView.view[shell->info.view].checked
+           : shellCmdView.view[shell->info.view].unchecked;
+}
+#endif /** SHELL_CMD_VIEW_NUMBER > 0 */
+
+
+/**
+ * @brief shell 检查命令权限
+ * 
+ * @param shell shell对象
+ * @param command ShellCommand
+ * 
+ * @return signed char 0 当前用户具有该命令权限
+ * @return signec char -1 当前用户不具有该命令权限
+ */
+signed char shellCheckPermission(Shell *shell, ShellCommand *command)
+{
+#if SHELL_CMD_VIEW_NUMBER > 0
+    unsigned int *view = shellCmdViewGet(shell);
+    ShellCommand *base = (ShellCommand *)shell->commandList.base;
+    if (view && command >= base && command < base + shell->commandList.count)
+    {
+        return SHELL_CMD_VIEW_TEST(view, command - base) ? 0 : -1;
+    }
+#endif
+    return ((!command->attr.attrs.permission
+                || command->attr.attrs.type == SHELL_TYPE_USER
+                || (shell->info.user
+                    && (command->attr.attrs.permission 
+                        & shell->info.user->attr.attrs.permission)))
+            && (shell->status.isChecked
+                || command->attr.attrs.enableUnchecked))
+            ? 0 : -1;
+}
+
+
+/**
+ * @brief shell 查找下一个当前用户具有权限的命令
+ *        使用命令视图时直接按位图跳过没有权限的命令
+ * 
+ * @param shell shell对象
+ * @param index 开始查找的序号
+ * @return unsigned short 命令序号，没有找到时返回命令数量
+ */
+static unsigned short shellNextCommand(Shell *shell, unsigned short index)
+{
+    ShellCommand *base = (ShellCommand *)shell->commandList.base;
+    unsigned short count = shell->commandList.count;
+#if SHELL_CMD_VIEW_NUMBER > 0
+    unsigned int *view = shellCmdViewGet(shell);
+    unsigned int bits;
+    if (view)
+    {
+        while (index < count)
+        {
+            bits = view[index >> 5] >> (index & 0x1F);
+            if (bits == 0)
+            {
+                index = (index | 0x1F) + 1;
+                continue;
+            }
+            while ((bits & 1) == 0)
+            {
+                bits >>= 1;
+                index++;
+            }
+            return index;
+        }
+        return count;
+    }
+#endif
+    while (index < count && shellCheckPermission(shell, &base[index]) != 0)
+    {
+        index++;
+    }
+    return index;
+}
+
+
+/**
+ * @brief int转16进制字符串
+ * 
+ * @param value 数值
+ * @param buffer 缓冲
+ * 
+ * @return signed char 转换后有效数据长度
+ */
+signed char shellToHex(unsigned int value, char *buffer)
+{
+    unsigned char i = 8;
+    buffer[8] = 0;
+    while (value)
+    {
+        buffer[--i] = shellHexDigits[value & 0x0000000F];
+        value >>= 4;
+    }
+    return 8 - i;
+}
+
+
+/**
+* @brief int转10进制字符串
+ * 
+ * @param value 数值
+ * @param buffer 缓冲
+ * 
+ * @return signed char 转换后有效数据长度
+ */
+signed char shellToDec(int value, char *buffer)
+{
+    char *start;
+    buffer[11] = 0;
+    start = shellFormatDec(value < 0 ? 0 - (unsigned int)value : (unsigned int)value, buffer + 11);
+    if (value < 0)
+    {
+        *--start = '-';
+    }
+    return buffer + 11 - start;
+}
+
+
+/**
+ * @brief shell字符串复制
+ * 
+ * @param dest 目标字符串
+ * @param src 源字符串
+ * @return unsigned short 字符串长度
+ */
+static unsigned short shellStringCopy(char *dest, char* src)
+{
+    unsigned short count = 0;
+    while (*(src + count))
+    {
+        *(dest + count) = *(src + count);
+        count++;
+    }
+    *(dest + count) = 0;
+    return count;
+}
+
+
+/**
+ * @brief shell字符串比较
+ * 
+ * @param dest 目标字符串
+ * @param src 源字符串
+ * @return unsigned short 匹配长度
+ */
+static unsigned short shellStringCompare(char* dest, char *src)
+{
+    unsigned short match = 0;
+    unsigned short i = 0;
+
+    while (*(dest +i) && *(src + i))
+    {
+        if (*(dest + i) != *(src +i))
+        {
+            break;
+        }
+        match ++;
+        i++;
+    }
+    return match;
+}
+
+
+/**
+ * @brief shell获取按键键值
+ *        紧凑命令表中，键值按照从高到低的顺序存放在按键描述之前
+ * 
+ * @param key 按键
+ * @return int 按键键值
+ */
+static int shellGetKeyValue(const ShellCommand *key)
+{
+#if SHELL_CMD_COMPACT == 1
+    const unsigned char *value = (const unsigned char *)key->data.key.desc;
+    return (int)(((unsigned int)value[0] << 24) | ((unsigned int)value[1] << 16)
+                 | ((unsigned int)value[2] << 8) | value[3]);
+#else
+    return key->data.key.value;
+#endif
+}
+
+
+#if SHELL_KEY_TRIE_SIZE > 0
+/**
+ * @brief shell获取按键定义的按键序列
+ * 
+ * @param key 按键
+ * @return const char* 按键序列，使用键值定义的按键返回NULL
+ */
+static const char* shellGetKeySequence(const ShellCommand *key)
+{
+#if SHELL_CMD_COMPACT == 1
+    const char *desc = key->data.key.desc + 4;
+    return shellGetKeyValue(key) == 0 ? desc + strlen(desc) + 1 : NULL;
+#else
+    return key->data.key.sequence;
+#endif
+}
+#endif /** SHELL_KEY_TRIE_SIZE > 0 */
+
+
+/**
+ * @brief shell获取命令名
+ * 
+ * @param command 命令
+ * @return const char* 命令名
+ */
+static const char* shellGetCommandName(ShellCommand *command)
+{
+    static char buffer[9];
+    for (unsigned char i = 0; i < 9; i++)
+    {
+        buffer[i] = '0';
+    }
+    if (command->attr.attrs.type <= SHELL_TYPE_CMD_FUNC)
+    {
+        return command->data.cmd.name;
+    }
+    else if (command->attr.attrs.type <= SHELL_TYPE_VAR_NODE)
+    {
+        return command->data.var.name;
+    }
+    else if (command->attr.attrs.type <= SHELL_TYPE_USER)
+    {
+        return command->data.user.name;
+    }
+#if SHELL_USING_FUNC_SIGNATURE == 1
+    else if (command->attr.attrs.type == SHELL_TYPE_PARAM_PARSER)
+    {
+        return command->data.paramParser.type;
+    }
+#endif
+    else
+    {
+    #if SHELL_KEY_TRIE_SIZE > 0
+        const char *sequence = shellGetKeySequence(command);
+        if (sequence)
+        {
+            unsigned int value = 0;
+            for (unsigned char i = 0; i < 4 && *sequence; i++)
+            {
+                value |= (unsigned int)(unsigned char)(*sequence++) << (24 - i * 8);
+            }
+            shellToHex(value, buffer);
+            return buffer;
+        }
+    #endif
+        shellToHex(shellGetKeyValue(command), buffer);
+        return buffer;
+    }
+}
+
+
+/**
+ * @brief shell获取命令描述
+ * 
+ * @param command 命令
+ * @return const char* 命令描述
+ */
+static const char* shellGetCommandDesc(ShellCommand *command)
+{
+#if SHELL_CMD_COMPACT == 1
+    const char *name;
+    if (command->attr.attrs.type <= SHELL_TYPE_USER)
+    {
+        name = command->data.cmd.name;
+        return name + strlen(name) + 1;
+    }
+    return command->data.key.desc + 4;
+#else
+    if (command->attr.attrs.type <= SHELL_TYPE_CMD_FUNC)
+    {
+        return command->data.cmd.desc;
+    }
+    else if (command->attr.attrs.type <= SHELL_TYPE_VAR_NODE)
+    {
+        return command->data.var.desc;
+    }
+    else if (command->attr.attrs.type <= SHELL_TYPE_USER)
+    {
+        return command->data.user.desc;
+    }
+    else
+    {
+        return command->data.key.desc;
+    }
+#endif
+}
+
+#if SHELL_DESC_STRIP == 1
+/**
+ * @brief shell 写命令描述ID
+ *        描述已经被剥离，输出描述在`shellDesc`段中的偏移作为ID，ID与加载地址和指针宽度无关，
+ *        64位和位置无关的程序同样适用，完整描述的格式为`{desc:ID}`，
+ *        列出命令时只使用描述的第一行，格式为`{brief:ID}`，由主机工具根据描述字典还原
+ * 
+ * @param shell shell对象
+ * @param desc 命令描述
+ * @param brief 是否只使用描述的第一行
+ */
+static void shellWriteDescId(Shell *shell, const char *desc, char brief)
+{
+    char buffer[9] = "00000000";
+    size_t base;
+
+    if (desc == NULL)
+    {
+        return;
+    }
+#if defined(__CC_ARM) || (defined(__ARMCC_VERSION) && __ARMCC_VERSION >= 6000000)
+    base = (size_t)(&shellDesc$$Base);
+#elif defined(__ICCARM__) || defined(__ICCRX__)
+    base = (size_t)(__section_begin("shellDesc"));
+#elif defined(__GNUC__)
+    base = (size_t)(&__start_shellDesc);
+#endif
+    shellToHex((unsigned int)((size_t)desc - base), buffer);
+    shellWriteString(shell, brief ? "{brief:" : "{desc:");
+    shellWriteString(shell, buffer);
+    shellWriteByte(shell, '}');
+}
+#endif /** SHELL_DESC_STRIP == 1 */
+
+
+/**
+ * @brief shell 列出命令条目
+ * 
+ * @param shell shell对象
+ * @param item 命令条目
+ */
+void shellListItem(Shell *shell, ShellCommand *item)
+{
+    short spaceLength;
+
+    spaceLength = 22 - shellWriteString(shell, shellGetCommandName(item));
+    spaceLength = (spaceLength > 0) ? spaceLength : 4;
+    do {
+        shellWriteByte(shell, ' ');
+    } while (--spaceLength);
+    if (item->attr.attrs.type <= SHELL_TYPE_CMD_FUNC)
+    {
+        shellWriteString(shell, shellText[SHELL_TEXT_TYPE_CMD]);
+    }
+    else if (item->attr.attrs.type <= SHELL_TYPE_VAR_NODE)
+    {
+        shellWriteString(shell, shellText[SHELL_TEXT_TYPE_VAR]);
+    }
+    else if (item->attr.attrs.type <= SHELL_TYPE_USER)
+    {
+        shellWriteString(shell, shellText[SHELL_TEXT_TYPE_USER]);
+    }
+    else if (item->attr.attrs.type <= SHELL_TYPE_KEY)
+    {
+        shellWriteString(shell, shellText[SHELL_TEXT_TYPE_KEY]);
+    }
+    else
+    {
+        shellWriteString(shell, shellText[SHELL_TEXT_TYPE_NONE]);
+    }
+#if SHELL_HELP_SHOW_PERMISSION == 1
+    shellWriteString(shell, "  ");
+    for (signed char i = 7; i >= 0; i--)
+    {
+        shellWriteByte(shell, item->attr.attrs.permission & (1 << i) ? 'x' : '-');
+    }
+#endif
+    shellWriteString(shell, "  ");
+#if SHELL_DESC_STRIP == 1
+    shellWriteDescId(shell, shellGetCommandDesc(item), 1);
+#else
+    shellWriteCommandDesc(shell, shellGetCommandDesc(item));
+#endif
+    shellWriteString(shell, "\r\n");
+}
+
+
+#if SHELL_DYNAMIC_CMD_NUMBER > 0
+/**
+ * @brief 动态命令表快照
+ */
+typedef struct
+{
+    unsigned short number;                              /**< 命令表数量 */
+    struct
+    {
+        ShellCommand *base;                             /**< 命令表基址 */
+        unsigned short count;                           /**< 命令数量 */
+    } table[SHELL_DYNAMIC_CMD_NUMBER];                  /**< 命令表 */
+} ShellCmdDynamicTables;
+
+/**
+ * @brief 动态命令表
+ *        注册的命令表在所有shell之间共享，写者复制当前快照，修改后发布，读者不加锁，
+ *        读者进入临界区时在当前计数组中计数，写者发布新快照后切换计数组，等待旧计数组中的读者全部退出，
+ *        所以写者返回后，旧快照和注销的命令表都不会再被使用，读者计数不依赖shell列表
+ */
+static struct
+{
+    ShellCmdDynamicTables snapshot[2];                  /**< 快照 */
+    ShellCmdDynamicTables *current;                     /**< 当前快照，没有注册命令表时为NULL */
+    unsigned int readers[2];                            /**< 两个计数组的读者数量 */
+    unsigned int phase;                                 /**< 新进入的读者使用的计数组 */
+    unsigned int spin;                                  /**< 写者锁 */
+} shellCmdDynamic;
+
+
+/**
+ * @brief shell 修改动态命令表读者计数
+ * 
+ * @param index 计数组
+ * @param delta 增量
+ */
+static void shellCmdDynamicCount(unsigned char index, int delta)
+{
+    unsigned int value = SHELL_ATOMIC_LOAD(&shellCmdDynamic.readers[index]);
+    while (!SHELL_ATOMIC_CAS(&shellCmdDynamic.readers[index], &value, value + delta))
+    {
+    }
+}
+
+
+/**
+ * @brief shell 进入动态命令表读者临界区
+ *        没有注册动态命令表时只读取一次快照指针，不进入临界区，
+ *        快照在进入最外层临界区时获取，整个临界区(包括嵌套的临界区)都使用同一个快照
+ * 
+ * @param shell shell对象
+ * @return ShellCmdDynamicTables* 当前快照，返回NULL时没有进入临界区
+ */
+static ShellCmdDynamicTables* shellCmdDynamicEnter(Shell *shell)
+{
+    ShellCmdDynamicTables *tables;
+    unsigned char index;
+
+    if (shell->dynamic.depth > 0)
+    {
+        shell->dynamic.depth++;
+        return (ShellCmdDynamicTables *)shell->dynamic.tables;
+    }
+    if (SHELL_ATOMIC_LOAD(&shellCmdDynamic.current) == NULL)
+    {
+        return NULL;
+    }
+    while (1)
+    {
+        index = SHELL_ATOMIC_LOAD(&shellCmdDynamic.phase);
+        shellCmdDynamicCount(index, 1);
+        SHELL_ATOMIC_FENCE();
+        if (SHELL_ATOMIC_LOAD(&shellCmdDynamic.phase) == index)
+        {
+            break;
+        }
+        shellCmdDynamicCount(index, -1);
+    }
+    tables = SHELL_ATOMIC_LOAD(&shellCmdDynamic.current);
+    if (tables == NULL)
+    {
+        shellCmdDynamicCount(index, -1);
+        return NULL;
+    }
+    shell->dynamic.tables = tables;
+    shell->dynamic.index = index;
+    shell->dynamic.depth = 1;
+    return tables;
+}
+
+
+/**
+ * @brief shell 退出动态命令表读者临界区
+ * 
+ * @param shell shell对象
+ */
+static void shellCmdDynamicExit(Shell *shell)
+{
+    if (--shell->dynamic.depth == 0)
+    {
+        shell->dynamic.tables = NULL;
+        shellCmdDynamicCount(shell->dynamic.index, -1);
+    }
+}
+
+
+/**
+ * @brief shell 强制退出动态命令表读者临界区
+ *        用于移除在临界区中被终止的shell，不在临界区中时不做处理
+ * 
+ * @param shell shell对象
+ */
+static void shellCmdDynamicRelease(Shell *shell)
+{
+    if (shell->dynamic.depth > 0)
+    {
+        shell->dynamic.depth = 1;
+        shellCmdDynamicExit(shell);
+    }
+}
+
+
+/**
+ * @brief shell 获取动态命令表中的命令
+ *        只在读者临界区中有效，使用进入临界区时获取的快照，动态命令表只支持命令，其他类型的条目会被忽略
+ * 
+ * @param shell shell对象
+ * @param index 命令序号，依次遍历所有动态命令表
+ * @return ShellCommand* 命令，序号超出范围时返回NULL
+ */
+static ShellCommand* shellCmdDynamicGet(Shell *shell, unsigned short index)
+{
+    ShellCmdDynamicTables *tables = (ShellCmdDynamicTables *)shell->dynamic.tables;
+
+    if (shell->dynamic.depth == 0 || tables == NULL)
+    {
+        return NULL;
+    }
+    for (unsigned short i = 0; i < tables->number; i++)
+    {
+        if (index < tables->table[i].count)
+        {
+            return &tables->table[i].base[index];
+        }
+        index -= tables->table[i].count;
+    }
+    return NULL;
+}
+
+
+/**
+ * @brief shell 在动态命令表中匹配命令
+ *        需要在读者临界区中调用，静态命令表中的命令优先
+ * 
+ * @param shell shell对象
+ * @param cmd 命令
+ * @return ShellCommand* 匹配到的命令
+ */
+static ShellCommand* shellCmdDynamicSeek(Shell *shell, const char *cmd)
+{
+    ShellCommand *command;
+
+    for (unsigned short i = 0; (command = shellCmdDynamicGet(shell, i)) != NULL; i++)
+    {
+        if (command->attr.attrs.type <= SHELL_TYPE_CMD_FUNC
+            && shellCheckPermission(shell, command) == 0
+            && strcmp(cmd, shellGetCommandName(command)) == 0)
+        {
+            return command;
+        }
+    }
+    return NULL;
+}
+
+
+/**
+ * @brief shell 发布动态命令表快照并等待宽限期(调用者持有写者锁)
+ *        切换计数组后，新进入的读者只能获取到新的快照，等待旧计数组中的读者全部退出
+ * 
+ * @param tables 新的快照，NULL表示没有注册的命令表
+ */
+static void shellCmdDynamicPublish(ShellCmdDynamicTables *tables)
+{
+    unsigned int phase = shellCmdDynamic.phase;
+
+    SHELL_ATOMIC_STORE(&shellCmdDynamic.current, tables);
+    SHELL_ATOMIC_FENCE();
+    SHELL_ATOMIC_STORE(&shellCmdDynamic.phase, phase ^ 1);
+    SHELL_ATOMIC_FENCE();
+    while (SHELL_ATOMIC_LOAD(&shellCmdDynamic.readers[phase]) != 0)
+    {
+        SHELL_DYNAMIC_CMD_WAIT();
+    }
+}
+
+
+/**
+ * @brief shell 注册命令表
+ *        注册的命令表在所有shell中可用，静态命令表中存在同名命令时，静态命令优先，
+ *        命令表在注销之前需要保持有效，函数返回时，所有shell都可以查找到新的命令
+ * @note 会等待所有shell中正在进行的查找和动态命令执行结束，不能在动态注册的命令中调用
+ * 
+ * @param table 命令表
+ * @param count 命令数量
+ * @return int 0 注册成功 -1 注册失败
+ */
+int shellRegisterCommands(ShellCommand *table, unsigned short count)
+{
+    ShellCmdDynamicTables *current, *next;
+    unsigned int expected = 0;
+    int ret = -1;
+
+    SHELL_ASSERT(table && count, return -1);
+    while (!SHELL_ATOMIC_CAS(&shellCmdDynamic.spin, &expected, 1))
+    {
+        expected = 0;
+        SHELL_DYNAMIC_CMD_WAIT();
+    }
+    current = shellCmdDynamic.current;
+    next = (current == &shellCmdDynamic.snapshot[0])
+        ? &shellCmdDynamic.snapshot[1] : &shellCmdDynamic.snapshot[0];
+    next->number = 0;
+    if (current)
+    {
+        memcpy(next, current, sizeof(ShellCmdDynamicTables));
+    }
+    for (unsigned short i = 0; i < next->number; i++)
+    {
+        if (next->table[i].base == table)
+        {
+            next->number = SHELL_DYNAMIC_CMD_NUMBER;
+            break;
+        }
+    }
+    if (next->number < SHELL_DYNAMIC_CMD_NUMBER)
+    {
+        next->table[next->number].base = table;
+        next->table[next->number].count = count;
+        next->number++;
+        shellCmdDynamicPublish(next);
+        ret = 0;
+    }
+    SHELL_ATOMIC_STORE(&shellCmdDynamic.spin, 0);
+    return ret;
+}
+
+
+/**
+ * @brief shell 注销命令表
+ *        函数返回后，所有shell都不会再使用此命令表，可以释放命令表及其所在的模块
+ * @note 会等待所有shell中正在进行的查找和动态命令执行结束，不能在动态注册的命令中调用
+ * 
+ * @param table 命令表
+ * @return int 0 注销成功 -1 命令表没有注册
+ */
+int shellUnregisterCommands(ShellCommand *table)
+{
+    ShellCmdDynamicTables *current, *next;
+    unsigned int expected = 0;
+    unsigned short index = 0;
+    int ret = -1;
+
+    while (!SHELL_ATOMIC_CAS(&shellCmdDynamic.spin, &expected, 1))
+    {
+        expected = 0;
+        SHELL_DYNAMIC_CMD_WAIT();
+    }
+    current = shellCmdDynamic.current;
+    while (current && index < current->number && current->table[index].base != table)
+    {
+        index++;
+    }
+    if (current && index < current->number)
+    {
+        next = (current == &shellCmdDynamic.snapshot[0])
+            ? &shellCmdDynamic.snapshot[1] : &shellCmdDynamic.snapshot[0];
+        memcpy(next, current, sizeof(ShellCmdDynamicTables));
+        next->number--;
+        memmove(&next->table[index], &next->table[index + 1],
+                (next->number - index) * sizeof(next->table[0]));
+        shellCmdDynamicPublish(next->number ? next : NULL);
+        ret = 0;
+    }
+    SHELL_ATOMIC_STORE(&shellCmdDynamic.spin, 0);
+    return ret;
+}
+#endif /** SHELL_DYNAMIC_CMD_NUMBER > 0 */
+
+
+/**
+ * @brief shell列出可执行命令
+ * 
+ * @param shell shell对象
+ */
+void shellListCommand(Shell *shell)
+{
+    ShellCommand *base = (ShellCommand *)shell->commandList.base;
+    shellWriteString(shell, shellText[SHELL_TEXT_CMD_LIST]);
+    for (unsigned short i = shellNextCommand(shell, 0);
+         i < shell->commandList.count;
+         i = shellNextCommand(shell, i + 1))
+    {
+        if (base[i].attr.attrs.type <= SHELL_TYPE_CMD_FUNC)
+        {
+            shellListItem(shell, &base[i]);
+        }
+    }
+#if SHELL_DYNAMIC_CMD_NUMBER > 0
+    if (shellCmdDynamicEnter(shell) != NULL)
+    {
+        ShellCommand *command;
+        for (unsigned short i = 0; (command = shellCmdDynamicGet(shell, i)) != NULL; i++)
+        {
+            if (command->attr.attrs.type <= SHELL_TYPE_CMD_FUNC
+                && shellCheckPermission(shell, command) == 0)
+            {
+                shellListItem(shell, command);
+            }
+        }
+        shellCmdDynamicExit(shell);
+    }
+#endif /** SHELL_DYNAMIC_CMD_NUMBER > 0 */
+}
+
+
+/**
+ * @brief shell列出变量
+ * 
+ * @param shell shell对象
+ */
+void shellListVar(Shell *shell)
+{
+    ShellCommand *base = (ShellCommand *)shell->commandList.base;
+    shellWriteString(shell, shellText[SHELL_TEXT_VAR_LIST]);
+    for (unsigned short i = shellNextCommand(shell, 0);
+         i < shell->commandList.count;
+         i = shellNextCommand(shell, i + 1))
+    {
+        if (base[i].attr.attrs.type > SHELL_TYPE_CMD_FUNC
+            && base[i].attr.attrs.type <= SHELL_TYPE_VAR_NODE)
+        {
+            shellListItem(shell, &base[i]);
+        }
+    }
+}
+
+
+/**
+ * @brief shell列出用户
+ * 
+ * @param shell shell对象
+ */
+void shellListUser(Shell *shell)
+{
+    ShellCommand *base = (ShellCommand *)shell->commandList.base;
+    shellWriteString(shell, shellText[SHELL_TEXT_USER_LIST]);
+    for (unsigned short i = shellNextCommand(shell, 0);
+         i < shell->commandList.count;
+         i = shellNextCommand(shell, i + 1))
+    {
+        if (base[i].attr.attrs.type > SHELL_TYPE_VAR_NODE
+            && base[i].attr.attrs.type <= SHELL_TYPE_USER)
+        {
+            shellListItem(shell, &base[i]);
+        }
+    }
+}
+
+
+/**
+ * @brief shell列出按键
+ * 
+ * @param shell shell对象
+ */
+void shellListKey(Shell *shell)
+{
+    ShellCommand *base = (ShellCommand *)shell->commandList.base;
+    shellWriteString(shell, shellText[SHELL_TEXT_KEY_LIST]);
+    for (unsigned short i = shellNextCommand(shell, 0);
+         i < shell->commandList.count;
+         i = shellNextCommand(shell, i + 1))
+    {
+        if (base[i].attr.attrs.type > SHELL_TYPE_USER
+            && base[i].attr.attrs.type <= SHELL_TYPE_KEY)
+        {
+            shellListItem(shell, &base[i]);
+        }
+    }
+}
+
+
+/**
+ * @brief shell列出所有命令
+ * 
+ * @param shell shell对象
+ */
+void shellListAll(Shell *shell)
+{
+#if SHELL_HELP_LIST_USER == 1
+    shellListUser(shell);
+#endif
+    shellListCommand(shell);
+#if SHELL_HELP_LIST_VAR == 1
+    shellListVar(shell);
+#endif
+#if SHELL_HELP_LIST_KEY == 1
+    shellListKey(shell);
+#endif
+}
+
+
+#if SHELL_ANSI_EDIT == 1 || SHELL_HISTORY_SEARCH_LENGTH > 0 \
+    || SHELL_SUPPORT_END_LINE == 1 || SHELL_SUBMIT_QUEUE_SIZE > 0
+/**
+ * @brief shell 移动终端光标(调用者持有输出锁)
+ * 
+ * @param shell shell对象
+ * @param from 当前光标在命令行中的位置
+ * @param to 目标位置
+ */
+static void shellPutCursor(Shell *shell, unsigned short from, unsigned short to)
+{
+#if SHELL_ANSI_EDIT == 1
+    char buffer[12];
+    unsigned short count = (from > to) ? from - to : to - from;
+
+    if (count >= 4)
+    {
+        shellPutString(shell, "\033[");
+        shellPutString(shell, &buffer[11 - shellToDec(count, buffer)]);
+        shellPutData(shell, (from > to) ? "D" : "C", 1);
+        return;
+    }
+#endif
+    if (from > to)
+    {
+        for (unsigned short i = from - to; i > 0; i--)
+        {
+            shellPutData(shell, "\b", 1);
+        }
+    }
+    else if (to > from)
+    {
+        shellPutData(shell, shell->parser.buffer + from, to - from);
+    }
+}
+#endif
+
+
+#if SHELL_ANSI_EDIT == 1 || SHELL_HISTORY_SEARCH_LENGTH > 0
+/**
+ * @brief shell 移动终端光标
+ *        使能`SHELL_ANSI_EDIT`时，选择输出字节数最少的方式，左移使用`\b`或`ESC[nD`，
+ *        右移重新输出命令行中的字符或使用`ESC[nC`
+ * 
+ * @param shell shell对象
+ * @param from 当前光标在命令行中的位置
+ * @param to 目标位置
+ */
+static void shellMoveCursor(Shell *shell, unsigned short from, unsigned short to)
+{
+    shellWriteLock(shell);
+    shellPutCursor(shell, from, to);
+    shellWriteUnlock(shell);
+}
+#endif
+
+
+/**
+ * @brief shell删除命令行数据
+ * 
+ * @param shell shell对象
+ * @param length 删除长度
+ */
+void shellDeleteCommandLine(Shell *shell, unsigned char length)
+{
+#if SHELL_ANSI_EDIT == 1
+    if (length > 1)
+    {
+        shellMoveCursor(shell, length, 0);
+        shellWriteString(shell, "\033[K");
+        return;
+    }
+#endif
+    while (length--)
+    {
+        shellWriteString(shell, "\b \b");
+    }
+}
+
+
+/**
+ * @brief shell 清空命令行输入
+ * 
+ * @param shell shell对象
+ */
+void shellClearCommandLine(Shell *shell)
+{
+#if SHELL_ANSI_EDIT == 1
+    shellMoveCursor(shell, shell->parser.cursor, 0);
+    shellWriteString(shell, "\033[K");
+#else
+    for (short i = shell->parser.length - shell->parser.cursor; i > 0; i--)
+    {
+        shellWriteByte(shell, ' ');
+    }
+    shellDeleteCommandLine(shell, shell->parser.length);
+#endif
+}
+
+
+/**
+ * @brief shell 替换命令行内容
+ *        使能`SHELL_ANSI_EDIT`时，只重绘和当前命令行不同的部分，否则清空命令行后重新输出
+ *        替换后光标位于行尾
+ * 
+ * @param shell shell对象
+ * @param line 新的命令行内容
+ */
+static void shellReplaceCommandLine(Shell *shell, const char *line)
+{
+#if SHELL_ANSI_EDIT == 1
+    unsigned short same = 0;
+    unsigned short length = shell->parser.length;
+
+    while (same < shell->parser.length && line[same]
+           && line[same] == shell->parser.buffer[same])
+    {
+        same++;
+    }
+    shellMoveCursor(shell, shell->parser.cursor, same);
+    shell->parser.length = same + shellStringCopy(shell->parser.buffer + same, (char *)line + same);
+    shellWriteString(shell, shell->parser.buffer + same);
+    if (length > shell->parser.length)
+    {
+        shellWriteString(shell, "\033[K");
+    }
+#else
+    shellClearCommandLine(shell);
+    shell->parser.length = shellStringCopy(shell->parser.buffer, (char *)line);
+    shellWriteString(shell, shell->parser.buffer);
+#endif
+    shell->parser.cursor = shell->parser.length;
+}
+
+
+/**
+ * @brief shell插入一个字符到光标位置
+ * 
+ * @param shell shell对象
+ * @param data 字符数据
+ */
+void shellInsertByte(Shell *shell, char data)
+{
+    /* 判断输入数据是否过长 */
+    if (shell->parser.length >= shell->parser.bufferSize - 1)
+    {
+        shellWriteString(shell, shellText[SHELL_TEXT_CMD_TOO_LONG]);
+        shellWritePrompt(shell, 1);
+        shellWriteString(shell, shell->parser.buffer);
+        return;
+    }
+
+    /* 插入数据 */
+    if (shell->parser.cursor == shell->parser.length)
+    {
+        shell->parser.buffer[shell->parser.length++] = data;
+        shell->parser.buffer[shell->parser.length] = 0;
+        shell->parser.cursor++;
+        shellWriteByte(shell, shell->status.isChecked ? data : '*');
+    }
+    else if (shell->parser.cursor < shell->parser.length)
+    {
+        for (short i = shell->parser.length - shell->parser.cursor; i > 0; i--)
+        {
+            shell->parser.buffer[shell->parser.cursor + i] = 
+                shell->parser.buffer[shell->parser.cursor + i - 1];
+        }
+        shell->parser.buffer[shell->parser.cursor++] = data;
+        shell->parser.buffer[++shell->parser.length] = 0;
+    #if SHELL_ANSI_EDIT == 1
+        shellWriteString(shell, "\033[@");
+        shellWriteByte(shell, shell->status.isChecked ? data : '*');
+    #else
+        for (short i = shell->parser.cursor - 1; i < shell->parser.length; i++)
+        {
+            shellWriteByte(shell, 
+                           shell->status.isChecked ? shell->parser.buffer[i] : '*');
+        }
+        for (short i = shell->parser.length - shell->parser.cursor; i > 0; i--)
+        {
+            shellWriteByte(shell, '\b');
+        }
+    #endif
+    }
+}
+
+
+/**
+ * @brief shell 删除字节
+ * 
+ * @param shell shell对象
+ * @param direction 删除方向 {@code 1}删除光标前字符 {@code -1}删除光标处字符
+ */
+void shellDeleteByte(Shell *shell, signed char direction)
+{
+    char offset = (direction == -1) ? 1 : 0;
+
+    if ((shell->parser.cursor == 0 && direction == 1)
+        || (shell->parser.cursor == shell->parser.length && direction == -1))
+    {
+        return;
+    }
+    if (shell->parser.cursor == shell->parser.length && direction == 1)
+    {
+        shell->parser.cursor--;
+        shell->parser.length--;
+        shell->parser.buffer[shell->parser.length] = 0;
+        shellDeleteCommandLine(shell, 1);
+    }
+    else
+    {
+        for (short i = offset; i < shell->parser.length - shell->parser.cursor; i++)
+        {
+            shell->parser.buffer[shell->parser.cursor + i - 1] = 
+                shell->parser.buffer[shell->parser.cursor + i];
+        }
+        shell->parser.length--;
+        if (!offset)
+        {
+            shell->parser.cursor--;
+            shellWriteByte(shell, '\b');
+        }
+        shell->parser.buffer[shell->parser.length] = 0;
+    #if SHELL_ANSI_EDIT == 1
+        shellWriteString(shell, "\033[P");
+    #else
+        for (short i = shell->parser.cursor; i < shell->parser.length; i++)
+        {
+            shellWriteByte(shell, shell->parser.buffer[i]);
+        }
+        shellWriteByte(shell, ' ');
+        for (short i = shell->parser.length - shell->parser.cursor + 1; i > 0; i--)
+        {
+            shellWriteByte(shell, '\b');
+        }
+    #endif
+    }
+}
+
+
+/**
+ * @brief shell 字符串分割
+ * 
+ * @param string 字符串
+ * @param array 分割后保存的字符串数组
+ * @param splitKey 分隔符
+ * @param maxNum 最大分割数量
+ * 
+ * @return int 分割得到的字串数量
+ */
+int shellSplit(char *string, unsigned short strLen, char *array[], char splitKey, short maxNum)
+{
+    unsigned char record = 1;
+    unsigned char pairedLeft[16] = {0};
+    unsigned char pariedCount = 0;
+    int count = 0;
+
+    for (short i = 0; i < maxNum; i++)
+    {
+        array[i] = NULL;
+    }
+
+    for (unsigned short i = 0; i < strLen; i++)
+    {
+        if (pariedCount == 0)
+        {
+            if (string[i] != splitKey && record == 1 && count < maxNum)
+            {
+                array[count++] = &(string[i]);
+                record = 0;
+            }
+            else if ((string[i] == splitKey || string[i] == ' ') && record == 0)
+            {
+                string[i] = 0;
+                if (string[i + 1] != ' ')
+                {
+                    record = 1;
+                }
+                continue;
+            }
+        }
+
+        for (unsigned char j = 0; j < sizeof(pairedChars) / 2; j++)
+        {
+            if (pariedCount > 0
+                && string[i] == pairedChars[j][1]
+                && pairedLeft[pariedCount - 1] == pairedChars[j][0])
+            {
+                --pariedCount;
+                break;
+            }
+            else if (string[i] == pairedChars[j][0])
+            {
+                pairedLeft[pariedCount++] = pairedChars[j][0];
+                pariedCount &= 0x0F;
+                break;
+            }
+        }
+        
+        if (string[i] == '\\' && string[i + 1] != 0)
+        {
+            i++;
+        }
+    }
+    return count;
+}
+
+
+#if SHELL_ARENA_SIZE > 0
+/**
+ * @brief shell 从参数内存池中分配内存
+ *        分配的内存在当前命令返回后自动释放，可以在命令和自定义类型解析函数中使用，
+ *        使用此接口分配的自定义类型不需要释放函数
+ * 
+ * @param shell shell对象
+ * @param size 大小
+ * 
+ * @return void* 分配的内存，内存池空间不足时返回NULL
+ */
+void *shellArenaAlloc(Shell *shell, unsigned short size)
+{
+    void *memory;
+
+    size = (size + sizeof(size_t) - 1) & ~(sizeof(size_t) - 1);
+    if (size > SHELL_ARENA_SIZE - shell->arena.used)
+    {
+        return NULL;
+    }
+    memory = (char *)shell->arena.buffer + shell->arena.used;
+    shell->arena.used += size;
+    return memory;
+}
+#endif /** SHELL_ARENA_SIZE > 0 */
+
+
+/**
+ * @brief shell 解析参数
+ *        使用参数内存池时，参数列表以NULL结尾，内存池放不下所有参数时输出错误，参数数量为0
+ * 
+ * @param shell shell对象
+ */
+static void shellParserParam(Shell *shell)
+{
+#if SHELL_ARENA_SIZE > 0
+    unsigned short number = shell->parser.length / 2 + 2;
+    unsigned short mark = shell->arena.used;
+
+    if (number > (SHELL_ARENA_SIZE - mark) / sizeof(char *))
+    {
+        number = (SHELL_ARENA_SIZE - mark) / sizeof(char *);
+    }
+    shell->parser.param = shellArenaAlloc(shell, number * sizeof(char *));
+    if (shell->parser.param == NULL)
+    {
+        shell->parser.paramCount = 0;
+        return;
+    }
+    shell->parser.paramCount =
+        shellSplit(shell->parser.buffer, shell->parser.length,
+                   shell->parser.param, ' ', number);
+    shell->arena.used = mark;
+    if (shell->parser.paramCount >= number)
+    {
+        shell->parser.paramCount = 0;
+        shellWriteString(shell, shellText[SHELL_TEXT_PARAM_TOO_MANY]);
+        return;
+    }
+    shell->parser.param[shell->parser.paramCount] = NULL;
+    shellArenaAlloc(shell, (shell->parser.paramCount + 1) * sizeof(char *));
+#else
+    shell->parser.paramCount = 
+        shellSplit(shell->parser.buffer, shell->parser.length, 
+                   shell->parser.param, ' ', SHELL_PARAMETER_MAX_NUMBER);
+#endif
+}
+
+
+/**
+ * @brief shell去除字符串参数头尾的双引号
+ * 
+ * @param shell shell对象
+ */
+static void shellRemoveParamQuotes(Shell *shell)
+{
+    unsigned short paramLength;
+    for (unsigned short i = 0; i < shell->parser.paramCount; i++)
+    {
+        if (shell->parser.param[i][0] == '\"')
+        {
+            shell->parser.param[i][0] = 0;
+            shell->parser.param[i] = &shell->parser.param[i][1];
+        }
+        paramLength = strlen(shell->parser.param[i]);
+        if (shell->parser.param[i][paramLength - 1] == '\"')
+        {
+            shell->parser.param[i][paramLength - 1] = 0;
+        }
+    }
+}
+
+
+#if SHELL_CMD_INDEX_SIZE > 0 || SHELL_EXEC_CACHE_SIZE > 0
+/**
+ * @brief shell 字符串哈希(FNV-1a)
+ * 
+ * @param string 字符串
+ * @return unsigned int 哈希值
+ */
+static unsigned int shellHashString(const char *string)
+{
+    unsigned int hash = 2166136261u;
+    while (*string)
+    {
+        hash ^= (unsigned char)(*string++);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+#endif
+
+
+#if SHELL_EXEC_CACHE_SIZE > 0
+/**
+ * @brief shell 清空命令解析缓存
+ * 
+ * @param shell shell对象
+ */
+static void shellExecCacheFlush(Shell *shell)
+{
+    for (unsigned short i = 0; i < SHELL_EXEC_CACHE_SIZE; i++)
+    {
+        shell->execCache.entry[i].command = NULL;
+    }
+    shell->execCache.current = NULL;
+    shell->execCache.user = shell->info.user;
+    shell->execCache.base = shell->commandList.base;
+    shell->execCache.count = shell->commandList.count;
+}
+
+
+/**
+ * @brief shell 解析参数，优先使用命令解析缓存
+ *        缓存命中时直接恢复分割后的命令行和参数，未命中时分割命令行，并记录到缓存，
+ *        查找到命令后通过`shellExecCacheSet`设置缓存的命令
+ * 
+ * @param shell shell对象
+ * 
+ * @return ShellCommand* 缓存命中时返回缓存的命令，否则返回NULL
+ */
+static ShellCommand *shellExecCacheParse(Shell *shell)
+{
+    ShellExecCache *entry;
+    unsigned short length = shell->parser.length;
+    char *buffer = shell->parser.buffer;
+    unsigned int hash;
+    unsigned short i;
+
+    if (shell->execCache.user != shell->info.user
+        || shell->execCache.base != shell->commandList.base
+        || shell->execCache.count != shell->commandList.count)
+    {
+        shellExecCacheFlush(shell);
+    }
+    shell->execCache.current = NULL;
+    if (length >= SHELL_EXEC_CACHE_LENGTH)
+    {
+        shellParserParam(shell);
+        return NULL;
+    }
+
+    hash = shellHashString(buffer);
+    entry = &shell->execCache.entry[hash & (SHELL_EXEC_CACHE_SIZE - 1)];
+    if (entry->command && entry->hash == hash && entry->length == length)
+    {
+        for (i = 0; i < length; i++)
+        {
+            if (buffer[i] != entry->line[i]
+                && !(entry->line[i] == 0 && buffer[i] == ' '))
+            {
+                break;
+            }
+        }
+    #if SHELL_ARENA_SIZE > 0
+        if (i == length)
+        {
+            shell->parser.param = shellArenaAlloc(shell,
+                (entry->paramCount + 1) * sizeof(char *));
+            if (shell->parser.param == NULL)
+            {
+                i = 0;
+            }
+        }
+        if (i == length)
+        {
+            memcpy(buffer, entry->line, length);
+            for (i = 0; i <= entry->paramCount; i++)
+    #else
+        if (i == length)
+        {
+            memcpy(buffer, entry->line, length);
+            for (i = 0; i < SHELL_PARAMETER_MAX_NUMBER; i++)
+    #endif
+            {
+                shell->parser.param[i] = i < entry->paramCount
+                                         ? buffer + entry->offset[i] : NULL;
+            }
+            shell->parser.paramCount = entry->paramCount;
+            shell->execCache.current = entry;
+            return (ShellCommand *)entry->command;
+        }
+    }
+
+    shellParserParam(shell);
+    if (shell->parser.paramCount > SHELL_PARAMETER_MAX_NUMBER)
+    {
+        return NULL;
+    }
+    entry->command = NULL;
+    entry->hash = hash;
+    entry->length = length;
+    entry->paramCount = shell->parser.paramCount;
+    for (i = 0; i < shell->parser.paramCount; i++)
+    {
+        entry->offset[i] = shell->parser.param[i] - buffer;
+    }
+    memcpy(entry->line, buffer, length);
+    shell->execCache.current = entry;
+    return NULL;
+}
+
+
+/**
+ * @brief shell 设置命令解析缓存的命令
+ * 
+ * @param shell shell对象
+ * @param command 命令
+ */
+static void shellExecCacheSet(Shell *shell, ShellCommand *command)
+{
+    ShellExecCache *entry = shell->execCache.current;
+    if (entry && entry->command == NULL)
+    {
+        entry->command = command;
+        entry->parsed = 0;
+        entry->resolved = 0;
+    }
+}
+#endif /** SHELL_EXEC_CACHE_SIZE > 0 */
+
+
+#if SHELL_CMD_INDEX_SIZE > 0
+
+
+/**
+ * @brief shell 建立命令索引
+ *        命令表在各个shell之间共享，索引只会在命令表变化时重新建立
+ * 
+ * @param shell shell对象
+ */
+static void shellCmdIndexBuild(Shell *shell)
+{
+    ShellCommand *base = (ShellCommand *)shell->commandList.base;
+    unsigned short used = 0;
+    unsigned short slot;
+
+    if (shellCmdIndex.base == base && shellCmdIndex.count == shell->commandList.count)
+    {
+        return;
+    }
+    shellCmdIndex.base = NULL;
+    shellCmdIndex.orderCount = 0;
+    for (unsigned short i = 0; i < SHELL_CMD_INDEX_SIZE; i++)
+    {
+        shellCmdIndex.command[i] = 0;
+    }
+    for (unsigned short i = 0; i < shell->commandList.count; i++)
+    {
+        if (base[i].attr.attrs.type == SHELL_TYPE_KEY)
+        {
+            continue;
+        }
+        /* 至少保留一个空槽位，保证查找可以结束 */
+        if (++used >= SHELL_CMD_INDEX_SIZE)
+        {
+            return;
+        }
+        unsigned int hash = shellHashString(shellGetCommandName(&base[i]));
+        slot = hash & (SHELL_CMD_INDEX_SIZE - 1);
+        while (shellCmdIndex.command[slot] != 0)
+        {
+            slot = (slot + 1) & (SHELL_CMD_INDEX_SIZE - 1);
+        }
+        shellCmdIndex.hash[slot] = hash;
+        shellCmdIndex.type[slot] = base[i].attr.attrs.type;
+        shellCmdIndex.permission[slot] = base[i].attr.attrs.permission;
+        shellCmdIndex.command[slot] = i + 1;
+
+        /* 命令和变量按名称二分插入排序表，同名时保持命令表中的顺序 */
+        if (base[i].attr.attrs.type < SHELL_TYPE_USER)
+        {
+            unsigned short low = 0;
+            unsigned short high = shellCmdIndex.orderCount;
+            unsigned short mid;
+            while (low < high)
+            {
+                mid = low + ((high - low) >> 1);
+                if (strcmp(shellGetCommandName(&base[i]),
+                           shellGetCommandName(&base[shellCmdIndex.order[mid]])) < 0)
+                {
+                    high = mid;
+                }
+                else
+                {
+                    low = mid + 1;
+                }
+            }
+            for (unsigned short j = shellCmdIndex.orderCount; j > low; j--)
+            {
+                shellCmdIndex.order[j] = shellCmdIndex.order[j - 1];
+            }
+            shellCmdIndex.order[low] = i;
+            shellCmdIndex.orderCount++;
+        }
+    }
+    shellCmdIndex.count = shell->commandList.count;
+    shellCmdIndex.base = base;
+}
+
+
+/**
+ * @brief shell 通过索引查找命令
+ *        同名命令按照命令表中的顺序依次插入同一条探测链，查找结果和遍历查找一致
+ * 
+ * @param shell shell对象
+ * @param cmd 命令
+ * @return ShellCommand* 匹配到的命令
+ */
+static ShellCommand* shellCmdIndexSeek(Shell *shell, const char *cmd)
+{
+    unsigned int hash = shellHashString(cmd);
+    unsigned short slot = hash & (SHELL_CMD_INDEX_SIZE - 1);
+    unsigned short index;
+    unsigned char userPermission = shell->info.user
+                                   ? shell->info.user->attr.attrs.permission : 0;
+    ShellCommand *command;
+    unsigned char permitted;
+#if SHELL_CMD_VIEW_NUMBER > 0
+    unsigned int *view = shellCmdViewGet(shell);
+#endif
+
+    while ((index = shellCmdIndex.command[slot]) != 0)
+    {
+        if (shellCmdIndex.hash[slot] == hash)
+        {
+            command = &shellCmdIndex.base[index - 1];
+        #if SHELL_CMD_VIEW_NUMBER > 0
+            if (view)
+            {
+                permitted = SHELL_CMD_VIEW_TEST(view, index - 1);
+            }
+            else
+        #endif
+            {
+                permitted = (shellCmdIndex.permission[slot] == 0
+                             || shellCmdIndex.type[slot] == SHELL_TYPE_USER
+                             || (shellCmdIndex.permission[slot] & userPermission))
+                            && (shell->status.isChecked
+                                || command->attr.attrs.enableUnchecked);
+            }
+            if (permitted && strcmp(cmd, shellGetCommandName(command)) == 0)
+            {
+                return command;
+            }
+        }
+        slot = (slot + 1) & (SHELL_CMD_INDEX_SIZE - 1);
+    }
+    return NULL;
+}
+
+
+/**
+ * @brief shell 在索引排序表中二分查找前缀边界
+ * 
+ * @param prefix 前缀
+ * @param length 前缀长度
+ * @param upper 0 查找第一个不小于前缀的命令 1 查找第一个大于前缀的命令
+ * @return unsigned short 边界在排序表中的序号
+ */
+static unsigned short shellCmdIndexBound(const char *prefix,
+                                         unsigned short length, unsigned char upper)
+{
+    unsigned short low = 0;
+    unsigned short high = shellCmdIndex.orderCount;
+    unsigned short mid;
+    int result;
+
+    while (low < high)
+    {
+        mid = low + ((high - low) >> 1);
+        result = strncmp(shellGetCommandName(&shellCmdIndex.base[shellCmdIndex.order[mid]]),
+                         prefix, length);
+        if (result < 0 || (upper && result == 0))
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    return low;
+}
+#endif /** SHELL_CMD_INDEX_SIZE > 0 */
+
+
+#if SHELL_CMD_SORTED_SECTION == 1
+/**
+ * @brief shell 检查命令表排序
+ *        从命令表末尾向前找出按名称严格递增的命令，变量和用户，这一部分使用二分查找，
+ *        命令表前面的按键，参数解析器以及未排序的部分仍然使用遍历查找
+ * 
+ * @param shell shell对象
+ * @return int 0 命令表有序 -1 命令表未排序或者存在重名
+ */
+static int shellCmdSortedCheck(Shell *shell)
+{
+    ShellCommand *base = (ShellCommand *)shell->commandList.base;
+    unsigned short count = shell->commandList.count;
+    unsigned short sorted = count;
+
+    while (sorted > 0
+           && base[sorted - 1].attr.attrs.type <= SHELL_TYPE_USER
+           && (sorted == count
+               || strcmp(shellGetCommandName(&base[sorted - 1]),
+                         shellGetCommandName(&base[sorted])) < 0))
+    {
+        sorted--;
+    }
+    shell->commandList.sorted = sorted;
+
+    for (unsigned short i = 1; i <= sorted && i < count; i++)
+    {
+        if (base[i - 1].attr.attrs.type <= SHELL_TYPE_USER
+            && base[i].attr.attrs.type <= SHELL_TYPE_USER
+            && strcmp(shellGetCommandName(&base[i - 1]),
+                      shellGetCommandName(&base[i])) >= 0)
+        {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+
+/**
+ * @brief shell 在命令表有序部分中二分查找前缀边界
+ * 
+ * @param shell shell对象
+ * @param prefix 前缀
+ * @param length 前缀长度
+ * @param upper 0 查找第一个不小于前缀的命令 1 查找第一个大于前缀的命令
+ * @return unsigned short 边界序号
+ */
+static unsigned short shellCmdSortedBound(Shell *shell, const char *prefix,
+                                          unsigned short length, unsigned char upper)
+{
+    ShellCommand *base = (ShellCommand *)shell->commandList.base;
+    unsigned short low = shell->commandList.sorted;
+    unsigned short high = shell->commandList.count;
+    unsigned short mid;
+    int result;
+
+    while (low < high)
+    {
+        mid = low + ((high - low) >> 1);
+        result = strncmp(shellGetCommandName(&base[mid]), prefix, length);
+        if (result < 0 || (upper && result == 0))
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+
+/**
+ * @brief shell 在排序的命令表中查找命令
+ *        先遍历命令表未排序的部分，再对有序部分进行二分查找，查找结果和遍历查找一致
+ * 
+ * @param shell shell对象
+ * @param cmd 命令
+ * @return ShellCommand* 匹配到的命令
+ */
+static ShellCommand* shellCmdSortedSeek(Shell *shell, const char *cmd)
+{
+    ShellCommand *base = (ShellCommand *)shell->commandList.base;
+    unsigned short low = shell->commandList.sorted;
+    unsigned short high = shell->commandList.count;
+    unsigned short mid;
+    int result;
+
+    for (unsigned short i = 0; i < low; i++)
+    {
+        if (base[i].attr.attrs.type != SHELL_TYPE_KEY
+            && shellCheckPermission(shell, &base[i]) == 0
+            && strcmp(cmd, shellGetCommandName(&base[i])) == 0)
+        {
+            return &base[i];
+        }
+    }
+    while (low < high)
+    {
+        mid = low + ((high - low) >> 1);
+        result = strcmp(cmd, shellGetCommandName(&base[mid]));
+        if (result == 0)
+        {
+            return shellCheckPermission(shell, &base[mid]) == 0 ? &base[mid] : NULL;
+        }
+        else if (result < 0)
+        {
+            high = mid;
+        }
+        else
+        {
+            low = mid + 1;
+        }
+    }
+    return NULL;
+}
+#endif /** SHELL_CMD_SORTED_SECTION == 1 */
+
+
+/**
+ * @brief shell匹配命令
+ * 
+ * @param shell shell对象
+ * @param cmd 命令
+ * @param base 匹配命令表基址
+ * @param compareLength 匹配字符串长度
+ * @return ShellCommand* 匹配到的命令
+ */
+ShellCommand* shellSeekCommand(Shell *shell,
+                               const char *cmd,
+                               ShellCommand *base,
+                               unsigned short compareLength)
+{
+    const char *name;
+#if SHELL_CMD_INDEX_SIZE > 0
+    if (compareLength == 0
+        && base == shell->commandList.base
+        && base == shellCmdIndex.base)
+    {
+        return shellCmdIndexSeek(shell, cmd);
+    }
+#endif /** SHELL_CMD_INDEX_SIZE > 0 */
+#if SHELL_CMD_SORTED_SECTION == 1
+    if (compareLength == 0 && base == shell->commandList.base)
+    {
+        return shellCmdSortedSeek(shell, cmd);
+    }
+#endif /** SHELL_CMD_SORTED_SECTION == 1 */
+    unsigned short count = shell->commandList.count -
+        ((size_t)base - (size_t)shell->commandList.base) / sizeof(ShellCommand);
+    for (unsigned short i = 0; i < count; i++)
+    {
+        if (base[i].attr.attrs.type == SHELL_TYPE_KEY
+            || shellCheckPermission(shell, &base[i]) != 0)
+        {
+            continue;
+        }
+        name = shellGetCommandName(&base[i]);
+        if (!compareLength)
+        {
+            if (strcmp(cmd, name) == 0)
+            {
+                return &base[i];
+            }
+        }
+        else
+        {
+            if (strncmp(cmd, name, compareLength) == 0)
+            {
+                return &base[i];
+            }
+        }
+    }
+    return NULL;
+}
+
+
+/**
+ * @brief shell 获取变量值
+ * 
+ * @param shell shell对象
+ * @param command 命令
+ * @return int 变量值
+ */
+int shellGetVarValue(Shell *shell, ShellCommand *command)
+{
+    int value = 0;
+    switch (command->attr.attrs.type)
+    {
+    case SHELL_TYPE_VAR_INT:
+        value = *((int *)(command->data.var.value));
+        break;
+    case SHELL_TYPE_VAR_SHORT:
+        value = *((short *)(command->data.var.value));
+        break;
+    case SHELL_TYPE_VAR_CHAR:
+        value = *((char *)(command->data.var.value));
+        break;
+    case SHELL_TYPE_VAR_STRING:
+    case SHELL_TYPE_VAR_POINT:
+        value = (size_t)(command->data.var.value);
+        break;
+    case SHELL_TYPE_VAR_NODE: {
+      int (*func)(void *) =
+          (int (*)(void *))((ShellNodeVarAttr *)command->data.var.value)->get;
+        value = func ? func(((ShellNodeVarAttr *)command->data.var.value)->var) : 0;
+        break;
+    }
+    default:
+        break;
+    }
+    return value;
+}
+
+
+/**
+ * @brief shell设置变量值
+ * 
+ * @param shell shell对象
+ * @param command 命令
+ * @param value 值
+ * @return int 返回变量值
+ */
+int shellSetVarValue(Shell *shell, ShellCommand *command, int value)
+{
+    if (command->attr.attrs.readOnly)
+    {
+        shellWriteString(shell, shellText[SHELL_TEXT_VAR_READ_ONLY_CANNOT_MODIFY]);
+    }
+    else
+    {
+        switch (command->attr.attrs.type)
+        {
+        case SHELL_TYPE_VAR_INT:
+            *((int *)(command->data.var.value)) = value;
+            break;
+        case SHELL_TYPE_VAR_SHORT:
+            *((short *)(command->data.var.value)) = value;
+            break;
+        case SHELL_TYPE_VAR_CHAR:
+            *((char *)(command->data.var.value)) = value;
+            break;
+        case SHELL_TYPE_VAR_STRING:
+            shellStringCopy(((char *)(command->data.var.value)), (char *) (size_t) value);
+            break;
+        case SHELL_TYPE_VAR_POINT:
+            shellWriteString(shell, shellText[SHELL_TEXT_POINT_CANNOT_MODIFY]);
+            break;
+        case SHELL_TYPE_VAR_NODE:
+            if (((ShellNodeVarAttr *)command->data.var.value)->set)
+            {
+                if (((ShellNodeVarAttr *)command->data.var.value)->var)
+                {
+                    int (*func)(void *, int) = (int (*)(void *, int))((ShellNodeVarAttr *)command->data.var.value)->set;
+                    func(((ShellNodeVarAttr *)command->data.var.value)->var, value);
+                }
+                else
+                {
+                  int (*func)(int) = (int (*)(
+                      int))((ShellNodeVarAttr *)command->data.var.value)->set;
+                    func(value);
+                }
+            }
+            break;
+        default:
+            break;
+        }
+    }
+    return shellShowVar(shell, command);
+}
+
+
+/**
+ * @brief shell变量输出
+ * 
+ * @param shell shell对象
+ * @param command 命令
+ * @return int 返回变量值
+ */
+static int shellShowVar(Shell *shell, ShellCommand *command)
+{
+    char buffer[12] = "00000000000";
+    int value = shellGetVarValue(shell, command);
+    
+    shellWriteString(shell, command->data.var.name);
+    shellWriteString(shell, " = ");
+
+    switch (command->attr.attrs.type)
+    {
+    case SHELL_TYPE_VAR_STRING:
+        shellWriteString(shell, "\"");
+        shellWriteString(shell, (char *) (size_t) value);
+        shellWriteString(shell, "\"");
+        break;
+    // case SHELL_TYPE_VAR_INT:
+    // case SHELL_TYPE_VAR_SHORT:
+    // case SHELL_TYPE_VAR_CHAR:
+    // case SHELL_TYPE_VAR_POINT:
+    default:
+        shellWriteString(shell, &buffer[11 - shellToDec(value, buffer)]);
+        shellWriteString(shell, ", 0x");
+        for (short i = 0; i < 11; i++)
+        {
+            buffer[i] = '0';
+        }
+        shellToHex(value, buffer);
+        shellWriteString(shell, buffer);
+        break;
+    }
+
+    shellWriteString(shell, "\r\n");
+    return value;
+}
+
+
+/**
+ * @brief shell设置变量
+ * 
+ * @param name 变量名
+ * @param value 变量值
+ * @return int 返回变量值
+ */
+int shellSetVar(char *name, int value)
+{
+    Shell *shell = shellGetCurrent();
+    if (shell == NULL)
+    {
+        return 0;
+    }
+    ShellCommand *command = shellSeekCommand(shell,
+                                             name,
+                                             shell->commandList.base,
+                                             0);
+    if (!command)
+    {
+        shellWriteString(shell, shellText[SHELL_TEXT_VAR_NOT_FOUND]);
+        return 0;
+    }
+    if (command->attr.attrs.type < SHELL_TYPE_VAR_INT
+        || command->attr.attrs.type > SHELL_TYPE_VAR_NODE)
+    {
+        shellWriteString(shell, name);
+        shellWriteString(shell, shellText[SHELL_TEXT_NOT_VAR]);
+        return 0;
+    }
+    return shellSetVarValue(shell, command, value);
+}
+SHELL_EXPORT_CMD(
+SHELL_CMD_PERMISSION(0)|SHELL_CMD_TYPE(SHELL_TYPE_CMD_FUNC)|SHELL_CMD_DISABLE_RETURN,
+setVar, shellSetVar, set var);
+
+
+/**
+ * @brief shell运行命令
+ * 
+ * @param shell shell对象
+ * @param command 命令
+ * 
+ * @return unsigned int 命令返回值
+ */
+unsigned int shellRunCommand(Shell *shell, ShellCommand *command)
+{
+    int returnValue = 0;
+    unsigned char isLocked = shell->status.isLocked;
+    unsigned char inHandler;
+
+    shellWriteLock(shell);
+    shell->info.task = (size_t)SHELL_GET_TASK();
+    shell->status.isActive = 1;
+    inHandler = shell->output.inHandler;
+    shell->output.inHandler = 0;
+#if SHELL_END_LINE_BUFFER > 0
+    shellEndLinePut(shell);
+#endif
+    shellWriteUnlock(shell);
+    if (isLocked)
+    {
+        shell->status.isLocked = 0;
+        SHELL_UNLOCK(shell);
+    }
+#if SHELL_USING_CANCEL == 1
+    shell->info.execTime = SHELL_GET_TICK();
+    shell->info.execTimeout = SHELL_EXEC_TIMEOUT;
+#endif
+    shellFlushPoint(shell);
+    if (command->attr.attrs.type == SHELL_TYPE_CMD_MAIN)
+    {
+        shellRemoveParamQuotes(shell);
+        int (*func)(int, char **) =
+            (int (*)(int, char **))command->data.cmd.function;
+        returnValue = func(shell->parser.paramCount, shell->parser.param);
+        if (!command->attr.attrs.disableReturn)
+        {
+            shellWriteReturnValue(shell, returnValue);
+        }
+    }
+    else if (command->attr.attrs.type == SHELL_TYPE_CMD_FUNC)
+    {
+    #if SHELL_ARENA_SIZE > 0
+        if (shell->parser.paramCount > SHELL_PARAMETER_MAX_NUMBER)
+        {
+            shellWriteString(shell, shellText[SHELL_TEXT_PARAM_TOO_MANY]);
+            returnValue = -1;
+        }
+        else
+    #endif
+        returnValue = shellExtRun(shell,
+                                  command,
+                                  shell->parser.paramCount,
+                                  shell->parser.param);
+        if (!command->attr.attrs.disableReturn)
+        {
+            shellWriteReturnValue(shell, returnValue);
+        }
+    }
+    else if (command->attr.attrs.type >= SHELL_TYPE_VAR_INT
+        && command->attr.attrs.type <= SHELL_TYPE_VAR_NODE)
+    {
+        shellShowVar(shell, command);
+    }
+    else if (command->attr.attrs.type == SHELL_TYPE_USER)
+    {
+        shellSetUser(shell, command);
+    }
+#if SHELL_USING_CANCEL == 1
+    if (shell->info.cancelled)
+    {
+        shellWriteString(shell, shellText[SHELL_TEXT_CMD_CANCELLED]);
+    }
+#endif
+    if (isLocked)
+    {
+        SHELL_LOCK(shell);
+        shell->status.isLocked = 1;
+    }
+    shellWriteLock(shell);
+    shell->status.isActive = 0;
+    shell->output.inHandler = inHandler;
+    shellWriteUnlock(shell);
+
+    return returnValue;
+}
+
+
+#if SHELL_USING_CANCEL == 1
+/**
+ * @brief shell 取消正在执行的命令
+ *        只设置取消标志，可以在其他线程，信号处理或者中断中调用，
+ *        命令需要通过`shellIsCancelled()`查询取消标志并结束执行
+ * 
+ * @param shell shell对象
+ */
+void shellCancel(Shell *shell)
+{
+    SHELL_ASSERT(shell, return);
+    shell->info.cancelled = 1;
+}
+
+
+/**
+ * @brief shell 查询当前命令是否被取消
+ *        命令执行时间超过预算时，也会设置取消标志
+ * 
+ * @param shell shell对象
+ * 
+ * @return int 1 已取消 0 未取消
+ */
+int shellIsCancelled(Shell *shell)
+{
+    SHELL_ASSERT(shell, return 0);
+    if (shell->info.cancelled)
+    {
+        return 1;
+    }
+    if (shell->info.execTimeout > 0
+        && (unsigned int)(SHELL_GET_TICK() - shell->info.execTime)
+            > (unsigned int)shell->info.execTimeout)
+    {
+        shell->info.cancelled = 1;
+        return 1;
+    }
+    return 0;
+}
+
+
+/**
+ * @brief shell 设置当前命令的执行时间预算
+ *        从命令开始执行时计算，每次执行命令时恢复为`SHELL_EXEC_TIMEOUT`
+ * 
+ * @param shell shell对象
+ * @param timeout 执行时间预算，为0时不限制
+ */
+void shellSetExecTimeout(Shell *shell, int timeout)
+{
+    SHELL_ASSERT(shell, return);
+    shell->info.execTimeout = timeout;
+}
+#endif /** SHELL_USING_CANCEL == 1 */
+
+
+/**
+ * @brief shell校验密码
+ * 
+ * @param shell shell对象
+ */
+static void shellCheckPassword(Shell *shell)
+{
+    if (strcmp(shell->parser.buffer, shell->info.user->data.user.password) == 0)
+    {
+        shell->status.isChecked = 1;
+    #if SHELL_SHOW_INFO == 1
+        shellWriteString(shell, shellText[SHELL_TEXT_INFO]);
+    #endif
+    }
+    else
+    {
+        shellWriteString(shell, shellText[SHELL_TEXT_PASSWORD_ERROR]);
+    }
+    shell->parser.length = 0;
+    shell->parser.cursor = 0;
+}
+
+
+/**
+ * @brief shell设置用户
+ * 
+ * @param shell shell对象
+ * @param user 用户
+ */
+void shellSetUser(Shell *shell, const ShellCommand *user)
+{
+    shell->info.user = user;
+#if SHELL_CMD_VIEW_NUMBER > 0
+    shellCmdViewSelect(shell);
+#endif
+    shell->status.isChecked = 
+        ((user->data.user.password && strlen(user->data.user.password) != 0)
+            && (shell->parser.paramCount < 2
+                || strcmp(user->data.user.password, shell->parser.param[1]) != 0))
+         ? 0 : 1;
+        
+#if SHELL_CLS_WHEN_LOGIN == 1
+    shellWriteString(shell, shellText[SHELL_TEXT_CLEAR_CONSOLE]);
+#endif
+#if SHELL_SHOW_INFO == 1
+    if (shell->status.isChecked)
+    {
+        shellWriteString(shell, shellText[SHELL_TEXT_INFO]);
+    }
+#endif
+}
+
+
+/**
+ * @brief shell写返回值
+ * 
+ * @param shell shell对象
+ * @param value 返回值
+ */
+static void shellWriteReturnValue(Shell *shell, int value)
+{
+    char buffer[12] = "00000000000";
+    shellWriteString(shell, "Return: ");
+    shellWriteString(shell, &buffer[11 - shellToDec(value, buffer)]);
+    shellWriteString(shell, ", 0x");
+    for (short i = 0; i < 11; i++)
+    {
+        buffer[i] = '0';
+    }
+    shellToHex(value, buffer);
+    shellWriteString(shell, buffer);
+    shellWriteString(shell, "\r\n");
+#if SHELL_KEEP_RETURN_VALUE == 1
+    shell->info.retVal = value;
+#endif
+}
+
+
+#if SHELL_HISTORY_MAX_NUMBER > 0
+#if SHELL_HISTORY_POOL == 1
+/**
+ * @brief shell历史记录长度
+ *        记录在历史记录池中按照`内容 '\0' 长度低字节 长度高字节`依次存放，
+ *        通过记录末尾的长度可以从新到旧遍历
+ * 
+ * @param shell shell对象
+ * @param end 记录的结束位置
+ * 
+ * @return unsigned short 记录内容的长度
+ */
+static unsigned short shellHistoryLength(Shell *shell, unsigned short end)
+{
+    return (unsigned char)shell->history.pool[end - 2]
+        | ((unsigned char)shell->history.pool[end - 1] << 8);
+}
+
+
+/**
+ * @brief shell历史记录起始位置
+ * 
+ * @param shell shell对象
+ * @param end 记录的结束位置
+ * 
+ * @return unsigned short 记录的起始位置，也是上一条记录的结束位置
+ */
+static unsigned short shellHistoryStart(Shell *shell, unsigned short end)
+{
+    return end - 3 - shellHistoryLength(shell, end);
+}
+
+
+/**
+ * @brief shell历史记录追加
+ *        历史记录池空间不足时，丢弃最旧的记录，剩余的记录移动到池的起始位置
+ * 
+ * @param shell shell对象
+ * @param line 命令
+ * @param length 命令长度
+ */
+static void shellHistoryAppend(Shell *shell, const char *line, unsigned short length)
+{
+    unsigned short need = length + 3;
+    unsigned short drop = 0;
+    unsigned short used = shell->history.used;
+    char *pool = shell->history.pool;
+
+    if (length == 0 || need > shell->history.size)
+    {
+        return;
+    }
+    if (used > 0 && shellHistoryLength(shell, used) == length
+        && memcmp(pool + shellHistoryStart(shell, used), line, length) == 0)
+    {
+        return;
+    }
+    while (used - drop + need > shell->history.size)
+    {
+        drop += strlen(pool + drop) + 3;
+    }
+    if (drop > 0)
+    {
+        used -= drop;
+        memmove(pool, pool + drop, used);
+    }
+    memcpy(pool + used, line, length);
+    pool[used + length] = 0;
+    pool[used + length + 1] = length & 0xFF;
+    pool[used + length + 2] = length >> 8;
+    shell->history.used = used + need;
+}
+
+
+/**
+ * @brief shell历史记录添加
+ * 
+ * @param shell shell对象
+ */
+static void shellHistoryAdd(Shell *shell)
+{
+    shell->history.offset = 0;
+    shellHistoryAppend(shell, shell->parser.buffer, shell->parser.length);
+}
+
+
+/**
+ * @brief shell历史记录查找
+ * 
+ * @param shell shell对象
+ * @param dir 方向 {@code <0}往上查找 {@code >0}往下查找
+ */
+static void shellHistory(Shell *shell, signed char dir)
+{
+    unsigned short end;
+
+    if (dir > 0)
+    {
+        end = shell->history.offset == 0
+            ? shell->history.used
+            : shellHistoryStart(shell, shell->history.position);
+        if (end == 0)
+        {
+            return;
+        }
+        shell->history.position = end;
+        shell->history.offset--;
+    }
+    else if (dir < 0)
+    {
+        if (shell->history.offset == 0)
+        {
+            return;
+        }
+        if (++shell->history.offset == 0)
+        {
+            shellReplaceCommandLine(shell, "");
+            return;
+        }
+        shell->history.position += strlen(shell->history.pool + shell->history.position) + 3;
+    }
+    else
+    {
+        return;
+    }
+    shellReplaceCommandLine(shell,
+        shell->history.pool + shellHistoryStart(shell, shell->history.position));
+}
+
+
+/**
+ * @brief shell 导出历史记录
+ *        从旧到新输出所有历史记录，每条记录以`\n`结尾，可以用于保存历史记录
+ * 
+ * @param shell shell对象
+ * @param buffer 缓冲
+ * @param size 缓冲大小，缓冲不足时只导出较旧的完整记录
+ * 
+ * @return unsigned short 导出的数据长度
+ */
+unsigned short shellHistoryDump(Shell *shell, char *buffer, unsigned short size)
+{
+    unsigned short position = 0;
+    unsigned short count = 0;
+    unsigned short length;
+
+    while (position < shell->history.used)
+    {
+        length = strlen(shell->history.pool + position);
+        if (count + length + 1 > size)
+        {
+            break;
+        }
+        memcpy(buffer + count, shell->history.pool + position, length);
+        buffer[count + length] = '\n';
+        count += length + 1;
+        position += length + 3;
+    }
+    return count;
+}
+
+
+/**
+ * @brief shell 恢复历史记录
+ *        按照`shellHistoryDump()`的格式添加历史记录，超过命令行长度的记录会被忽略
+ * 
+ * @param shell shell对象
+ * @param data 数据
+ * @param len 数据长度
+ */
+void shellHistoryRestore(Shell *shell, const char *data, unsigned short len)
+{
+    unsigned short start = 0;
+    unsigned short length;
+
+    for (unsigned short i = 0; i <= len; i++)
+    {
+        if (i == len || data[i] == '\n')
+        {
+            length = i - start;
+            if (length > 0 && data[i - 1] == '\r')
+            {
+                length--;
+            }
+            if (length < shell->parser.bufferSize)
+            {
+                shellHistoryAppend(shell, data + start, length);
+            }
+            start = i + 1;
+        }
+    }
+    shell->history.offset = 0;
+}
+
+
+#if SHELL_HISTORY_SEARCH_LENGTH > 0
+/**
+ * @brief shell历史记录搜索
+ *        从指定的记录开始往旧的方向查找包含搜索内容的记录
+ * 
+ * @param shell shell对象
+ * @param end 开始查找的记录的结束位置
+ * 
+ * @return unsigned short 匹配的记录的结束位置，未找到返回0
+ */
+static unsigned short shellHistorySearchFrom(Shell *shell, unsigned short end)
+{
+    unsigned short start;
+
+    while (end > 0)
+    {
+        start = shellHistoryStart(shell, end);
+        if (strstr(shell->history.pool + start, shell->history.search.pattern))
+        {
+            return end;
+        }
+        end = start;
+    }
+    return 0;
+}
+
+
+/**
+ * @brief shell历史记录搜索显示
+ * 
+ * @param shell shell对象
+ */
+static void shellHistorySearchShow(Shell *shell)
+{
+    unsigned char length = shell->history.search.length;
+    unsigned short match = shell->history.search.match[length];
+
+    shellWriteString(shell, shellText[SHELL_TEXT_CLEAR_LINE]);
+    shellWriteString(shell, shellText[length > 0 && match == 0
+                                      ? SHELL_TEXT_HISTORY_SEARCH_FAILED
+                                      : SHELL_TEXT_HISTORY_SEARCH]);
+    shellWriteString(shell, shell->history.search.pattern);
+    shellWriteString(shell, "': ");
+    if (length > 0 && match > 0)
+    {
+        shellWriteString(shell, shell->history.pool + shellHistoryStart(shell, match));
+    }
+}
+
+
+/**
+ * @brief shell历史记录搜索结束
+ * 
+ * @param shell shell对象
+ * @param accept 是否使用匹配的记录作为命令行
+ */
+static void shellHistorySearchExit(Shell *shell, unsigned char accept)
+{
+    unsigned short match = shell->history.search.match[shell->history.search.length];
+
+    shell->history.search.active = 0;
+    shell->history.offset = 0;
+    if (accept && shell->history.search.length > 0 && match > 0)
+    {
+        shell->parser.length = shellStringCopy(shell->parser.buffer,
+            shell->history.pool + shellHistoryStart(shell, match));
+        shell->parser.cursor = shell->parser.length;
+    }
+    shellWriteString(shell, shellText[SHELL_TEXT_CLEAR_LINE]);
+    shellWritePrompt(shell, 0);
+    shellWriteData(shell, shell->parser.buffer, shell->parser.length);
+    shellMoveCursor(shell, shell->parser.length, shell->parser.cursor);
+}
+
+
+/**
+ * @brief shell历史记录搜索输入
+ *        每个搜索长度匹配的记录都会保存下来，输入字符时从当前匹配的记录继续往旧的方向查找，
+ *        删除字符时直接恢复到上一个长度的匹配，不需要重新遍历历史记录
+ * 
+ * @param shell shell对象
+ * @param data 输入字符
+ * 
+ * @return unsigned char 1 输入已处理 0 搜索结束，输入需要继续处理
+ */
+static unsigned char shellHistorySearchInput(Shell *shell, char data)
+{
+    unsigned char length = shell->history.search.length;
+    unsigned short *match = shell->history.search.match;
+
+    if (data == 0x12)
+    {
+        if (length > 0 && match[length] > 0)
+        {
+            unsigned short end = shellHistorySearchFrom(shell,
+                                    shellHistoryStart(shell, match[length]));
+            if (end > 0)
+            {
+                match[length] = end;
+            }
+        }
+    }
+    else if (data >= 0x20 && data <= 0x7E)
+    {
+        if (length < SHELL_HISTORY_SEARCH_LENGTH)
+        {
+            shell->history.search.pattern[length] = data;
+            shell->history.search.pattern[length + 1] = 0;
+            match[length + 1] = match[length] > 0
+                              ? shellHistorySearchFrom(shell, match[length]) : 0;
+            shell->history.search.length = length + 1;
+        }
+    }
+    else if (data == 0x08 || data == 0x7F)
+    {
+        if (length > 0)
+        {
+            shell->history.search.pattern[--shell->history.search.length] = 0;
+        }
+    }
+    else
+    {
+        shellHistorySearchExit(shell, data != 0x07);
+        return data == 0x07;
+    }
+    shellHistorySearchShow(shell);
+    return 1;
+}
+#endif /** SHELL_HISTORY_SEARCH_LENGTH > 0 */
+#else
+/**
+ * @brief shell历史记录添加
+ * 
+ * @param shell shell对象
+ */
+static void shellHistoryAdd(Shell *shell)
+{
+    shell->history.offset = 0;
+    if (shell->history.number > 0
+        && strcmp(shell->history.item[(shell->history.record == 0 ? 
+                SHELL_HISTORY_MAX_NUMBER : shell->history.record) - 1],
+                shell->parser.buffer) == 0)
+    {
+        return;
+    }
+    if (shellStringCopy(shell->history.item[shell->history.record],
+                        shell->parser.buffer) != 0)
+    {
+        shell->history.record++;
+    }
+    if (++shell->history.number > SHELL_HISTORY_MAX_NUMBER)
+    {
+        shell->history.number = SHELL_HISTORY_MAX_NUMBER;
+    }
+    if (shell->history.record >= SHELL_HISTORY_MAX_NUMBER)
+    {
+        shell->history.record = 0;
+    }
+}
+
+
+/**
+ * @brief shell历史记录查找
+ * 
+ * @param shell shell对象
+ * @param dir 方向 {@code <0}往上查找 {@code >0}往下查找
+ */
+static void shellHistory(Shell *shell, signed char dir)
+{
+    if (dir > 0)
+    {
+        if (shell->history.offset-- <= 
+            -((shell->history.number > shell->history.record) ?
+                shell->history.number : shell->history.record))
+        {
+            shell->history.offset = -((shell->history.number > shell->history.record)
+                                    ? shell->history.number : shell->history.record);
+        }
+    }
+    else if (dir < 0)
+    {
+        if (++shell->history.offset > 0)
+        {
+            shell->history.offset = 0;
+            return;
+        }
+    }
+    else
+    {
+        return;
+    }
+    if (shell->history.offset == 0)
+    {
+        shellReplaceCommandLine(shell, "");
+    }
+    else
+    {
+        shellReplaceCommandLine(shell,
+            shell->history.item[(shell->history.record + SHELL_HISTORY_MAX_NUMBER
+                + shell->history.offset) % SHELL_HISTORY_MAX_NUMBER]);
+    }
+}
+#endif /** SHELL_HISTORY_POOL == 1 */
+#endif /** SHELL_HISTORY_MAX_NUMBER > 0 */
+
+
+/**
+ * @brief shell 常规输入
+ * 
+ * @param shell shell 对象
+ * @param data 输入字符
+ */
+void shellNormalInput(Shell *shell, char data)
+{
+    shell->status.tabFlag = 0;
+    shellInsertByte(shell, data);
+}
+
+
+#if SHELL_USING_JOBS == 1
+/**
+ * @brief shell 解析后台执行标志
+ *        命令最后一个参数为`&`或以`&`结尾时，去掉`&`，引号中和转义的`&`不作为后台执行标志，
+ *        命令不能后台执行时(没有设置`shell->background`，变量等非命令类型或动态注册的命令)，
+ *        输出错误，不会在前台执行
+ * 
+ * @param shell shell对象
+ * 
+ * @return char 1 后台执行 0 前台执行
+ */
+static char shellParserBackground(Shell *shell)
+{
+    char *param;
+    unsigned short length;
+    char quoted = 0;
+
+    if (shell->parser.paramCount == 0)
+    {
+        return 0;
+    }
+    param = shell->parser.param[shell->parser.paramCount - 1];
+    length = strlen(param);
+    if (length == 0 || param[length - 1] != '&')
+    {
+        return 0;
+    }
+    for (unsigned short i = 0; i < length - 1; i++)
+    {
+        if (param[i] == '\\')
+        {
+            if (++i == length - 1)
+            {
+                return 0;
+            }
+        }
+        else if (param[i] == '\"')
+        {
+            quoted = !quoted;
+        }
+    }
+    if (quoted)
+    {
+        return 0;
+    }
+    if (length == 1)
+    {
+        shell->parser.paramCount--;
+    }
+    else
+    {
+        param[length - 1] = 0;
+    }
+    return 1;
+}
+#endif /** SHELL_USING_JOBS == 1 */
+
+
+/**
+ * @brief shell运行命令
+ * 
+ * @param shell shell对象
+ */
+void shellExec(Shell *shell)
+{
+    
+    if (shell->parser.length == 0)
+    {
+        return;
+    }
+
+    shell->parser.buffer[shell->parser.length] = 0;
+#if SHELL_USING_CANCEL == 1
+    if (!shell->status.isActive)
+    {
+        shell->info.cancelled = 0;
+    }
+#endif
+
+    if (shell->status.isChecked)
+    {
+    #if SHELL_ARENA_SIZE > 0
+        unsigned short mark = shell->arena.used;
+    #endif
+    #if SHELL_HISTORY_MAX_NUMBER > 0
+        shellHistoryAdd(shell);
+    #endif /** SHELL_HISTORY_MAX_NUMBER > 0 */
+    #if SHELL_EXEC_CACHE_SIZE > 0
+        ShellCommand *command = shellExecCacheParse(shell);
+    #else
+        shellParserParam(shell);
+    #endif
+        shell->parser.length = shell->parser.cursor = 0;
+    #if SHELL_USING_JOBS == 1
+        char isBackground = shellParserBackground(shell);
+    #endif
+        if (shell->parser.paramCount == 0)
+        {
+        #if SHELL_ARENA_SIZE > 0
+            shell->arena.used = mark;
+        #endif
+            return;
+        }
+        shellWriteString(shell, "\r\n");
+
+    #if SHELL_EXEC_CACHE_SIZE > 0
+        if (command == NULL)
+        {
+            command = shellSeekCommand(shell,
+                                       shell->parser.param[0],
+                                       shell->commandList.base,
+                                       0);
+            shellExecCacheSet(shell, command);
+        }
+    #else
+        ShellCommand *command = shellSeekCommand(shell,
+                                                 shell->parser.param[0],
+                                                 shell->commandList.base,
+                                                 0);
+    #endif
+    #if SHELL_DYNAMIC_CMD_NUMBER > 0
+        ShellCmdDynamicTables *tables = NULL;
+        if (command == NULL && (tables = shellCmdDynamicEnter(shell)) != NULL)
+        {
+            command = shellCmdDynamicSeek(shell, shell->parser.param[0]);
+        }
+    #endif
+    #if SHELL_USING_JOBS == 1
+        if (command != NULL && isBackground)
+        {
+        #if SHELL_EXEC_CACHE_SIZE > 0
+            shell->execCache.current = NULL;
+        #endif
+            if (shell->background
+                && command->attr.attrs.type <= SHELL_TYPE_CMD_FUNC
+            #if SHELL_DYNAMIC_CMD_NUMBER > 0
+                && tables == NULL
+            #endif
+                )
+            {
+                shell->background(shell, command);
+            }
+            else
+            {
+                shellWriteString(shell, shellText[SHELL_TEXT_BACKGROUND_FAILED]);
+            }
+        }
+        else
+    #endif
+        if (command != NULL)
+        {
+            shellRunCommand(shell, command);
+        #if SHELL_EXEC_CACHE_SIZE > 0
+            shell->execCache.current = NULL;
+        #endif
+        }
+        else
+        {
+            shellWriteString(shell, shellText[SHELL_TEXT_CMD_NOT_FOUND]);
+        }
+    #if SHELL_DYNAMIC_CMD_NUMBER > 0
+        if (tables != NULL)
+        {
+            shellCmdDynamicExit(shell);
+        }
+    #endif
+    #if SHELL_ARENA_SIZE > 0
+        shell->arena.used = mark;
+    #endif
+    }
+    else
+    {
+        shellCheckPassword(shell);
+    }
+}
+
+
+#if SHELL_HISTORY_MAX_NUMBER > 0
+/**
+ * @brief shell上方向键输入
+ * 
+ * @param shell shell对象
+ */
+void shellUp(Shell *shell)
+{
+    shellHistory(shell, 1);
+}
+SHELL_EXPORT_KEY(SHELL_CMD_PERMISSION(0), 0x1B5B4100, shellUp, up);
+
+
+/**
+ * @brief shell下方向键输入
+ * 
+ * @param shell shell对象
+ */
+void shellDown(Shell *shell)
+{
+    shellHistory(shell, -1);
+}
+SHELL_EXPORT_KEY(SHELL_CMD_PERMISSION(0), 0x1B5B4200, shellDown, down);
+
+
+#if SHELL_HISTORY_SEARCH_LENGTH > 0
+/**
+ * @brief shell 历史记录反向搜索(Ctrl-R)
+ * 
+ * @param shell shell对象
+ */
+void shellSearch(Shell *shell)
+{
+    shell->history.search.active = 1;
+    shell->history.search.length = 0;
+    shell->history.search.pattern[0] = 0;
+    shell->history.search.match[0] = shell->history.used;
+    shellHistorySearchShow(shell);
+}
+SHELL_EXPORT_KEY(SHELL_CMD_PERMISSION(0), 0x12000000, shellSearch, search);
+#endif /** SHELL_HISTORY_SEARCH_LENGTH > 0 */
+#endif /** SHELL_HISTORY_MAX_NUMBER > 0 */
+
+
+/**
+ * @brief shell右方向键输入
+ * 
+ * @param shell shell对象
+ */
+void shellRight(Shell *shell)
+{
+    if (shell->parser.cursor < shell->parser.length)
+    {
+        shellWriteByte(shell, shell->parser.buffer[shell->parser.cursor++]);
+    }
+}
+SHELL_EXPORT_KEY(SHELL_CMD_PERMISSION(0)|SHELL_CMD_ENABLE_UNCHECKED,
+0x1B5B4300, shellRight, right);
+
+
+/**
+ * @brief shell左方向键输入
+ * 
+ * @param shell shell对象
+ */
+void shellLeft(Shell *shell)
+{
+    if (shell->parser.cursor > 0)
+    {
+        shellWriteByte(shell, '\b');
+        shell->parser.cursor--;
+    }
+}
+SHELL_EXPORT_KEY(SHELL_CMD_PERMISSION(0)|SHELL_CMD_ENABLE_UNCHECKED,
+0x1B5B4400, shellLeft, left);
+
+
+/**
+ * @brief shell tab补全匹配结果
+ */
+typedef struct
+{
+    ShellCommand *first;                                /**< 第一个匹配的命令 */
+    unsigned short count;                               /**< 匹配数量 */
+    unsigned short length;                              /**< 所有匹配的公共前缀长度 */
+} ShellTabMatch;
+
+
+/**
+ * @brief shell tab补全检查候选命令
+ * 
+ * @param shell shell对象
+ * @param command 候选命令
+ * @param match 匹配结果
+ * @param list 是否列出匹配的命令
+ */
+static void shellTabCheck(Shell *shell, ShellCommand *command,
+                          ShellTabMatch *match, unsigned char list)
+{
+    const char *name;
+    unsigned short length;
+
+    if (command->attr.attrs.type >= SHELL_TYPE_USER
+        || shellCheckPermission(shell, command) != 0)
+    {
+        return;
+    }
+    name = shellGetCommandName(command);
+    if (strncmp(name, shell->parser.buffer, shell->parser.length) != 0)
+    {
+        return;
+    }
+    if (list)
+    {
+        shellListItem(shell, command);
+    }
+    if (match->count == 0)
+    {
+        match->first = command;
+        match->length = strlen(name);
+    }
+    else
+    {
+        length = shellStringCompare((char *)shellGetCommandName(match->first), (char *)name);
+        match->length = (match->length > length) ? length : match->length;
+    }
+    match->count++;
+}
+
+
+#if SHELL_DYNAMIC_CMD_NUMBER > 0
+/**
+ * @brief shell tab补全匹配动态命令表
+ *        只在读者临界区中匹配
+ * 
+ * @param shell shell对象
+ * @param match 匹配结果
+ * @param list 是否列出匹配的命令
+ */
+static void shellTabMatchDynamic(Shell *shell, ShellTabMatch *match, unsigned char list)
+{
+    ShellCommand *command;
+
+    for (unsigned short i = 0; (command = shellCmdDynamicGet(shell, i)) != NULL; i++)
+    {
+        if (command->attr.attrs.type <= SHELL_TYPE_CMD_FUNC)
+        {
+            shellTabCheck(shell, command, match, list);
+        }
+    }
+}
+#endif /** SHELL_DYNAMIC_CMD_NUMBER > 0 */
+
+
+/**
+ * @brief shell tab补全匹配
+ *        只匹配命令和变量，命令索引或者排序命令段可用时，
+ *        通过二分查找得到匹配前缀的范围，只需要检查范围内的命令
+ * 
+ * @param shell shell对象
+ * @param match 匹配结果
+ * @param list 是否列出匹配的命令
+ */
+static void shellTabMatch(Shell *shell, ShellTabMatch *match, unsigned char list)
+{
+    ShellCommand *base = (ShellCommand *)shell->commandList.base;
+    unsigned short first = 0;
+    unsigned short last = shell->commandList.count;
+
+    match->count = 0;
+#if SHELL_CMD_INDEX_SIZE > 0
+    if (base == shellCmdIndex.base)
+    {
+        first = shellCmdIndexBound(shell->parser.buffer, shell->parser.length, 0);
+        last = shellCmdIndexBound(shell->parser.buffer, shell->parser.length, 1);
+        for (unsigned short i = first; i < last; i++)
+        {
+            shellTabCheck(shell, &base[shellCmdIndex.order[i]], match, list);
+        }
+    #if SHELL_DYNAMIC_CMD_NUMBER > 0
+        shellTabMatchDynamic(shell, match, list);
+    #endif
+        return;
+    }
+#endif /** SHELL_CMD_INDEX_SIZE > 0 */
+#if SHELL_CMD_SORTED_SECTION == 1
+    for (unsigned short i = 0; i < shell->commandList.sorted; i++)
+    {
+        shellTabCheck(shell, &base[i], match, list);
+    }
+    first = shellCmdSortedBound(shell, shell->parser.buffer, shell->parser.length, 0);
+    last = shellCmdSortedBound(shell, shell->parser.buffer, shell->parser.length, 1);
+#endif /** SHELL_CMD_SORTED_SECTION == 1 */
+    for (unsigned short i = first; i < last; i++)
+    {
+        shellTabCheck(shell, &base[i], match, list);
+    }
+#if SHELL_DYNAMIC_CMD_NUMBER > 0
+    shellTabMatchDynamic(shell, match, list);
+#endif
+}
+
+
+/**
+ * @brief shell Tab按键处理
+ * 
+ * @param shell shell对象
+ */
+void shellTab(Shell *shell)
+{
+    ShellTabMatch match;
+    unsigned short matchNum = 0;
+
+    if (shell->parser.length == 0)
+    {
+        shellListAll(shell);
+        shellWritePrompt(shell, 1);
+    }
+    else if (shell->parser.length > 0)
+    {
+    #if SHELL_DYNAMIC_CMD_NUMBER > 0
+        ShellCmdDynamicTables *tables = shellCmdDynamicEnter(shell);
+    #endif
+        shell->parser.buffer[shell->parser.length] = 0;
+        shellTabMatch(shell, &match, 0);
+        matchNum = match.count;
+        if (matchNum == 0)
+        {
+        #if SHELL_DYNAMIC_CMD_NUMBER > 0
+            if (tables != NULL)
+            {
+                shellCmdDynamicExit(shell);
+            }
+        #endif
+            return;
+        }
+        if (matchNum == 1)
+        {
+            shellReplaceCommandLine(shell, shellGetCommandName(match.first));
+        }
+        else
+        {
+            shellWriteString(shell, "\r\n");
+            shellTabMatch(shell, &match, 1);
+            shellWritePrompt(shell, 1);
+            shellStringCopy(shell->parser.buffer, (char *)shellGetCommandName(match.first));
+            shell->parser.length = match.length;
+            shell->parser.buffer[shell->parser.length] = 0;
+            shell->parser.cursor = shell->parser.length;
+            shellWriteString(shell, shell->parser.buffer);
+        }
+    #if SHELL_DYNAMIC_CMD_NUMBER > 0
+        if (tables != NULL)
+        {
+            shellCmdDynamicExit(shell);
+        }
+    #endif
+    }
+
+    if (SHELL_GET_TICK())
+    {
+        if (matchNum == 1
+            && shell->status.tabFlag
+            && SHELL_GET_TICK() - shell->info.activeTime < SHELL_DOUBLE_CLICK_TIME)
+        {
+        #if SHELL_QUICK_HELP == 1
+            shellWriteString(shell, "\r\n");
+            shellWriteCommandHelp(shell, shell->parser.buffer);
+            shellWritePrompt(shell, 1);
+            shellWriteString(shell, shell->parser.buffer);
+        #else
+            shellClearCommandLine(shell);
+            for (short i = shell->parser.length; i >= 0; i--)
+            {
+                shell->parser.buffer[i + 5] = shell->parser.buffer[i];
+            }
+            shellStringCopy(shell->parser.buffer, "help");
+            shell->parser.buffer[4] = ' ';
+            shell->parser.length += 5;
+            shell->parser.cursor = shell->parser.length;
+            shellWriteString(shell, shell->parser.buffer);
+        #endif
+        }
+        else
+        {
+            shell->status.tabFlag = 1;
+        }
+    }
+}
+SHELL_EXPORT_KEY(SHELL_CMD_PERMISSION(0), 0x09000000, shellTab, tab);
+
+
+/**
+ * @brief shell 退格
+ * 
+ * @param shell shell对象
+ */
+void shellBackspace(Shell *shell)
+{
+    shellDeleteByte(shell, 1);
+}
+SHELL_EXPORT_KEY(SHELL_CMD_PERMISSION(0)|SHELL_CMD_ENABLE_UNCHECKED,
+0x08000000, shellBackspace, backspace);
+SHELL_EXPORT_KEY(SHELL_CMD_PERMISSION(0)|SHELL_CMD_ENABLE_UNCHECKED,
+0x7F000000, shellBackspace, backspace);
+
+
+/**
+ * @brief shell 删除
+ * 
+ * @param shell shell对象
+ */
+void shellDelete(Shell *shell)
+{
+    shellDeleteByte(shell, -1);
+}
+SHELL_EXPORT_KEY(SHELL_CMD_PERMISSION(0)|SHELL_CMD_ENABLE_UNCHECKED,
+0x1B5B337E, shellDelete, delete);
+
+
+/**
+ * @brief shell 回车处理
+ * 
+ * @param shell shell对象
+ */
+void shellEnter(Shell *shell)
+{
+    shellExec(shell);
+    shellWritePrompt(shell, 1);
+}
+#if SHELL_ENTER_LF == 1
+SHELL_EXPORT_KEY(SHELL_CMD_PERMISSION(0)|SHELL_CMD_ENABLE_UNCHECKED,
+0x0A000000, shellEnter, enter);
+#endif
+#if SHELL_ENTER_CR == 1
+SHELL_EXPORT_KEY(SHELL_CMD_PERMISSION(0)|SHELL_CMD_ENABLE_UNCHECKED,
+0x0D000000, shellEnter, enter);
+#endif
+#if SHELL_ENTER_CRLF == 1
+SHELL_EXPORT_KEY(SHELL_CMD_PERMISSION(0)|SHELL_CMD_ENABLE_UNCHECKED,
+0x0D0A0000, shellEnter, enter);
+#endif
+
+/**
+ * @brief shell 写命令帮助信息
+ * 
+ * @param shell shell对象
+ * @param cmd 命令字符串
+ */
+static void shellWriteCommandHelp(Shell *shell, char *cmd)
+{
+    ShellCommand *command = shellSeekCommand(shell,
+                                             cmd,
+                                             shell->commandList.base,
+                                             0);
+#if SHELL_DYNAMIC_CMD_NUMBER > 0
+    ShellCmdDynamicTables *tables = NULL;
+    if (command == NULL && (tables = shellCmdDynamicEnter(shell)) != NULL)
+    {
+        command = shellCmdDynamicSeek(shell, cmd);
+    }
+#endif
+    if (command)
+    {
+        shellWriteString(shell, shellText[SHELL_TEXT_HELP_HEADER]);
+        shellWriteString(shell, shellGetCommandName(command));
+        shellWriteString(shell, "\r\n");
+#if SHELL_DESC_STRIP == 1
+        shellWriteDescId(shell, shellGetCommandDesc(command), 0);
+#else
+        shellWriteString(shell, shellGetCommandDesc(command));
+#endif
+        shellWriteString(shell, "\r\n");
+    }
+    else
+    {
+        shellWriteString(shell, shellText[SHELL_TEXT_CMD_NOT_FOUND]);
+    }
+#if SHELL_DYNAMIC_CMD_NUMBER > 0
+    if (tables != NULL)
+    {
+        shellCmdDynamicExit(shell);
+    }
+#endif
+}
+
+/**
+ * @brief shell help
+ * 
+ * @param argc 参数个数
+ * @param argv 参数
+ */
+void shellHelp(int argc, char *argv[])
+{
+    Shell *shell = shellGetCurrent();
+    SHELL_ASSERT(shell, return);
+    if (argc == 1)
+    {
+        shellListAll(shell);
+    }
+    else if (argc > 1)
+    {
+        shellWriteCommandHelp(shell, argv[1]);
+    }
+}
+SHELL_EXPORT_CMD(
+SHELL_CMD_PERMISSION(0)|SHELL_CMD_TYPE(SHELL_TYPE_CMD_MAIN)|SHELL_CMD_DISABLE_RETURN,
+help, shellHelp, show command info\r\nhelp [cmd]);
 
 /**
- * @brief shell变量输出
+ * @brief shell 建立按键首字节位图
  * 
  * @param shell shell对象
- * @param command 命令
- * @return int 返回变量值
  */
-static int shellShowVar(Shell *shell, ShellCommand *command)
+static void shellKeyFirstBuild(Shell *shell)
 {
-    char buffer[12] = "00000000000";
-    int value = shellGetVarValue(shell, command);
-    
-    shellWriteString(shell, command->data.var.name);
-    shellWriteString(shell, " = ");
+    ShellCommand *base = (ShellCommand *)shell->commandList.base;
+    unsigned char byte;
 
-    switch (command->attr.attrs.type)
+    if (shellKeyFirst.base == base && shellKeyFirst.count == shell->commandList.count)
     {
-    case SHELL_TYPE_VAR_STRING:
-        shellWriteString(shell, "\"");
-        shellWriteString(shell, (char *) (size_t) value);
-        shellWriteString(shell, "\"");
-        break;
-    // case SHELL_TYPE_VAR_INT:
-    // case SHELL_TYPE_VAR_SHORT:
-    // case SHELL_TYPE_VAR_CHAR:
-    // case SHELL_TYPE_VAR_POINT:
-    default:
-        shellWriteString(shell, &buffer[11 - shellToDec(value, buffer)]);
-        shellWriteString(shell, ", 0x");
-        for (short i = 0; i < 11; i++)
+        return;
+    }
+    for (unsigned char i = 0; i < 32; i++)
+    {
+        shellKeyFirst.map[i] = 0;
+    }
+    for (unsigned short i = 0; i < shell->commandList.count; i++)
+    {
+        if (base[i].attr.attrs.type != SHELL_TYPE_KEY)
         {
-            buffer[i] = '0';
+            continue;
         }
-        shellToHex(value, buffer);
-        shellWriteString(shell, buffer);
-        break;
+    #if SHELL_KEY_TRIE_SIZE > 0
+        if (shellGetKeySequence(&base[i]))
+        {
+            byte = shellGetKeySequence(&base[i])[0];
+        }
+        else
+    #endif
+        {
+            byte = (shellGetKeyValue(&base[i]) >> 24) & 0xFF;
+        }
+        shellKeyFirst.map[byte >> 3] |= 1 << (byte & 0x07);
     }
-
-    shellWriteString(shell, "\r\n");
-    return value;
+    shellKeyFirst.count = shell->commandList.count;
+    shellKeyFirst.base = base;
 }
 
 
 /**
- * @brief shell设置变量
+ * @brief shell 判断输入字节是否可能是按键的开始
  * 
- * @param name 变量名
- * @param value 变量值
- * @return int 返回变量值
+ * @param shell shell对象
+ * @param data 输入字节
+ * @return unsigned char 1 可能是按键 0 不是按键
  */
-int shellSetVar(char *name, int value)
+static unsigned char shellKeyIsFirst(Shell *shell, char data)
 {
-    Shell *shell = shellGetCurrent();
-    if (shell == NULL)
+    unsigned char byte = data;
+    if (shellKeyFirst.base != shell->commandList.base
+        || shellKeyFirst.count != shell->commandList.count)
     {
-        return 0;
+        return 1;
     }
-    ShellCommand *command = shellSeekCommand(shell,
-                                             name,
-                                             shell->commandList.base,
-                                             0);
-    if (!command)
+    return (shellKeyFirst.map[byte >> 3] & (1 << (byte & 0x07))) ? 1 : 0;
+}
+
+
+#if SHELL_KEY_TRIE_SIZE > 0
+/**
+ * @brief shell 获取按键序列
+ * 
+ * @param key 按键
+ * @param buffer 缓冲，用于展开按键键值，至少5字节
+ * @return const char* 按键序列
+ */
+static const char* shellKeyGetSequence(ShellCommand *key, char *buffer)
+{
+    const char *sequence = shellGetKeySequence(key);
+    int value = shellGetKeyValue(key);
+    if (sequence)
     {
-        shellWriteString(shell, shellText[SHELL_TEXT_VAR_NOT_FOUND]);
-        return 0;
+        return sequence;
     }
-    if (command->attr.attrs.type < SHELL_TYPE_VAR_INT
-        || command->attr.attrs.type > SHELL_TYPE_VAR_NODE)
+    for (unsigned char i = 0; i < 4; i++)
     {
-        shellWriteString(shell, name);
-        shellWriteString(shell, shellText[SHELL_TEXT_NOT_VAR]);
-        return 0;
+        buffer[i] = (value >> (24 - i * 8)) & 0xFF;
     }
-    return shellSetVarValue(shell, command, value);
+    buffer[4] = 0;
+    return buffer;
 }
-SHELL_EXPORT_CMD(
-SHELL_CMD_PERMISSION(0)|SHELL_CMD_TYPE(SHELL_TYPE_CMD_FUNC)|SHELL_CMD_DISABLE_RETURN,
-setVar, shellSetVar, set var);
 
 
 /**
- * @brief shell运行命令
+ * @brief shell 建立按键前缀树
+ *        命令表在各个shell之间共享，前缀树只会在命令表变化时重新建立
  * 
  * @param shell shell对象
- * @param command 命令
- * 
- * @return unsigned int 命令返回值
  */
-unsigned int shellRunCommand(Shell *shell, ShellCommand *command)
+static void shellKeyTrieBuild(Shell *shell)
 {
-    int returnValue = 0;
-    shell->status.isActive = 1;
-    if (command->attr.attrs.type == SHELL_TYPE_CMD_MAIN)
+    ShellCommand *base = (ShellCommand *)shell->commandList.base;
+    unsigned short used = 1;
+    unsigned short node = 0;
+    unsigned short *link;
+    const char *sequence;
+    char buffer[5];
+
+    if (shellKeyTrie.base == base && shellKeyTrie.count == shell->commandList.count)
     {
-        shellRemoveParamQuotes(shell);
-        int (*func)(int, char **) =
-            (int (*)(int, char **))command->data.cmd.function;
-        returnValue = func(shell->parser.paramCount, shell->parser.param);
-        if (!command->attr.attrs.disableReturn)
+        return;
+    }
+    shellKeyTrie.base = NULL;
+    shellKeyTrie.root = 0;
+    for (unsigned short i = 0; i < shell->commandList.count; i++)
+    {
+        if (base[i].attr.attrs.type != SHELL_TYPE_KEY)
         {
-            shellWriteReturnValue(shell, returnValue);
+            continue;
+        }
+        sequence = shellKeyGetSequence(&base[i], buffer);
+        if (*sequence == 0)
+        {
+            continue;
+        }
+        link = &shellKeyTrie.root;
+        for (; *sequence; sequence++)
+        {
+            node = *link;
+            while (node != 0 && shellKeyTrie.node[node].byte != (unsigned char)*sequence)
+            {
+                node = shellKeyTrie.node[node].sibling;
+            }
+            if (node == 0)
+            {
+                if (used >= SHELL_KEY_TRIE_SIZE)
+                {
+                    return;
+                }
+                node = used++;
+                shellKeyTrie.node[node].byte = *sequence;
+                shellKeyTrie.node[node].child = 0;
+                shellKeyTrie.node[node].key = 0;
+                shellKeyTrie.node[node].sibling = *link;
+                *link = node;
+            }
+            link = &shellKeyTrie.node[node].child;
+        }
+        /* 相同的按键序列只记录第一个，匹配时再按照命令表顺序检查权限 */
+        if (shellKeyTrie.node[node].key == 0)
+        {
+            shellKeyTrie.node[node].key = i + 1;
         }
     }
-    else if (command->attr.attrs.type == SHELL_TYPE_CMD_FUNC)
+    shellKeyTrie.count = shell->commandList.count;
+    shellKeyTrie.base = base;
+}
+
+
+/**
+ * @brief shell 按键前缀树匹配
+ *        `shell->parser.keyValue`记录当前所在的节点，匹配到终止节点时执行按键函数，
+ *        终止节点优先，较短的按键序列会屏蔽以其为前缀的较长序列
+ * 
+ * @param shell shell对象
+ * @param data 输入数据
+ * @return char 未被按键消耗的输入数据，0表示输入已被按键消耗
+ */
+static char shellKeyTrieInput(Shell *shell, char data)
+{
+    unsigned char byte = data;
+    unsigned short node;
+    ShellCommand *key;
+    char buffer[2][5];
+    const char *sequence;
+
+    if (shell->parser.keyValue == 0)
     {
-        returnValue = shellExtRun(shell,
-                                  command,
-                                  shell->parser.paramCount,
-                                  shell->parser.param);
-        if (!command->attr.attrs.disableReturn)
+        if (!shellKeyIsFirst(shell, data))
         {
-            shellWriteReturnValue(shell, returnValue);
+            return data;
         }
+        node = shellKeyTrie.root;
     }
-    else if (command->attr.attrs.type >= SHELL_TYPE_VAR_INT
-        && command->attr.attrs.type <= SHELL_TYPE_VAR_NODE)
+    else
     {
-        shellShowVar(shell, command);
+        node = shellKeyTrie.node[shell->parser.keyValue].child;
     }
-    else if (command->attr.attrs.type == SHELL_TYPE_USER)
+    while (node != 0 && shellKeyTrie.node[node].byte != byte)
     {
-        shellSetUser(shell, command);
+        node = shellKeyTrie.node[node].sibling;
+    }
+    if (node == 0)
+    {
+        shell->parser.keyValue = 0;
+        return data;
+    }
+    if (shellKeyTrie.node[node].key == 0)
+    {
+        shell->parser.keyValue = node;
+        return 0;
     }
-    shell->status.isActive = 0;
 
-    return returnValue;
+    shell->parser.keyValue = 0;
+    key = &shellKeyTrie.base[shellKeyTrie.node[node].key - 1];
+    sequence = shellKeyGetSequence(key, buffer[0]);
+    for (unsigned short i = shellKeyTrie.node[node].key - 1; i < shellKeyTrie.count; i++, key++)
+    {
+        if (key->attr.attrs.type == SHELL_TYPE_KEY
+            && shellCheckPermission(shell, key) == 0
+            && strcmp(sequence, shellKeyGetSequence(key, buffer[1])) == 0)
+        {
+            if (key->data.key.function)
+            {
+                key->data.key.function(shell);
+            }
+            return 0;
+        }
+    }
+    return data;
 }
+#endif /** SHELL_KEY_TRIE_SIZE > 0 */
 
 
 /**
- * @brief shell校验密码
+ * @brief shell 单字节输入处理(不加锁)
  * 
  * @param shell shell对象
+ * @param data 输入数据
  */
-static void shellCheckPassword(Shell *shell)
+static void shellHandlerByte(Shell *shell, char data)
 {
-    if (strcmp(shell->parser.buffer, shell->info.user->data.user.password) == 0)
+#if SHELL_HISTORY_SEARCH_LENGTH > 0
+    if (shell->history.search.active && shellHistorySearchInput(shell, data))
     {
-        shell->status.isChecked = 1;
-    #if SHELL_SHOW_INFO == 1
-        shellWriteString(shell, shellText[SHELL_TEXT_INFO]);
-    #endif
+        return;
+    }
+#endif
+#if SHELL_KEY_TRIE_SIZE > 0
+    if (shellKeyTrie.base == shell->commandList.base)
+    {
+        data = shellKeyTrieInput(shell, data);
+        if (data != 0x00)
+        {
+            shellNormalInput(shell, data);
+        }
     }
     else
     {
-        shellWriteString(shell, shellText[SHELL_TEXT_PASSWORD_ERROR]);
+#endif
+    /* 根据记录的按键键值计算当前字节在按键键值中的偏移 */
+    char keyByteOffset = 24;
+    int keyFilter = 0x00000000;
+    if ((shell->parser.keyValue & 0x0000FF00) != 0x00000000)
+    {
+        keyByteOffset = 0;
+        keyFilter = 0xFFFFFF00;
     }
-    shell->parser.length = 0;
-    shell->parser.cursor = 0;
+    else if ((shell->parser.keyValue & 0x00FF0000) != 0x00000000)
+    {
+        keyByteOffset = 8;
+        keyFilter = 0xFFFF0000;
+    }
+    else if ((shell->parser.keyValue & 0xFF000000) != 0x00000000)
+    {
+        keyByteOffset = 16;
+        keyFilter = 0xFF000000;
+    }
+
+    /* 遍历ShellCommand列表，尝试进行按键键值匹配 */
+    ShellCommand *base = (ShellCommand *)shell->commandList.base;
+    for (short i = 0; i < shell->commandList.count; i++)
+    {
+        /* 判断是否是按键定义并验证权限 */
+        if (base[i].attr.attrs.type == SHELL_TYPE_KEY
+            && shellCheckPermission(shell, &(base[i])) == 0)
+        {
+            /* 对输入的字节同按键键值进行匹配 */
+            int value = shellGetKeyValue(&base[i]);
+            if ((value & keyFilter) == shell->parser.keyValue
+                && (value & (0xFF << keyByteOffset))
+                    == (data << keyByteOffset))
+            {
+                shell->parser.keyValue |= data << keyByteOffset;
+                data = 0x00;
+                if (keyByteOffset == 0 
+                    || (value & (0xFF << (keyByteOffset - 8)))
+                        == 0x00000000)
+                {
+                    if (base[i].data.key.function)
+                    {
+                        base[i].data.key.function(shell);
+                    }
+                    shell->parser.keyValue = 0x00000000;
+                    break;
+                }
+            }
+        }
+    }
+
+    if (data != 0x00)
+    {
+        shell->parser.keyValue = 0x00000000;
+        shellNormalInput(shell, data);
+    }
+#if SHELL_KEY_TRIE_SIZE > 0
+    }
+#endif
 }
 
 
 /**
- * @brief shell设置用户
+ * @brief shell 输入处理前检查自动锁定
  * 
  * @param shell shell对象
- * @param user 用户
  */
-void shellSetUser(Shell *shell, const ShellCommand *user)
+static void shellHandlerCheckTimeout(Shell *shell)
 {
-    shell->info.user = user;
-    shell->status.isChecked = 
-        ((user->data.user.password && strlen(user->data.user.password) != 0)
-            && (shell->parser.paramCount < 2
-                || strcmp(user->data.user.password, shell->parser.param[1]) != 0))
-         ? 0 : 1;
-        
-#if SHELL_CLS_WHEN_LOGIN == 1
-    shellWriteString(shell, shellText[SHELL_TEXT_CLEAR_CONSOLE]);
-#endif
-#if SHELL_SHOW_INFO == 1
-    if (shell->status.isChecked)
+#if SHELL_LOCK_TIMEOUT > 0
+    if (shell->info.user->data.user.password
+        && shell->info.user->data.user.password[0] != 0
+        && SHELL_GET_TICK())
     {
-        shellWriteString(shell, shellText[SHELL_TEXT_INFO]);
+        if (SHELL_GET_TICK() - shell->info.activeTime > SHELL_LOCK_TIMEOUT)
+        {
+            shell->status.isChecked = 0;
+        }
     }
+#else
+    (void)shell;
 #endif
 }
 
 
+#if SHELL_SUPPORT_END_LINE == 1 || SHELL_SUBMIT_QUEUE_SIZE > 0
 /**
- * @brief shell写返回值
+ * @brief shell 重新输出提示符和正在输入的命令行(调用者持有输出锁)
  * 
  * @param shell shell对象
- * @param value 返回值
  */
-static void shellWriteReturnValue(Shell *shell, int value)
+static void shellPutCommandLine(Shell *shell)
 {
-    char buffer[12] = "00000000000";
-    shellWriteString(shell, "Return: ");
-    shellWriteString(shell, &buffer[11 - shellToDec(value, buffer)]);
-    shellWriteString(shell, ", 0x");
-    for (short i = 0; i < 11; i++)
+    shellPutPrompt(shell, 0);
+    if (shell->parser.length > 0)
     {
-        buffer[i] = '0';
-    }
-    shellToHex(value, buffer);
-    shellWriteString(shell, buffer);
-    shellWriteString(shell, "\r\n");
-#if SHELL_KEEP_RETURN_VALUE == 1
-    shell->info.retVal = value;
+        shellPutString(shell, shell->parser.buffer);
+        shellPutCursor(shell, shell->parser.length, shell->parser.cursor);
+    }
+}
 #endif
+
+
+#if SHELL_SUBMIT_QUEUE_SIZE > 0
+/**
+ * @brief shell 开始处理输入
+ *        获取编辑锁，并在输出锁内标记正在处理输入，此后`shellWriteEndLine()`不再读取命令行，
+ *        只记录需要重绘，由`shellHandlerExit()`重绘
+ * 
+ * @param shell shell对象
+ */
+static void shellHandlerEnter(Shell *shell)
+{
+    SHELL_LOCK(shell);
+    shell->status.isLocked = 1;
+    shellWriteLock(shell);
+    shell->output.inHandler = 1;
+    shellWriteUnlock(shell);
 }
+#endif
 
 
-#if SHELL_HISTORY_MAX_NUMBER > 0
 /**
- * @brief shell历史记录添加
+ * @brief shell 尝试开始处理输入
+ *        命令执行期间，命令参数仍然指向命令行缓冲，其他任务的输入不会被处理
  * 
  * @param shell shell对象
+ * 
+ * @return int 0 开始处理输入 -1 shell正在执行命令
  */
-static void shellHistoryAdd(Shell *shell)
+static int shellHandlerTryEnter(Shell *shell)
 {
-    shell->history.offset = 0;
-    if (shell->history.number > 0
-        && strcmp(shell->history.item[(shell->history.record == 0 ? 
-                SHELL_HISTORY_MAX_NUMBER : shell->history.record) - 1],
-                shell->parser.buffer) == 0)
-    {
-        return;
-    }
-    if (shellStringCopy(shell->history.item[shell->history.record],
-                        shell->parser.buffer) != 0)
-    {
-        shell->history.record++;
-    }
-    if (++shell->history.number > SHELL_HISTORY_MAX_NUMBER)
-    {
-        shell->history.number = SHELL_HISTORY_MAX_NUMBER;
-    }
-    if (shell->history.record >= SHELL_HISTORY_MAX_NUMBER)
+    SHELL_LOCK(shell);
+    if (shell->status.isActive)
     {
-        shell->history.record = 0;
+        SHELL_UNLOCK(shell);
+        return -1;
     }
+    shell->status.isLocked = 1;
+    shellWriteLock(shell);
+    shell->output.inHandler = 1;
+    shellWriteUnlock(shell);
+    return 0;
 }
 
 
 /**
- * @brief shell历史记录查找
+ * @brief shell 结束处理输入
+ *        处理期间有尾行输出时重绘命令行，输出缓冲，释放编辑锁
  * 
  * @param shell shell对象
- * @param dir 方向 {@code <0}往上查找 {@code >0}往下查找
  */
-static void shellHistory(Shell *shell, signed char dir)
+static void shellHandlerExit(Shell *shell)
 {
-    if (dir > 0)
-    {
-        if (shell->history.offset-- <= 
-            -((shell->history.number > shell->history.record) ?
-                shell->history.number : shell->history.record))
-        {
-            shell->history.offset = -((shell->history.number > shell->history.record)
-                                    ? shell->history.number : shell->history.record);
-        }
-    }
-    else if (dir < 0)
+    shellWriteLock(shell);
+    shell->output.inHandler = 0;
+#if SHELL_SUPPORT_END_LINE == 1
+    if (shell->output.redrawPending)
     {
-        if (++shell->history.offset > 0)
+        shell->output.redrawPending = 0;
+        if (!shell->status.isActive)
         {
-            shell->history.offset = 0;
-            return;
+            shellPutString(shell, shellText[SHELL_TEXT_CLEAR_LINE]);
+            shellPutCommandLine(shell);
         }
     }
-    else
-    {
-        return;
-    }
-    shellClearCommandLine(shell);
-    if (shell->history.offset == 0)
-    {
-        shell->parser.cursor = shell->parser.length = 0;
-    }
-    else
+#endif
+    if (shell->output.block == 0)
     {
-        if ((shell->parser.length = shellStringCopy(shell->parser.buffer,
-                shell->history.item[(shell->history.record + SHELL_HISTORY_MAX_NUMBER
-                    + shell->history.offset) % SHELL_HISTORY_MAX_NUMBER])) == 0)
-        {
-            return;
-        }
-        shell->parser.cursor = shell->parser.length;
-        shellWriteString(shell, shell->parser.buffer);
+        shellPutFlush(shell);
     }
-    
+    shellWriteUnlock(shell);
+    shell->status.isLocked = 0;
+    SHELL_UNLOCK(shell);
 }
-#endif /** SHELL_HISTORY_MAX_NUMBER > 0 */
 
 
 /**
- * @brief shell 常规输入
+ * @brief shell 输入处理
+ *        shell正在执行命令时，输入数据不会被处理，由调用者决定丢弃或者稍后重新输入，
+ *        需要在命令执行期间输入时，使用`shellFeed()`
  * 
- * @param shell shell 对象
- * @param data 输入字符
+ * @param shell shell对象
+ * @param data 输入数据
+ * 
+ * @return int 0 处理成功 -1 shell正在执行命令，数据未处理
  */
-void shellNormalInput(Shell *shell, char data)
+int shellHandler(Shell *shell, char data)
 {
-    shell->status.tabFlag = 0;
-    shellInsertByte(shell, data);
+    SHELL_ASSERT(data, return 0);
+    if (shellHandlerTryEnter(shell) != 0)
+    {
+        return -1;
+    }
+    shellHandlerCheckTimeout(shell);
+
+    shellHandlerByte(shell, data);
+
+    if (SHELL_GET_TICK())
+    {
+        shell->info.activeTime = SHELL_GET_TICK();
+    }
+    shellHandlerExit(shell);
+    return 0;
 }
 
 
 /**
- * @brief shell运行命令
+ * @brief shell 块输入处理
+ *        整块数据只加锁一次，光标位于行尾时，连续的可打印字符直接插入命令行，并一次性回显，
+ *        shell正在执行命令时，输入数据不会被处理
  * 
  * @param shell shell对象
+ * @param data 输入数据
+ * @param len 数据长度
+ * 
+ * @return unsigned short 处理的数据长度，shell正在执行命令时返回0
  */
-void shellExec(Shell *shell)
+unsigned short shellHandlerBlock(Shell *shell, const char *data, unsigned short len)
 {
-    
-    if (shell->parser.length == 0)
+    unsigned short run;
+    unsigned short room;
+    unsigned short count = len;
+
+    if (shellHandlerTryEnter(shell) != 0)
     {
-        return;
+        return 0;
     }
+    shellHandlerCheckTimeout(shell);
 
-    shell->parser.buffer[shell->parser.length] = 0;
-
-    if (shell->status.isChecked)
+    while (len > 0)
     {
-    #if SHELL_HISTORY_MAX_NUMBER > 0
-        shellHistoryAdd(shell);
-    #endif /** SHELL_HISTORY_MAX_NUMBER > 0 */
-        shellParserParam(shell);
-        shell->parser.length = shell->parser.cursor = 0;
-        if (shell->parser.paramCount == 0)
+        run = 0;
+        if (shell->parser.keyValue == 0
+            && shell->parser.cursor == shell->parser.length
+            && shell->parser.length < shell->parser.bufferSize - 1
+        #if SHELL_HISTORY_SEARCH_LENGTH > 0
+            && !shell->history.search.active
+        #endif
+            )
         {
-            return;
+            room = shell->parser.bufferSize - 1 - shell->parser.length;
+            while (run < len && run < room
+                   && data[run] >= 0x20 && data[run] <= 0x7E
+                   && !shellKeyIsFirst(shell, data[run]))
+            {
+                run++;
+            }
         }
-        shellWriteString(shell, "\r\n");
-
-        ShellCommand *command = shellSeekCommand(shell,
-                                                 shell->parser.param[0],
-                                                 shell->commandList.base,
-                                                 0);
-        if (command != NULL)
+        if (run > 0)
         {
-            shellRunCommand(shell, command);
+            shell->status.tabFlag = 0;
+            memcpy(shell->parser.buffer + shell->parser.length, data, run);
+            if (shell->status.isChecked)
+            {
+                shellWriteData(shell, shell->parser.buffer + shell->parser.length, run);
+            }
+            else
+            {
+                for (unsigned short i = 0; i < run; i++)
+                {
+                    shellWriteByte(shell, '*');
+                }
+            }
+            shell->parser.length += run;
+            shell->parser.cursor = shell->parser.length;
+            shell->parser.buffer[shell->parser.length] = 0;
         }
         else
         {
-            shellWriteString(shell, shellText[SHELL_TEXT_CMD_NOT_FOUND]);
+            if (*data != 0)
+            {
+                shellHandlerByte(shell, *data);
+            }
+            run = 1;
         }
+        data += run;
+        len -= run;
     }
-    else
+
+    if (SHELL_GET_TICK())
     {
-        shellCheckPassword(shell);
+        shell->info.activeTime = SHELL_GET_TICK();
     }
+    shellHandlerExit(shell);
+    return count;
 }
 
 
-#if SHELL_HISTORY_MAX_NUMBER > 0
+#if SHELL_SUPPORT_END_LINE == 1
 /**
- * @brief shell上方向键输入
+ * @brief shell 尾行输出数据(调用者持有输出锁)
+ *        命令未执行时，清除命令行，输出数据后重绘命令行，shell正在处理输入时，命令行由输入处理结束时重绘
  * 
  * @param shell shell对象
+ * @param buffer 数据
+ * @param len 数据长度
  */
-void shellUp(Shell *shell)
+static void shellPutEndLine(Shell *shell, const char *buffer, int len)
 {
-    shellHistory(shell, 1);
-}
-SHELL_EXPORT_KEY(SHELL_CMD_PERMISSION(0), 0x1B5B4100, shellUp, up);
-
+    if (!shell->status.isActive)
+    {
+        shellPutString(shell, shellText[SHELL_TEXT_CLEAR_LINE]);
+    }
+    shellPutData(shell, buffer, len);
 
-/**
- * @brief shell下方向键输入
- * 
- * @param shell shell对象
- */
-void shellDown(Shell *shell)
-{
-    shellHistory(shell, -1);
+    if (!shell->status.isActive)
+    {
+        if (shell->output.inHandler)
+        {
+            shell->output.redrawPending = 1;
+        }
+        else
+        {
+            shellPutCommandLine(shell);
+        }
+    }
+    shellPutFlush(shell);
 }
-SHELL_EXPORT_KEY(SHELL_CMD_PERMISSION(0), 0x1B5B4200, shellDown, down);
-#endif /** SHELL_HISTORY_MAX_NUMBER > 0 */
 
 
+#if SHELL_END_LINE_BUFFER > 0
 /**
- * @brief shell右方向键输入
+ * @brief shell 输出尾行合并缓冲中的数据(调用者持有输出锁)
  * 
  * @param shell shell对象
  */
-void shellRight(Shell *shell)
+static void shellEndLinePut(Shell *shell)
 {
-    if (shell->parser.cursor < shell->parser.length)
+    if (shell->endLine.length > 0)
     {
-        shellWriteByte(shell, shell->parser.buffer[shell->parser.cursor++]);
+        shellPutEndLine(shell, shell->endLine.buffer, shell->endLine.length);
+        shell->endLine.length = 0;
     }
 }
-SHELL_EXPORT_KEY(SHELL_CMD_PERMISSION(0)|SHELL_CMD_ENABLE_UNCHECKED,
-0x1B5B4300, shellRight, right);
 
 
 /**
- * @brief shell左方向键输入
+ * @brief shell 处理尾行合并缓冲
+ *        在shell任务中调用，缓冲中的数据到达合并时间后输出
  * 
  * @param shell shell对象
+ * 
+ * @return int 距离下一次需要输出的时间，缓冲为空时返回-1
  */
-void shellLeft(Shell *shell)
+int shellEndLineHandler(Shell *shell)
 {
-    if (shell->parser.cursor > 0)
+    int remain = -1;
+
+    shellWriteLock(shell);
+    if (shell->endLine.length > 0)
     {
-        shellWriteByte(shell, '\b');
-        shell->parser.cursor--;
+        remain = SHELL_END_LINE_DELAY - (SHELL_GET_TICK() - shell->endLine.time);
+        if (!SHELL_GET_TICK() || remain <= 0)
+        {
+            shellEndLinePut(shell);
+            remain = -1;
+        }
     }
+    shellWriteUnlock(shell);
+    return remain;
 }
-SHELL_EXPORT_KEY(SHELL_CMD_PERMISSION(0)|SHELL_CMD_ENABLE_UNCHECKED,
-0x1B5B4400, shellLeft, left);
+#endif /** SHELL_END_LINE_BUFFER > 0 */
 
 
 /**
- * @brief shell Tab按键处理
+ * @brief shell 尾行输出
+ *        只使用输出锁，命令执行时不会被阻塞，使用`SHELL_END_LINE_BUFFER`时，输出先写入合并缓冲，
+ *        多条输出只需要清除和重绘一次命令行，可以在多个线程中调用
+ * @note 不能在输出块中调用
  * 
  * @param shell shell对象
+ * @param buffer 数据
+ * @param len 数据长度
  */
-void shellTab(Shell *shell)
+void shellWriteEndLine(Shell *shell, char *buffer, int len)
 {
-    unsigned short maxMatch = shell->parser.bufferSize;
-    unsigned short lastMatchIndex = 0;
-    unsigned short matchNum = 0;
-    unsigned short length;
+#if SHELL_END_LINE_BUFFER > 0
+    unsigned char notify = 0;
+#endif
 
-    if (shell->parser.length == 0)
-    {
-        shellListAll(shell);
-        shellWritePrompt(shell, 1);
-    }
-    else if (shell->parser.length > 0)
+    shellWriteLock(shell);
+#if SHELL_END_LINE_BUFFER > 0
+    if (!shell->status.isActive && len <= SHELL_END_LINE_BUFFER)
     {
-        shell->parser.buffer[shell->parser.length] = 0;
-        ShellCommand *base = (ShellCommand *)shell->commandList.base;
-        for (short i = 0; i < shell->commandList.count; i++)
-        {
-            if (shellCheckPermission(shell, &base[i]) == 0
-                && shellStringCompare(shell->parser.buffer,
-                                   (char *)shellGetCommandName(&base[i]))
-                        == shell->parser.length)
-            {
-                if (matchNum != 0)
-                {
-                    if (matchNum == 1)
-                    {
-                        shellWriteString(shell, "\r\n");
-                    }
-                    shellListItem(shell, &base[lastMatchIndex]);
-                    length = 
-                        shellStringCompare((char *)shellGetCommandName(&base[lastMatchIndex]),
-                                           (char *)shellGetCommandName(&base[i]));
-                    maxMatch = (maxMatch > length) ? length : maxMatch;
-                }
-                lastMatchIndex = i;
-                matchNum++;
-            }
-        }
-        if (matchNum == 0)
-        {
-            return;
-        }
-        if (matchNum == 1)
-        {
-            shellClearCommandLine(shell);
-        }
-        if (matchNum != 0)
+        if (shell->endLine.length + len > SHELL_END_LINE_BUFFER)
         {
-            shell->parser.length = 
-                shellStringCopy(shell->parser.buffer,
-                                (char *)shellGetCommandName(&base[lastMatchIndex]));
+            shellEndLinePut(shell);
         }
-        if (matchNum > 1)
+        if (shell->endLine.length == 0)
         {
-            shellListItem(shell, &base[lastMatchIndex]);
-            shellWritePrompt(shell, 1);
-            shell->parser.length = maxMatch;
+            shell->endLine.time = SHELL_GET_TICK();
+            notify = 1;
         }
-        shell->parser.buffer[shell->parser.length] = 0;
-        shell->parser.cursor = shell->parser.length;
-        shellWriteString(shell, shell->parser.buffer);
-    }
-
-    if (SHELL_GET_TICK())
-    {
-        if (matchNum == 1
-            && shell->status.tabFlag
-            && SHELL_GET_TICK() - shell->info.activeTime < SHELL_DOUBLE_CLICK_TIME)
+        memcpy(shell->endLine.buffer + shell->endLine.length, buffer, len);
+        shell->endLine.length += len;
+        if (SHELL_GET_TICK()
+            && SHELL_GET_TICK() - shell->endLine.time >= SHELL_END_LINE_DELAY)
         {
-        #if SHELL_QUICK_HELP == 1
-            shellWriteString(shell, "\r\n");
-            shellWriteCommandHelp(shell, shell->parser.buffer);
-            shellWritePrompt(shell, 1);
-            shellWriteString(shell, shell->parser.buffer);
-        #else
-            shellClearCommandLine(shell);
-            for (short i = shell->parser.length; i >= 0; i--)
-            {
-                shell->parser.buffer[i + 5] = shell->parser.buffer[i];
-            }
-            shellStringCopy(shell->parser.buffer, "help");
-            shell->parser.buffer[4] = ' ';
-            shell->parser.length += 5;
-            shell->parser.cursor = shell->parser.length;
-            shellWriteString(shell, shell->parser.buffer);
-        #endif
+            shellEndLinePut(shell);
+            notify = 0;
         }
-        else
+        shellWriteUnlock(shell);
+        if (notify && shell->notify)
         {
-            shell->status.tabFlag = 1;
-        }
-    }
-}
-SHELL_EXPORT_KEY(SHELL_CMD_PERMISSION(0), 0x09000000, shellTab, tab);
-
-
-/**
- * @brief shell 退格
- * 
- * @param shell shell对象
- */
-void shellBackspace(Shell *shell)
-{
-    shellDeleteByte(shell, 1);
+            shell->notify(shell);
+        }
+        return;
+    }
+    shellEndLinePut(shell);
+#endif
+    shellPutEndLine(shell, buffer, len);
+    shellWriteUnlock(shell);
 }
-SHELL_EXPORT_KEY(SHELL_CMD_PERMISSION(0)|SHELL_CMD_ENABLE_UNCHECKED,
-0x08000000, shellBackspace, backspace);
-SHELL_EXPORT_KEY(SHELL_CMD_PERMISSION(0)|SHELL_CMD_ENABLE_UNCHECKED,
-0x7F000000, shellBackspace, backspace);
+#endif /** SHELL_SUPPORT_END_LINE == 1 */
 
 
+#if SHELL_SUBMIT_QUEUE_SIZE > 0
 /**
- * @brief shell 删除
+ * @brief shell 提交命令
+ *        命令复制到提交队列，由shell任务执行，可以在任意任务中调用，多个任务同时提交不需要加锁
  * 
  * @param shell shell对象
+ * @param cmd 命令
+ * @param callback 执行结束回调，可以为NULL
+ * 
+ * @return int 0 提交成功 -1 命令过长或队列已满
  */
-void shellDelete(Shell *shell)
+int shellSubmit(Shell *shell, const char *cmd, ShellSubmitCallback callback)
 {
-    shellDeleteByte(shell, -1);
+    unsigned int position;
+    unsigned int sequence;
+    size_t length;
+
+    SHELL_ASSERT(shell && cmd, return -1);
+    length = strlen(cmd);
+    if (length >= SHELL_SUBMIT_BUFFER_SIZE)
+    {
+        return -1;
+    }
+    position = SHELL_ATOMIC_LOAD(&shell->submit.tail);
+    while (1)
+    {
+        sequence = SHELL_ATOMIC_LOAD(
+            &shell->submit.cell[position & (SHELL_SUBMIT_QUEUE_SIZE - 1)].sequence);
+        if (sequence == position)
+        {
+            if (SHELL_ATOMIC_CAS(&shell->submit.tail, &position, position + 1))
+            {
+                break;
+            }
+        }
+        else if ((int)(sequence - position) < 0)
+        {
+            return -1;
+        }
+        else
+        {
+            position = SHELL_ATOMIC_LOAD(&shell->submit.tail);
+        }
+    }
+    memcpy(shell->submit.cell[position & (SHELL_SUBMIT_QUEUE_SIZE - 1)].cmd, cmd, length + 1);
+    shell->submit.cell[position & (SHELL_SUBMIT_QUEUE_SIZE - 1)].callback = callback;
+    SHELL_ATOMIC_STORE(
+        &shell->submit.cell[position & (SHELL_SUBMIT_QUEUE_SIZE - 1)].sequence, position + 1);
+    if (shell->notify)
+    {
+        shell->notify(shell);
+    }
+    return 0;
 }
-SHELL_EXPORT_KEY(SHELL_CMD_PERMISSION(0)|SHELL_CMD_ENABLE_UNCHECKED,
-0x1B5B337E, shellDelete, delete);
 
 
 /**
- * @brief shell 回车处理
+ * @brief shell 执行提交的命令
+ *        使用独立的命令缓冲和参数解析，执行结束后恢复正在输入的命令行
  * 
  * @param shell shell对象
+ * @param cmd 命令
+ * 
+ * @return int 命令返回值
  */
-void shellEnter(Shell *shell)
+static int shellSubmitExec(Shell *shell, char *cmd)
 {
-    shellExec(shell);
-    shellWritePrompt(shell, 1);
-}
-#if SHELL_ENTER_LF == 1
-SHELL_EXPORT_KEY(SHELL_CMD_PERMISSION(0)|SHELL_CMD_ENABLE_UNCHECKED,
-0x0A000000, shellEnter, enter);
+    char parser[sizeof(shell->parser)];
+    char active = shell->status.isActive;
+    ShellCommand *command;
+    int returnValue = -1;
+
+    if (!shell->status.isChecked)
+    {
+        return -1;
+    }
+#if SHELL_USING_CANCEL == 1
+    if (!active)
+    {
+        shell->info.cancelled = 0;
+    }
 #endif
-#if SHELL_ENTER_CR == 1
-SHELL_EXPORT_KEY(SHELL_CMD_PERMISSION(0)|SHELL_CMD_ENABLE_UNCHECKED,
-0x0D000000, shellEnter, enter);
+    memcpy(parser, &shell->parser, sizeof(shell->parser));
+    if (!active)
+    {
+        shellWriteString(shell, shellText[SHELL_TEXT_CLEAR_LINE]);
+        shellWritePrompt(shell, 0);
+    }
+    shellWriteString(shell, cmd);
+    shellWriteString(shell, "\r\n");
+
+    shell->parser.buffer = cmd;
+    shell->parser.length = strlen(cmd);
+    shell->parser.bufferSize = SHELL_SUBMIT_BUFFER_SIZE;
+#if SHELL_ARENA_SIZE > 0
+    unsigned short mark = shell->arena.used;
 #endif
-#if SHELL_ENTER_CRLF == 1
-SHELL_EXPORT_KEY(SHELL_CMD_PERMISSION(0)|SHELL_CMD_ENABLE_UNCHECKED,
-0x0D0A0000, shellEnter, enter);
+    shellParserParam(shell);
+    if (shell->parser.paramCount > 0)
+    {
+        command = shellSeekCommand(shell,
+                                   shell->parser.param[0],
+                                   shell->commandList.base,
+                                   0);
+    #if SHELL_DYNAMIC_CMD_NUMBER > 0
+        ShellCmdDynamicTables *tables = NULL;
+        if (command == NULL && (tables = shellCmdDynamicEnter(shell)) != NULL)
+        {
+            command = shellCmdDynamicSeek(shell, shell->parser.param[0]);
+        }
+    #endif
+        if (command != NULL)
+        {
+            returnValue = shellRunCommand(shell, command);
+        }
+        else
+        {
+            shellWriteString(shell, shellText[SHELL_TEXT_CMD_NOT_FOUND]);
+        }
+    #if SHELL_DYNAMIC_CMD_NUMBER > 0
+        if (tables != NULL)
+        {
+            shellCmdDynamicExit(shell);
+        }
+    #endif
+    }
+#if SHELL_ARENA_SIZE > 0
+    shell->arena.used = mark;
 #endif
 
+    memcpy(&shell->parser, parser, sizeof(shell->parser));
+    shell->status.isActive = active;
+    if (!active)
+    {
+        shellWriteLock(shell);
+        shellPutCommandLine(shell);
+        shellWriteUnlock(shell);
+    }
+    return returnValue;
+}
+
+
 /**
- * @brief shell 写命令帮助信息
+ * @brief shell 处理提交队列
+ *        `shellTask`每次读取输入后调用，其他情况下需要在shell任务中调用，不能在多个任务中同时调用
  * 
  * @param shell shell对象
- * @param cmd 命令字符串
  */
-static void shellWriteCommandHelp(Shell *shell, char *cmd)
+void shellSubmitHandler(Shell *shell)
 {
-    ShellCommand *command = shellSeekCommand(shell,
-                                             cmd,
-                                             shell->commandList.base,
-                                             0);
-    if (command)
-    {
-        shellWriteString(shell, shellText[SHELL_TEXT_HELP_HEADER]);
-        shellWriteString(shell, shellGetCommandName(command));
-        shellWriteString(shell, "\r\n");
-        shellWriteString(shell, shellGetCommandDesc(command));
-        shellWriteString(shell, "\r\n");
-    }
-    else
+    char cmd[SHELL_SUBMIT_BUFFER_SIZE];
+    char buffer[SHELL_SUBMIT_BUFFER_SIZE];
+    ShellSubmitCallback callback;
+    unsigned int position;
+    int returnValue;
+
+    SHELL_ASSERT(shell, return);
+    while (1)
     {
-        shellWriteString(shell, shellText[SHELL_TEXT_CMD_NOT_FOUND]);
+        position = shell->submit.head;
+        if (SHELL_ATOMIC_LOAD(
+                &shell->submit.cell[position & (SHELL_SUBMIT_QUEUE_SIZE - 1)].sequence)
+            != position + 1)
+        {
+            return;
+        }
+        strcpy(cmd, shell->submit.cell[position & (SHELL_SUBMIT_QUEUE_SIZE - 1)].cmd);
+        callback = shell->submit.cell[position & (SHELL_SUBMIT_QUEUE_SIZE - 1)].callback;
+        shell->submit.head = position + 1;
+        SHELL_ATOMIC_STORE(
+            &shell->submit.cell[position & (SHELL_SUBMIT_QUEUE_SIZE - 1)].sequence,
+            position + SHELL_SUBMIT_QUEUE_SIZE);
+
+        strcpy(buffer, cmd);
+        shellHandlerEnter(shell);
+        returnValue = shellSubmitExec(shell, buffer);
+        shellHandlerExit(shell);
+        if (callback)
+        {
+            callback(shell, cmd, returnValue);
+        }
     }
 }
+#endif /** SHELL_SUBMIT_QUEUE_SIZE > 0 */
 
+
+#if SHELL_FEED_BUFFER_SIZE > 0
 /**
- * @brief shell help
+ * @brief shell 写入输入数据
+ *        数据复制到输入环形缓冲，不加锁，不输出，可以在中断或者信号处理中调用，
+ *        写入数据后调用`shell->notify`通知shell任务
+ * @note 同一个shell只能有一个写入者，多个中断写入同一个shell时，需要保证不会互相打断
  * 
- * @param argc 参数个数
- * @param argv 参数
+ * @param shell shell对象
+ * @param data 输入数据
+ * @param len 数据长度
+ * 
+ * @return unsigned short 实际写入的数据长度，缓冲满时丢弃剩余的数据
  */
-void shellHelp(int argc, char *argv[])
+unsigned short shellFeed(Shell *shell, const char *data, unsigned short len)
 {
-    Shell *shell = shellGetCurrent();
-    SHELL_ASSERT(shell, return);
-    if (argc == 1)
+    unsigned int head = SHELL_ATOMIC_LOAD(&shell->feed.head);
+    unsigned int tail = shell->feed.tail;
+    unsigned short count = 0;
+
+    while (count < len && tail - head < SHELL_FEED_BUFFER_SIZE)
     {
-        shellListAll(shell);
+        shell->feed.buffer[tail & (SHELL_FEED_BUFFER_SIZE - 1)] = data[count++];
+        tail++;
     }
-    else if (argc > 1)
+    if (count > 0)
     {
-        shellWriteCommandHelp(shell, argv[1]);
+        SHELL_ATOMIC_STORE(&shell->feed.tail, tail);
+        if (shell->notify)
+        {
+            shell->notify(shell);
+        }
     }
+    return count;
 }
-SHELL_EXPORT_CMD(
-SHELL_CMD_PERMISSION(0)|SHELL_CMD_TYPE(SHELL_TYPE_CMD_MAIN)|SHELL_CMD_DISABLE_RETURN,
-help, shellHelp, show command info\r\nhelp [cmd]);
+
 
 /**
- * @brief shell 输入处理
+ * @brief shell 处理输入环形缓冲中的数据
+ *        在shell任务中调用，连续的数据整块交给`shellHandlerBlock()`处理，
+ *        shell正在执行命令时，数据保留在缓冲中，命令结束后处理
  * 
  * @param shell shell对象
- * @param data 输入数据
+ * 
+ * @return unsigned short 处理的数据长度
  */
-void shellHandler(Shell *shell, char data)
+unsigned short shellFeedHandler(Shell *shell)
 {
-    SHELL_ASSERT(data, return);
-    SHELL_LOCK(shell);
+    unsigned int head = shell->feed.head;
+    unsigned int tail = SHELL_ATOMIC_LOAD(&shell->feed.tail);
+    unsigned int offset;
+    unsigned int run;
+    unsigned short count = 0;
 
-#if SHELL_LOCK_TIMEOUT > 0
-    if (shell->info.user->data.user.password
-        && strlen(shell->info.user->data.user.password) != 0
-        && SHELL_GET_TICK())
+    while (head != tail && !shell->status.isActive)
     {
-        if (SHELL_GET_TICK() - shell->info.activeTime > SHELL_LOCK_TIMEOUT)
+        offset = head & (SHELL_FEED_BUFFER_SIZE - 1);
+        run = tail - head;
+        if (run > SHELL_FEED_BUFFER_SIZE - offset)
         {
-            shell->status.isChecked = 0;
+            run = SHELL_FEED_BUFFER_SIZE - offset;
+        }
+        if (shellHandlerBlock(shell, &shell->feed.buffer[offset], run) == 0)
+        {
+            break;
         }
+        head += run;
+        count += run;
+        SHELL_ATOMIC_STORE(&shell->feed.head, head);
+        tail = SHELL_ATOMIC_LOAD(&shell->feed.tail);
     }
-#endif
+    return count;
+}
+#endif /** SHELL_FEED_BUFFER_SIZE > 0 */
 
-    /* 根据记录的按键键值计算当前字节在按键键值中的偏移 */
-    char keyByteOffset = 24;
-    int keyFilter = 0x00000000;
-    if ((shell->parser.keyValue & 0x0000FF00) != 0x00000000)
-    {
-        keyByteOffset = 0;
-        keyFilter = 0xFFFFFF00;
-    }
-    else if ((shell->parser.keyValue & 0x00FF0000) != 0x00000000)
-    {
-        keyByteOffset = 8;
-        keyFilter = 0xFFFF0000;
-    }
-    else if ((shell->parser.keyValue & 0xFF000000) != 0x00000000)
-    {
-        keyByteOffset = 16;
-        keyFilter = 0xFF000000;
-    }
 
-    /* 遍历ShellCommand列表，尝试进行按键键值匹配 */
-    ShellCommand *base = (ShellCommand *)shell->commandList.base;
-    for (short i = 0; i < shell->commandList.count; i++)
+/**
+ * @brief shell 处理所有已经接收到的输入
+ *        循环调用`shell->read`直到没有数据，然后处理输入环形缓冲和命令提交队列
+ * @note `shell->read`在没有数据时需要立即返回
+ * 
+ * @param shell shell对象
+ * 
+ * @return int 处理的输入数据长度
+ */
+int shellProcessAvailable(Shell *shell)
+{
+    int count = 0;
+#if SHELL_READ_BUFFER > 1
+    char data[SHELL_READ_BUFFER];
+    signed short len;
+
+    while (shell->read && (len = shell->read(data, SHELL_READ_BUFFER)) > 0)
     {
-        /* 判断是否是按键定义并验证权限 */
-        if (base[i].attr.attrs.type == SHELL_TYPE_KEY
-            && shellCheckPermission(shell, &(base[i])) == 0)
+        shellHandlerBlock(shell, data, len);
+        count += len;
+        if (len < SHELL_READ_BUFFER)
         {
-            /* 对输入的字节同按键键值进行匹配 */
-            if ((base[i].data.key.value & keyFilter) == shell->parser.keyValue
-                && (base[i].data.key.value & (0xFF << keyByteOffset))
-                    == (data << keyByteOffset))
-            {
-                shell->parser.keyValue |= data << keyByteOffset;
-                data = 0x00;
-                if (keyByteOffset == 0 
-                    || (base[i].data.key.value & (0xFF << (keyByteOffset - 8)))
-                        == 0x00000000)
-                {
-                    if (base[i].data.key.function)
-                    {
-                        base[i].data.key.function(shell);
-                    }
-                    shell->parser.keyValue = 0x00000000;
-                    break;
-                }
-            }
+            break;
         }
     }
+#else
+    char data;
 
-    if (data != 0x00)
-    {
-        shell->parser.keyValue = 0x00000000;
-        shellNormalInput(shell, data);
-    }
-
-    if (SHELL_GET_TICK())
+    while (shell->read && shell->read(&data, 1) == 1)
     {
-        shell->info.activeTime = SHELL_GET_TICK();
+        shellHandler(shell, data);
+        count++;
     }
-    SHELL_UNLOCK(shell);
+#endif
+#if SHELL_FEED_BUFFER_SIZE > 0
+    count += shellFeedHandler(shell);
+#endif
+#if SHELL_SUBMIT_QUEUE_SIZE > 0
+    shellSubmitHandler(shell);
+#endif
+#if SHELL_END_LINE_BUFFER > 0
+    shellEndLineHandler(shell);
+#endif
+    return count;
 }
 
 
-#if SHELL_SUPPORT_END_LINE == 1
-void shellWriteEndLine(Shell *shell, char *buffer, int len)
+#if SHELL_USING_POLL == 1
+/**
+ * @brief shell 等待并处理输入
+ *        调用`shell->wait`阻塞到有输入或者`shell->notify`通知，然后处理所有已经接收到的输入
+ * 
+ * @param shell shell对象
+ * @param timeout 超时时间，单位由`shell->wait`的实现决定，-1表示一直等待
+ * 
+ * @return int 处理的输入数据长度，超时返回0
+ */
+int shellPoll(Shell *shell, int timeout)
 {
-    SHELL_LOCK(shell);
-    if (!shell->status.isActive)
+#if SHELL_END_LINE_BUFFER > 0
+    int remain = shellEndLineHandler(shell);
+
+    if (remain >= 0 && (timeout < 0 || remain < timeout))
     {
-        shellWriteString(shell, shellText[SHELL_TEXT_CLEAR_LINE]);
+        timeout = remain;
     }
-    shell->write(buffer, len);
-
-    if (!shell->status.isActive)
+#endif
+    if (shell->wait && shell->wait(shell, timeout) <= 0)
     {
-        shellWritePrompt(shell, 0);
-        if (shell->parser.length > 0)
-        {
-            shellWriteString(shell, shell->parser.buffer);
-            for (short i = 0; i < shell->parser.length - shell->parser.cursor; i++)
-            {
-                shellWriteByte(shell, '\b');
-            }
-        }
+        return 0;
     }
-    SHELL_UNLOCK(shell);
+    return shellProcessAvailable(shell);
 }
-#endif /** SHELL_SUPPORT_END_LINE == 1 */
+#endif /** SHELL_USING_POLL == 1 */
 
 
 /**
@@ -1883,15 +6416,46 @@ void shellWriteEndLine(Shell *shell, char *buffer, int len)
 void shellTask(void *param)
 {
     Shell *shell = (Shell *)param;
+#if SHELL_READ_BUFFER > 1
+    char data[SHELL_READ_BUFFER];
+    signed short len;
+#else
     char data;
+#endif
+#if SHELL_USING_POLL == 1
+    if (shell->wait)
+    {
+    #if SHELL_TASK_WHILE == 1
+        while(1)
+    #endif
+        shellPoll(shell, SHELL_POLL_TIMEOUT);
+        return;
+    }
+#endif
 #if SHELL_TASK_WHILE == 1
     while(1)
     {
 #endif
+    #if SHELL_READ_BUFFER > 1
+        if (shell->read && (len = shell->read(data, SHELL_READ_BUFFER)) > 0)
+        {
+            shellHandlerBlock(shell, data, len);
+        }
+    #else
         if (shell->read && shell->read(&data, 1) == 1)
         {
             shellHandler(shell, data);
         }
+    #endif
+    #if SHELL_FEED_BUFFER_SIZE > 0
+        shellFeedHandler(shell);
+    #endif
+    #if SHELL_SUBMIT_QUEUE_SIZE > 0
+        shellSubmitHandler(shell);
+    #endif
+    #if SHELL_END_LINE_BUFFER > 0
+        shellEndLineHandler(shell);
+    #endif
 #if SHELL_TASK_WHILE == 1
     }
 #endif
@@ -1999,6 +6563,7 @@ int shellRun(Shell *shell, const char *cmd)
         shell->parser.length = shellStringCopy(shell->parser.buffer, (char *)cmd);
         shellExec(shell);
         shell->status.isActive = active;
+        shellFlushPoint(shell);
         return 0;
     }
 }
@@ -2029,6 +6594,13 @@ int shellExecute(int argc, char *argv[])
                           |SHELL_CMD_DISABLE_RETURN,
             .data.cmd.function = func,
         };
+    #if SHELL_ARENA_SIZE > 0
+        if (argc - 1 > SHELL_PARAMETER_MAX_NUMBER)
+        {
+            shellWriteString(shell, shellText[SHELL_TEXT_PARAM_TOO_MANY]);
+            return -1;
+        }
+    #endif
         return shellExtRun(shell, &command, argc - 1, &argv[1]);
     }
     else
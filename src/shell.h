@@ -13,6 +13,8 @@
 #define     __SHELL_H__
 
 #include "shell_cfg.h"
+#include "stddef.h"
+#include "stdarg.h"
 
 #define     SHELL_VERSION               "3.2.4"                 /**< 版本号 */
 
@@ -29,11 +31,19 @@
             }
 
 #if SHELL_USING_LOCK == 1
-#define     SHELL_LOCK(shell)           shell->lock(shell)
-#define     SHELL_UNLOCK(shell)         shell->unlock(shell)
+#define     SHELL_LOCK(shell) \
+            do { if ((shell)->lock) { (shell)->lock(shell); } } while (0)
+#define     SHELL_UNLOCK(shell) \
+            do { if ((shell)->unlock) { (shell)->unlock(shell); } } while (0)
+#define     SHELL_WRITE_LOCK(shell) \
+            do { if ((shell)->writeLock) { (shell)->writeLock(shell); } } while (0)
+#define     SHELL_WRITE_UNLOCK(shell) \
+            do { if ((shell)->writeUnlock) { (shell)->writeUnlock(shell); } } while (0)
 #else
-#define     SHELL_LOCK(shell)
-#define     SHELL_UNLOCK(shell)
+#define     SHELL_LOCK(shell)           do { } while (0)
+#define     SHELL_UNLOCK(shell)         do { } while (0)
+#define     SHELL_WRITE_LOCK(shell)     do { } while (0)
+#define     SHELL_WRITE_UNLOCK(shell)   do { } while (0)
 #endif /** SHELL_USING_LOCK == 1 */
 /**
  * @brief shell 命令权限
@@ -87,6 +97,26 @@
     #endif
 #endif
 
+/**
+ * @brief shell 命令段定义
+ *        使能`SHELL_CMD_SORTED_SECTION`时，每个命令放入以命令名结尾的段中，用于链接时排序
+ */
+#if SHELL_CMD_SORTED_SECTION == 1
+    #define SHELL_CMD_SECTION(_name)            SHELL_SECTION("shellCommand." #_name)
+#else
+    #define SHELL_CMD_SECTION(_name)            SHELL_SECTION("shellCommand")
+#endif
+
+/**
+ * @brief shell 描述段定义
+ *        使能`SHELL_DESC_STRIP`时，导出的描述放入`shellDesc`段，可以在生成固件时剥离
+ */
+#if SHELL_DESC_STRIP == 1
+    #define SHELL_DESC_SECTION                  SHELL_SECTION("shellDesc")
+#else
+    #define SHELL_DESC_SECTION
+#endif
+
 #ifndef SHELL_USED
     #if defined(__CC_ARM) || defined(__CLANG_ARM)
         #define SHELL_USED                      __attribute__((used))
@@ -119,6 +149,18 @@
             void SHELL_AGENCY_FUNC_NAME(_func)(int p1, int p2, int p3, int p4, int p5, int p6, int p7) \
             { _func(__VA_ARGS__); }
 
+#if SHELL_CMD_COMPACT == 1
+/**
+ * @brief shell 按键键值展开为4字节(紧凑命令表)
+ *        按照从高到低的顺序，和按键序列的字节顺序一致
+ * 
+ * @param _value 按键键值
+ */
+#define     SHELL_KEY_BYTES(_value) \
+            {(char)(((_value) >> 24) & 0xFF), (char)(((_value) >> 16) & 0xFF), \
+             (char)(((_value) >> 8) & 0xFF), (char)((_value) & 0xFF)}
+#endif /** SHELL_CMD_COMPACT == 1 */
+
 #if SHELL_USING_CMD_EXPORT == 1
 
     /**
@@ -130,11 +172,22 @@
      * @param _desc 命令描述
      * @param ... 其他参数
      */
+#if SHELL_CMD_COMPACT == 1
+    #define SHELL_EXPORT_CMD(_attr, _name, _func, _desc, ...) \
+            SHELL_USED const ShellCommand \
+            shellCommand##_name SHELL_CMD_SECTION(_name) =  \
+            { \
+                .attr.value = _attr, \
+                .data.cmd.name = #_name "\0" #_desc "\0", \
+                .data.cmd.function = (int (*)())_func, \
+                ##__VA_ARGS__ \
+            }
+#else
     #define SHELL_EXPORT_CMD(_attr, _name, _func, _desc, ...) \
             const char shellCmd##_name[] = #_name; \
-            const char shellDesc##_name[] = #_desc; \
+            const char shellDesc##_name[] SHELL_DESC_SECTION = #_desc; \
             SHELL_USED const ShellCommand \
-            shellCommand##_name SHELL_SECTION("shellCommand") =  \
+            shellCommand##_name SHELL_CMD_SECTION(_name) =  \
             { \
                 .attr.value = _attr, \
                 .data.cmd.name = shellCmd##_name, \
@@ -142,6 +195,7 @@
                 .data.cmd.desc = shellDesc##_name, \
                 ##__VA_ARGS__ \
             }
+#endif /** SHELL_CMD_COMPACT == 1 */
 
 #if SHELL_USING_FUNC_SIGNATURE == 1
     /**
@@ -153,12 +207,22 @@
      * @param _desc 命令描述
      * @param _sign 命令签名
      */
+#if SHELL_CMD_COMPACT == 1
+    #define SHELL_EXPORT_CMD_SIGN(_attr, _name, _func, _desc, _sign) \
+            SHELL_USED const ShellCommand \
+            shellCommand##_name SHELL_CMD_SECTION(_name) =  \
+            { \
+                .attr.value = _attr, \
+                .data.cmd.name = #_name "\0" #_desc "\0" #_sign, \
+                .data.cmd.function = (int (*)())_func \
+            }
+#else
     #define SHELL_EXPORT_CMD_SIGN(_attr, _name, _func, _desc, _sign) \
             const char shellCmd##_name[] = #_name; \
-            const char shellDesc##_name[] = #_desc; \
+            const char shellDesc##_name[] SHELL_DESC_SECTION = #_desc; \
             const char shellSign##_name[] = #_sign; \
             SHELL_USED const ShellCommand \
-            shellCommand##_name SHELL_SECTION("shellCommand") =  \
+            shellCommand##_name SHELL_CMD_SECTION(_name) =  \
             { \
                 .attr.value = _attr, \
                 .data.cmd.name = shellCmd##_name, \
@@ -166,6 +230,7 @@
                 .data.cmd.desc = shellDesc##_name, \
                 .data.cmd.signature = shellSign##_name \
             }
+#endif /** SHELL_CMD_COMPACT == 1 */
 #endif /** SHELL_USING_FUNC_SIGNATURE == 1 */
 
     /**
@@ -189,17 +254,28 @@
      * @param _value 变量值
      * @param _desc 变量描述
      */
+#if SHELL_CMD_COMPACT == 1
+    #define SHELL_EXPORT_VAR(_attr, _name, _value, _desc) \
+            SHELL_USED const ShellCommand \
+            shellVar##_name SHELL_CMD_SECTION(_name) =  \
+            { \
+                .attr.value = _attr, \
+                .data.var.name = #_name "\0" #_desc, \
+                .data.var.value = (void *)_value \
+            }
+#else
     #define SHELL_EXPORT_VAR(_attr, _name, _value, _desc) \
             const char shellCmd##_name[] = #_name; \
-            const char shellDesc##_name[] = #_desc; \
+            const char shellDesc##_name[] SHELL_DESC_SECTION = #_desc; \
             SHELL_USED const ShellCommand \
-            shellVar##_name SHELL_SECTION("shellCommand") =  \
+            shellVar##_name SHELL_CMD_SECTION(_name) =  \
             { \
                 .attr.value = _attr, \
                 .data.var.name = shellCmd##_name, \
                 .data.var.value = (void *)_value, \
                 .data.var.desc = shellDesc##_name \
             }
+#endif /** SHELL_CMD_COMPACT == 1 */
 
     /**
      * @brief shell 用户定义
@@ -209,18 +285,29 @@
      * @param _password 用户密码
      * @param _desc 用户描述
      */
+#if SHELL_CMD_COMPACT == 1
+    #define SHELL_EXPORT_USER(_attr, _name, _password, _desc) \
+            SHELL_USED const ShellCommand \
+            shellUser##_name SHELL_CMD_SECTION(_name) =  \
+            { \
+                .attr.value = _attr|SHELL_CMD_TYPE(SHELL_TYPE_USER), \
+                .data.user.name = #_name "\0" #_desc, \
+                .data.user.password = #_password \
+            }
+#else
     #define SHELL_EXPORT_USER(_attr, _name, _password, _desc) \
             const char shellCmd##_name[] = #_name; \
             const char shellPassword##_name[] = #_password; \
-            const char shellDesc##_name[] = #_desc; \
+            const char shellDesc##_name[] SHELL_DESC_SECTION = #_desc; \
             SHELL_USED const ShellCommand \
-            shellUser##_name SHELL_SECTION("shellCommand") =  \
+            shellUser##_name SHELL_CMD_SECTION(_name) =  \
             { \
                 .attr.value = _attr|SHELL_CMD_TYPE(SHELL_TYPE_USER), \
                 .data.user.name = shellCmd##_name, \
                 .data.user.password = shellPassword##_name, \
                 .data.user.desc = shellDesc##_name \
             }
+#endif /** SHELL_CMD_COMPACT == 1 */
 
     /**
      * @brief shell 按键定义
@@ -230,8 +317,20 @@
      * @param _func 按键函数
      * @param _desc 按键描述
      */
+#if SHELL_CMD_COMPACT == 1
+    #define SHELL_EXPORT_KEY(_attr, _value, _func, _desc) \
+            const struct { char value[4]; char desc[sizeof(#_desc)]; } \
+            shellDesc##_value = {SHELL_KEY_BYTES(_value), #_desc}; \
+            SHELL_USED const ShellCommand \
+            shellKey##_value SHELL_SECTION("shellCommand") =  \
+            { \
+                .attr.value = _attr|SHELL_CMD_TYPE(SHELL_TYPE_KEY), \
+                .data.key.desc = shellDesc##_value.value, \
+                .data.key.function = (void (*)(Shell *))_func \
+            }
+#else
     #define SHELL_EXPORT_KEY(_attr, _value, _func, _desc) \
-            const char shellDesc##_value[] = #_desc; \
+            const char shellDesc##_value[] SHELL_DESC_SECTION = #_desc; \
             SHELL_USED const ShellCommand \
             shellKey##_value SHELL_SECTION("shellCommand") =  \
             { \
@@ -240,6 +339,7 @@
                 .data.key.function = (void (*)(Shell *))_func, \
                 .data.key.desc = shellDesc##_value \
             }
+#endif /** SHELL_CMD_COMPACT == 1 */
 
     /**
      * @brief shell 代理按键定义
@@ -254,6 +354,44 @@
             SHELL_AGENCY_FUNC(_func, ##__VA_ARGS__) \
             SHELL_EXPORT_KEY(_attr, _value, SHELL_AGENCY_FUNC_NAME(_func), _desc)
 
+#if SHELL_KEY_TRIE_SIZE > 0
+    /**
+     * @brief shell 按键序列定义
+     *        用于定义超过4字节的按键序列，需要使能按键前缀树
+     * 
+     * @param _attr 按键属性
+     * @param _name 按键名
+     * @param _sequence 按键序列(字符串)
+     * @param _func 按键函数
+     * @param _desc 按键描述
+     */
+#if SHELL_CMD_COMPACT == 1
+    #define SHELL_EXPORT_KEY_SEQUENCE(_attr, _name, _sequence, _func, _desc) \
+            const struct { char value[4]; char desc[sizeof(#_desc "\0" _sequence)]; } \
+            shellDesc##_name = {{0, 0, 0, 0}, #_desc "\0" _sequence}; \
+            SHELL_USED const ShellCommand \
+            shellKey##_name SHELL_SECTION("shellCommand") =  \
+            { \
+                .attr.value = _attr|SHELL_CMD_TYPE(SHELL_TYPE_KEY), \
+                .data.key.desc = shellDesc##_name.value, \
+                .data.key.function = (void (*)(Shell *))_func \
+            }
+#else
+    #define SHELL_EXPORT_KEY_SEQUENCE(_attr, _name, _sequence, _func, _desc) \
+            const char shellKeySequence##_name[] = _sequence; \
+            const char shellDesc##_name[] SHELL_DESC_SECTION = #_desc; \
+            SHELL_USED const ShellCommand \
+            shellKey##_name SHELL_SECTION("shellCommand") =  \
+            { \
+                .attr.value = _attr|SHELL_CMD_TYPE(SHELL_TYPE_KEY), \
+                .data.key.value = 0, \
+                .data.key.function = (void (*)(Shell *))_func, \
+                .data.key.desc = shellDesc##_name, \
+                .data.key.sequence = shellKeySequence##_name \
+            }
+#endif /** SHELL_CMD_COMPACT == 1 */
+#endif /** SHELL_KEY_TRIE_SIZE > 0 */
+
 #if SHELL_USING_FUNC_SIGNATURE == 1
     /**
      * @brief shell 参数解析器定义
@@ -263,6 +401,21 @@
      * @param _parser 参数解析器函数
      * @param _cleaner 参数清理器
      */
+#if SHELL_CMD_COMPACT == 1
+    #define SHELL_EXPORT_PARAM_PARSER(_attr, _type, _parser, _cleaner) \
+            const ShellParamParserFunc shellParamParser##_parser = \
+            { \
+                (int (*)(char *, void **))_parser, \
+                (int (*)(void *))_cleaner \
+            }; \
+            SHELL_USED const ShellCommand \
+            shellCommand##_parser SHELL_SECTION("shellCommand") = \
+            { \
+                .attr.value = _attr|SHELL_CMD_TYPE(SHELL_TYPE_PARAM_PARSER), \
+                .data.paramParser.type = #_type, \
+                .data.paramParser.func = &shellParamParser##_parser \
+            }
+#else
     #define SHELL_EXPORT_PARAM_PARSER(_attr, _type, _parser, _cleaner) \
             const char shellDesc##_parser[] = #_type; \
             SHELL_USED const ShellCommand \
@@ -273,9 +426,12 @@
                 .data.paramParser.parser = (int (*)(char *, void **))_parser, \
                 .data.paramParser.cleaner = (int (*)(void *))_cleaner \
             }
+#endif /** SHELL_CMD_COMPACT == 1 */
 #endif
 
-#else
+#endif /** SHELL_USING_CMD_EXPORT == 1 */
+
+#if SHELL_USING_CMD_EXPORT == 0 || SHELL_DYNAMIC_CMD_NUMBER > 0
     /**
      * @brief shell 命令item定义
      * 
@@ -284,6 +440,14 @@
      * @param _func 命令函数
      * @param _desc 命令描述
      */
+#if SHELL_CMD_COMPACT == 1
+    #define SHELL_CMD_ITEM(_attr, _name, _func, _desc) \
+            { \
+                .attr.value = _attr, \
+                .data.cmd.name = #_name "\0" #_desc "\0", \
+                .data.cmd.function = (int (*)())_func \
+            }
+#else
     #define SHELL_CMD_ITEM(_attr, _name, _func, _desc) \
             { \
                 .attr.value = _attr, \
@@ -291,6 +455,7 @@
                 .data.cmd.function = (int (*)())_func, \
                 .data.cmd.desc = #_desc \
             }
+#endif /** SHELL_CMD_COMPACT == 1 */
 
     /**
      * @brief shell 变量item定义
@@ -300,6 +465,14 @@
      * @param _value 变量值
      * @param _desc 变量描述
      */
+#if SHELL_CMD_COMPACT == 1
+    #define SHELL_VAR_ITEM(_attr, _name, _value, _desc) \
+            { \
+                .attr.value = _attr, \
+                .data.var.name = #_name "\0" #_desc, \
+                .data.var.value = (void *)_value \
+            }
+#else
     #define SHELL_VAR_ITEM(_attr, _name, _value, _desc) \
             { \
                 .attr.value = _attr, \
@@ -307,6 +480,7 @@
                 .data.var.value = (void *)_value, \
                 .data.var.desc = #_desc \
             }
+#endif /** SHELL_CMD_COMPACT == 1 */
 
     /**
      * @brief shell 用户item定义
@@ -316,6 +490,14 @@
      * @param _password 用户密码
      * @param _desc 用户描述
      */
+#if SHELL_CMD_COMPACT == 1
+    #define SHELL_USER_ITEM(_attr, _name, _password, _desc) \
+            { \
+                .attr.value = _attr|SHELL_CMD_TYPE(SHELL_TYPE_USER), \
+                .data.user.name = #_name "\0" #_desc, \
+                .data.user.password = #_password \
+            }
+#else
     #define SHELL_USER_ITEM(_attr, _name, _password, _desc) \
             { \
                 .attr.value = _attr|SHELL_CMD_TYPE(SHELL_TYPE_USER), \
@@ -323,6 +505,7 @@
                 .data.user.password = #_password, \
                 .data.user.desc = #_desc \
             }
+#endif /** SHELL_CMD_COMPACT == 1 */
 
     /**
      * @brief shell 按键item定义
@@ -332,6 +515,15 @@
      * @param _func 按键函数
      * @param _desc 按键描述
      */
+#if SHELL_CMD_COMPACT == 1
+    #define SHELL_KEY_ITEM(_attr, _value, _func, _desc) \
+            { \
+                .attr.value = _attr|SHELL_CMD_TYPE(SHELL_TYPE_KEY), \
+                .data.key.desc = (const char *)&(const struct { char value[4]; char desc[sizeof(#_desc)]; }) \
+                                 {SHELL_KEY_BYTES(_value), #_desc}, \
+                .data.key.function = (void (*)(Shell *))_func \
+            }
+#else
     #define SHELL_KEY_ITEM(_attr, _value, _func, _desc) \
             { \
                 .attr.value = _attr|SHELL_CMD_TYPE(SHELL_TYPE_KEY), \
@@ -339,6 +531,36 @@
                 .data.key.function = (void (*)(Shell *))_func, \
                 .data.key.desc = #_desc \
             }
+#endif /** SHELL_CMD_COMPACT == 1 */
+
+#if SHELL_KEY_TRIE_SIZE > 0
+    /**
+     * @brief shell 按键序列item定义
+     * 
+     * @param _attr 按键属性
+     * @param _sequence 按键序列(字符串)
+     * @param _func 按键函数
+     * @param _desc 按键描述
+     */
+#if SHELL_CMD_COMPACT == 1
+    #define SHELL_KEY_SEQUENCE_ITEM(_attr, _sequence, _func, _desc) \
+            { \
+                .attr.value = _attr|SHELL_CMD_TYPE(SHELL_TYPE_KEY), \
+                .data.key.desc = (const char *)&(const struct { char value[4]; char desc[sizeof(#_desc "\0" _sequence)]; }) \
+                                 {{0, 0, 0, 0}, #_desc "\0" _sequence}, \
+                .data.key.function = (void (*)(Shell *))_func \
+            }
+#else
+    #define SHELL_KEY_SEQUENCE_ITEM(_attr, _sequence, _func, _desc) \
+            { \
+                .attr.value = _attr|SHELL_CMD_TYPE(SHELL_TYPE_KEY), \
+                .data.key.value = 0, \
+                .data.key.function = (void (*)(Shell *))_func, \
+                .data.key.desc = #_desc, \
+                .data.key.sequence = _sequence \
+            }
+#endif /** SHELL_CMD_COMPACT == 1 */
+#endif /** SHELL_KEY_TRIE_SIZE > 0 */
 
 #if SHELL_USING_FUNC_SIGNATURE == 1
     /**
@@ -349,6 +571,15 @@
      * @param _parser 参数解析器函数
      * @param _cleaner 参数清理器
      */
+#if SHELL_CMD_COMPACT == 1
+    #define SHELL_PARAM_PARSER_ITEM(_attr, _type, _parser, _cleaner) \
+            { \
+                .attr.value = _attr|SHELL_CMD_TYPE(SHELL_TYPE_PARAM_PARSER), \
+                .data.paramParser.type = #_type, \
+                .data.paramParser.func = &(const ShellParamParserFunc) \
+                                         {(int (*)(char *, void **))_parser, (int (*)(void *))_cleaner} \
+            }
+#else
     #define SHELL_PARAM_PARSER_ITEM(_attr, _type, _parser, _cleaner) \
             { \
                 .attr.value = _attr|SHELL_CMD_TYPE(SHELL_TYPE_PARAM_PARSER), \
@@ -356,8 +587,11 @@
                 .data.paramParser.parser = (int (*)(char *, void **))_parser, \
                 .data.paramParser.cleaner = (int (*)(void *))_cleaner \
             }
+#endif /** SHELL_CMD_COMPACT == 1 */
 #endif /** SHELL_USING_FUNC_SIGNATURE == 1 */
+#endif /** SHELL_USING_CMD_EXPORT == 0 || SHELL_DYNAMIC_CMD_NUMBER > 0 */
 
+#if SHELL_USING_CMD_EXPORT == 0
     #define SHELL_EXPORT_CMD(_attr, _name, _func, _desc)
 #if SHELL_USING_FUNC_SIGNATURE == 1
     #define SHELL_EXPORT_CMD_SIGN(_attr, _name, _func, _desc, _sign)
@@ -367,10 +601,13 @@
     #define SHELL_EXPORT_USER(_attr, _name, _password, _desc)
     #define SHELL_EXPORT_KEY(_attr, _value, _func, _desc)
     #define SHELL_EXPORT_KEY_AGENCY(_attr, _name, _func, _desc, ...)
+#if SHELL_KEY_TRIE_SIZE > 0
+    #define SHELL_EXPORT_KEY_SEQUENCE(_attr, _name, _sequence, _func, _desc)
+#endif /** SHELL_KEY_TRIE_SIZE > 0 */
 #if SHELL_USING_FUNC_SIGNATURE == 1
     #define SHELL_EXPORT_PARAM_PARSER(_attr, _type, _parser, _cleaner)
 #endif /** SHELL_USING_FUNC_SIGNATURE == 1 */
-#endif /** SHELL_USING_CMD_EXPORT == 1 */
+#endif /** SHELL_USING_CMD_EXPORT == 0 */
 
 /**
  * @brief shell command类型
@@ -393,6 +630,56 @@ typedef enum
 } ShellCommandType;
 
 
+#if SHELL_USING_TX == 1
+/**
+ * @brief TX环形缓冲满时的处理方式
+ */
+typedef enum
+{
+    SHELL_TX_BLOCK = 0,                                         /**< 等待发送完成 */
+    SHELL_TX_DROP_OLDEST,                                       /**< 丢弃足够数量的还未开始发送的旧数据 */
+    SHELL_TX_DROP_NEWEST,                                       /**< 丢弃新写入的数据 */
+} ShellTxPolicy;
+
+
+/**
+ * @brief TX环形缓冲
+ */
+typedef struct shell_tx
+{
+    char *buffer;                                               /**< 缓冲 */
+    unsigned short size;                                        /**< 缓冲大小(2的幂) */
+    unsigned char policy;                                       /**< 缓冲满时的处理方式 */
+    unsigned short sending;                                     /**< 正在发送的数据长度 */
+    unsigned int head;                                          /**< 读位置(正在发送的数据的起始位置) */
+    unsigned int next;                                          /**< 下一次发送的起始位置 */
+    unsigned int tail;                                          /**< 写位置 */
+    unsigned int spin;                                          /**< 默认临界区使用的自旋锁 */
+    void (*kick)(struct shell_tx *, char *, unsigned short);    /**< 启动发送 */
+} ShellTx;
+#endif
+
+
+#if SHELL_EXEC_CACHE_SIZE > 0
+/**
+ * @brief 命令解析缓存
+ *        保存命令行分割后的内容，参数位置，命令和已经解析的数值参数
+ */
+typedef struct shell_exec_cache
+{
+    unsigned int hash;                                          /**< 命令行哈希 */
+    unsigned short length;                                      /**< 命令行长度 */
+    unsigned short paramCount;                                  /**< 参数数量 */
+    const struct shell_command *command;                        /**< 命令 */
+    unsigned short parsed;                                      /**< 已缓存的参数 */
+    unsigned char resolved;                                     /**< 参数已经解析过一次 */
+    unsigned short offset[SHELL_PARAMETER_MAX_NUMBER];          /**< 参数在命令行中的偏移 */
+    size_t value[SHELL_PARAMETER_MAX_NUMBER];                   /**< 已解析的参数 */
+    char line[SHELL_EXEC_CACHE_LENGTH];                         /**< 分割后的命令行 */
+} ShellExecCache;
+#endif
+
+
 /**
  * @brief Shell定义
  */
@@ -403,52 +690,178 @@ typedef struct shell_def
         const struct shell_command *user;                       /**< 当前用户 */
         int activeTime;                                         /**< shell激活时间 */
         char *path;                                             /**< 当前shell路径 */
+        size_t task;                                            /**< 执行命令的任务 */
     #if SHELL_USING_COMPANION == 1
         struct shell_companion_object *companions;              /**< 伴生对象 */
     #endif
     #if SHELL_KEEP_RETURN_VALUE == 1
         int retVal;                                             /**< 返回值 */
     #endif
+    #if SHELL_CMD_VIEW_NUMBER > 0
+        unsigned char view;                                     /**< 当前用户的命令视图 */
+    #endif
+    #if SHELL_USING_CANCEL == 1
+        volatile unsigned char cancelled;                       /**< 命令取消标志 */
+        int execTime;                                           /**< 命令开始执行的时间 */
+        int execTimeout;                                        /**< 命令执行时间预算 */
+    #endif
     } info;
     struct
     {
         unsigned short length;                                  /**< 输入数据长度 */
         unsigned short cursor;                                  /**< 当前光标位置 */
         char *buffer;                                           /**< 输入缓冲 */
+    #if SHELL_ARENA_SIZE > 0
+        char **param;                                           /**< 参数(在参数内存池中分配) */
+    #else
         char *param[SHELL_PARAMETER_MAX_NUMBER];                /**< 参数 */
+    #endif
         unsigned short bufferSize;                              /**< 输入缓冲大小 */
         unsigned short paramCount;                              /**< 参数数量 */
-        int keyValue;                                           /**< 输入按键键值 */
+        int keyValue;                                           /**< 输入按键键值(使用按键前缀树时为当前节点) */
     } parser;
 #if SHELL_HISTORY_MAX_NUMBER > 0
     struct
     {
+    #if SHELL_HISTORY_POOL == 1
+        char *pool;                                             /**< 历史记录池 */
+        unsigned short size;                                    /**< 历史记录池大小 */
+        unsigned short used;                                    /**< 历史记录池已使用的大小 */
+        unsigned short position;                                /**< 当前显示的记录的结束位置 */
+    #else
         char *item[SHELL_HISTORY_MAX_NUMBER];                   /**< 历史记录 */
         unsigned short number;                                  /**< 历史记录数 */
         unsigned short record;                                  /**< 当前记录位置 */
+    #endif
         signed short offset;                                    /**< 当前历史记录偏移 */
+    #if SHELL_HISTORY_SEARCH_LENGTH > 0
+        struct
+        {
+            char pattern[SHELL_HISTORY_SEARCH_LENGTH + 1];      /**< 搜索内容 */
+            unsigned short match[SHELL_HISTORY_SEARCH_LENGTH + 1]; /**< 每个搜索长度匹配的记录的结束位置 */
+            unsigned char length;                               /**< 搜索内容长度 */
+            unsigned char active;                               /**< 正在搜索 */
+        } search;
+    #endif
     } history;
 #endif /** SHELL_HISTORY_MAX_NUMBER > 0 */
+#if SHELL_ARENA_SIZE > 0
+    struct
+    {
+        size_t buffer[(SHELL_ARENA_SIZE + sizeof(size_t) - 1) / sizeof(size_t)]; /**< 内存池 */
+        unsigned short used;                                    /**< 已使用的大小 */
+    } arena;
+#endif
+#if SHELL_EXEC_CACHE_SIZE > 0
+    struct
+    {
+        ShellExecCache entry[SHELL_EXEC_CACHE_SIZE];            /**< 缓存 */
+        ShellExecCache *current;                                /**< 正在执行的命令使用的缓存 */
+        const struct shell_command *user;                       /**< 缓存对应的用户 */
+        void *base;                                             /**< 缓存对应的命令表基址 */
+        unsigned short count;                                   /**< 缓存对应的命令数量 */
+    } execCache;
+#endif
     struct
     {
         void *base;                                             /**< 命令表基址 */
         unsigned short count;                                   /**< 命令数量 */
+#if SHELL_CMD_SORTED_SECTION == 1
+        unsigned short sorted;                                  /**< 命令表有序部分的起始序号 */
+#endif
     } commandList;
+#if SHELL_DYNAMIC_CMD_NUMBER > 0
+    struct
+    {
+        void *tables;                                           /**< 读者临界区中使用的动态命令表快照 */
+        unsigned char index;                                    /**< 读者所在的计数组 */
+        unsigned char depth;                                    /**< 读者临界区嵌套深度，0表示不在临界区中 */
+    } dynamic;
+#endif
     struct
     {
         unsigned char isChecked : 1;                            /**< 密码校验通过 */
         unsigned char isActive : 1;                             /**< 当前活动Shell */
         unsigned char tabFlag : 1;                              /**< tab标志 */
+        unsigned char isLocked : 1;                             /**< shell任务持有编辑锁 */
     } status;
+    struct
+    {
+#if SHELL_WRITE_BUFFER > 0
+        char buffer[SHELL_WRITE_BUFFER];                        /**< 输出缓冲 */
+        unsigned short length;                                  /**< 缓冲中的数据长度 */
+#endif
+        unsigned char block;                                    /**< 输出块嵌套深度 */
+#if SHELL_USING_LOCK == 1
+        size_t lockOwner;                                       /**< 持有输出锁的任务 */
+        unsigned char lockDepth;                                /**< 输出锁嵌套深度 */
+#endif
+        unsigned char inHandler;                                /**< 正在处理输入 */
+        unsigned char redrawPending;                            /**< 输入处理结束后需要重绘命令行 */
+    } output;
+#if SHELL_END_LINE_BUFFER > 0
+    struct
+    {
+        char buffer[SHELL_END_LINE_BUFFER];                     /**< 尾行输出合并缓冲 */
+        unsigned short length;                                  /**< 缓冲中的数据长度 */
+        int time;                                               /**< 缓冲中第一条输出的时间 */
+    } endLine;
+#endif
     signed short (*read)(char *, unsigned short);               /**< shell读函数 */
     signed short (*write)(char *, unsigned short);              /**< shell写函数 */
 #if SHELL_USING_LOCK == 1
-    int (*lock)(struct shell_def *);                              /**< shell 加锁 */
-    int (*unlock)(struct shell_def *);                            /**< shell 解锁 */
+    int (*lock)(struct shell_def *);                              /**< shell 编辑锁加锁 */
+    int (*unlock)(struct shell_def *);                            /**< shell 编辑锁解锁 */
+    int (*writeLock)(struct shell_def *);                         /**< shell 输出锁加锁 */
+    int (*writeUnlock)(struct shell_def *);                       /**< shell 输出锁解锁 */
+#endif
+#if SHELL_USING_JOBS == 1
+    int (*background)(struct shell_def *, struct shell_command *); /**< shell 后台执行命令 */
+#endif
+#if SHELL_SUBMIT_QUEUE_SIZE > 0
+    struct
+    {
+        unsigned int head;                                      /**< 读位置 */
+        unsigned int tail;                                      /**< 写位置 */
+        struct
+        {
+            unsigned int sequence;                              /**< 序号 */
+            void (*callback)(struct shell_def *, const char *, int); /**< 执行结束回调 */
+            char cmd[SHELL_SUBMIT_BUFFER_SIZE];                 /**< 命令 */
+        } cell[SHELL_SUBMIT_QUEUE_SIZE];
+    } submit;
+#endif
+#if SHELL_FEED_BUFFER_SIZE > 0
+    struct
+    {
+        unsigned int head;                                      /**< 读位置 */
+        unsigned int tail;                                      /**< 写位置 */
+        char buffer[SHELL_FEED_BUFFER_SIZE];                    /**< 输入数据 */
+    } feed;
+#endif
+#if SHELL_USING_POLL == 1
+    int (*wait)(struct shell_def *, int);                       /**< shell 等待输入 */
+#endif
+#if SHELL_FEED_BUFFER_SIZE > 0 || SHELL_SUBMIT_QUEUE_SIZE > 0 || SHELL_END_LINE_BUFFER > 0
+    void (*notify)(struct shell_def *);                         /**< shell 有待处理数据通知 */
+#endif
+#if SHELL_USING_TX == 1
+    ShellTx *tx;                                                /**< shell TX环形缓冲 */
 #endif
 } Shell;
 
 
+#if SHELL_CMD_COMPACT == 1 && SHELL_USING_FUNC_SIGNATURE == 1
+/**
+ * @brief shell 参数解析器函数(紧凑命令表)
+ */
+typedef struct
+{
+    int (*parser)(char *, void **);                             /**< 解析函数 */
+    int (*cleaner)(void *);                                     /**< 清理器 */
+} ShellParamParserFunc;
+#endif
+
 /**
  * @brief shell command定义
  */
@@ -468,6 +881,38 @@ typedef struct shell_command
         } attrs;
         int value;
     } attr;                                                     /**< 属性 */
+#if SHELL_CMD_COMPACT == 1
+    union
+    {
+        struct
+        {
+            const char *name;                                   /**< 命令名，格式为`命令名\0描述\0函数签名` */
+            int (*function)();                                  /**< 命令执行函数 */
+        } cmd;                                                  /**< 命令定义 */
+        struct
+        {
+            const char *name;                                   /**< 变量名，格式为`变量名\0描述` */
+            void *value;                                        /**< 变量值 */
+        } var;                                                  /**< 变量定义 */
+        struct
+        {
+            const char *name;                                   /**< 用户名，格式为`用户名\0描述` */
+            const char *password;                               /**< 用户密码 */
+        } user;                                                 /**< 用户定义 */
+        struct
+        {
+            const char *desc;                                   /**< 4字节按键键值，之后为描述，键值为0时描述之后为按键序列 */
+            void (*function)(Shell *);                          /**< 按键执行函数 */
+        } key;                                                  /**< 按键定义 */
+#if SHELL_USING_FUNC_SIGNATURE == 1
+        struct
+        {
+            const char *type;                                   /**< 参数类型 */
+            const ShellParamParserFunc *func;                   /**< 解析函数和清理器 */
+        } paramParser;                                          /**< 参数解析器 */
+#endif
+    } data;
+#else
     union
     {
         struct
@@ -496,6 +941,9 @@ typedef struct shell_command
             int value;                                          /**< 按键键值 */
             void (*function)(Shell *);                          /**< 按键执行函数 */
             const char *desc;                                   /**< 按键描述 */
+#if SHELL_KEY_TRIE_SIZE > 0
+            const char *sequence;                               /**< 按键序列，不为NULL时代替键值 */
+#endif
         } key;                                                  /**< 按键定义 */
 #if SHELL_USING_FUNC_SIGNATURE == 1
         struct
@@ -506,6 +954,7 @@ typedef struct shell_command
         } paramParser;                                          /**< 参数解析器 */
 #endif
     } data;
+#endif /** SHELL_CMD_COMPACT == 1 */
 } ShellCommand;
 
 /**
@@ -525,15 +974,78 @@ typedef struct
 #define shellDeInit(shell)              shellRemove(shell)
 
 void shellInit(Shell *shell, char *buffer, unsigned short size);
+int shellAdd(Shell *shell);
 void shellRemove(Shell *shell);
 unsigned short shellWriteString(Shell *shell, const char *string);
+/**
+ * @brief shell格式化输出函数
+ * 
+ * @param context 上下文
+ * @param data 格式化得到的一段数据
+ * @param len 数据长度
+ */
+typedef void (*ShellFormatWrite)(void *context, const char *data, unsigned short len);
+
+int shellFormat(ShellFormatWrite write, void *context, const char *fmt, va_list vargs);
 void shellPrint(Shell *shell, const char *fmt, ...);
 void shellScan(Shell *shell, char *fmt, ...);
 Shell* shellGetCurrent(void);
-void shellHandler(Shell *shell, char data);
+int shellHandler(Shell *shell, char data);
+unsigned short shellHandlerBlock(Shell *shell, const char *data, unsigned short len);
+void shellFlush(Shell *shell);
+void shellWriteBlockBegin(Shell *shell);
+void shellWriteBlockEnd(Shell *shell);
 void shellWriteEndLine(Shell *shell, char *buffer, int len);
+#if SHELL_HISTORY_MAX_NUMBER > 0 && SHELL_HISTORY_POOL == 1
+unsigned short shellHistoryDump(Shell *shell, char *buffer, unsigned short size);
+void shellHistoryRestore(Shell *shell, const char *data, unsigned short len);
+#endif
+#if SHELL_END_LINE_BUFFER > 0
+int shellEndLineHandler(Shell *shell);
+#endif
 void shellTask(void *param);
 int shellRun(Shell *shell, const char *cmd);
+#if SHELL_ARENA_SIZE > 0
+void *shellArenaAlloc(Shell *shell, unsigned short size);
+#endif
+#if SHELL_DYNAMIC_CMD_NUMBER > 0
+int shellRegisterCommands(ShellCommand *table, unsigned short count);
+int shellUnregisterCommands(ShellCommand *table);
+#endif
+#if SHELL_SUBMIT_QUEUE_SIZE > 0
+/**
+ * @brief 提交的命令执行结束回调
+ * 
+ * @param shell shell对象
+ * @param cmd 命令
+ * @param value 命令返回值，命令未找到或无法解析时为-1
+ */
+typedef void (*ShellSubmitCallback)(Shell *shell, const char *cmd, int value);
+
+int shellSubmit(Shell *shell, const char *cmd, ShellSubmitCallback callback);
+void shellSubmitHandler(Shell *shell);
+#endif
+#if SHELL_FEED_BUFFER_SIZE > 0
+unsigned short shellFeed(Shell *shell, const char *data, unsigned short len);
+unsigned short shellFeedHandler(Shell *shell);
+#endif
+#if SHELL_USING_POLL == 1
+int shellPoll(Shell *shell, int timeout);
+#endif
+int shellProcessAvailable(Shell *shell);
+#if SHELL_USING_TX == 1
+void shellTxInit(ShellTx *tx, char *buffer, unsigned short size,
+                 void (*kick)(ShellTx *, char *, unsigned short));
+unsigned short shellTxWrite(ShellTx *tx, const char *data, unsigned short len);
+void shellTxComplete(ShellTx *tx, unsigned short len);
+#endif
+#if SHELL_USING_CANCEL == 1
+void shellCancel(Shell *shell);
+int shellIsCancelled(Shell *shell);
+void shellSetExecTimeout(Shell *shell, int timeout);
+#else
+#define shellIsCancelled(shell)         0
+#endif
 
 
 
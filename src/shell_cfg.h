@@ -49,6 +49,98 @@
 #define     SHELL_SUPPORT_END_LINE      0
 #endif /** SHELL_SUPPORT_END_LINE */
 
+#ifndef SHELL_END_LINE_BUFFER
+/**
+ * @brief 尾行输出合并缓冲大小
+ *        大于0时，`shellWriteEndLine()`的输出先写入缓冲，缓冲满，或者第一条输出超过
+ *        `SHELL_END_LINE_DELAY`后，一次性清除命令行，输出缓冲中的所有内容并重绘一次命令行，
+ *        设置为0时每次调用`shellWriteEndLine()`都立即输出
+ * @note 需要使能`SHELL_SUPPORT_END_LINE`，shell任务需要周期性运行，或者使用`SHELL_USING_POLL`
+ */
+#define     SHELL_END_LINE_BUFFER       0
+#endif /** SHELL_END_LINE_BUFFER */
+
+#ifndef SHELL_END_LINE_DELAY
+/**
+ * @brief 尾行输出合并时间
+ *        时间单位为`SHELL_GET_TICK()`单位，`SHELL_GET_TICK()`无效时，在shell任务下一次运行时输出
+ */
+#define     SHELL_END_LINE_DELAY        20
+#endif /** SHELL_END_LINE_DELAY */
+
+#ifndef SHELL_USING_JOBS
+/**
+ * @brief 是否支持后台执行命令
+ *        使能此宏后，以`&`结尾的命令会交给`shell->background`在后台执行，
+ *        `shell->background`为NULL时仍在前台执行，后台任务的实现见`extensions/shell_enhance/shell_jobs`
+ */
+#define     SHELL_USING_JOBS            0
+#endif /** SHELL_USING_JOBS */
+
+#ifndef SHELL_USING_CANCEL
+/**
+ * @brief 是否支持取消正在执行的命令
+ *        使能后，可以在其他线程，信号处理或者中断中调用`shellCancel()`(比如检测到Ctrl-C时)设置取消标志，
+ *        命令执行过程中通过`shellIsCancelled()`查询，并提前结束执行
+ */
+#define     SHELL_USING_CANCEL          0
+#endif /** SHELL_USING_CANCEL */
+
+#ifndef SHELL_EXEC_TIMEOUT
+/**
+ * @brief 命令执行时间预算
+ *        命令执行时间超过预算后，`shellIsCancelled()`返回1，设置为0时不限制执行时间，
+ *        时间单位为`SHELL_GET_TICK()`单位，命令可以通过`shellSetExecTimeout()`修改本次执行的预算
+ * @note 需要使能`SHELL_USING_CANCEL`，并保证`SHELL_GET_TICK()`有效
+ */
+#define     SHELL_EXEC_TIMEOUT          0
+#endif /** SHELL_EXEC_TIMEOUT */
+
+#ifndef SHELL_SUBMIT_QUEUE_SIZE
+/**
+ * @brief 命令提交队列长度
+ *        大于0时，可以在其他任务中通过`shellSubmit()`提交命令，命令在shell任务中执行，
+ *        不会影响正在输入的命令行，必须为2的幂，设置为0时不使用命令提交队列
+ * @note 命令提交队列使用`SHELL_ATOMIC_*`实现无锁的多生产者队列
+ */
+#define     SHELL_SUBMIT_QUEUE_SIZE     0
+#endif /** SHELL_SUBMIT_QUEUE_SIZE */
+
+#ifndef SHELL_SUBMIT_BUFFER_SIZE
+/**
+ * @brief 提交的命令的最大长度(包括结束符)
+ */
+#define     SHELL_SUBMIT_BUFFER_SIZE    64
+#endif /** SHELL_SUBMIT_BUFFER_SIZE */
+
+#ifndef SHELL_FEED_BUFFER_SIZE
+/**
+ * @brief 输入环形缓冲大小
+ *        大于0时，可以在中断或者信号处理等异步上下文中通过`shellFeed()`写入输入数据，
+ *        由shell任务通过`shellFeedHandler()`处理，必须为2的幂，设置为0时不使用输入环形缓冲
+ * @note 输入环形缓冲为单生产者单消费者的无锁队列，使用`SHELL_ATOMIC_*`实现
+ */
+#define     SHELL_FEED_BUFFER_SIZE      0
+#endif /** SHELL_FEED_BUFFER_SIZE */
+
+#ifndef SHELL_USING_POLL
+/**
+ * @brief 是否使用事件驱动的shell任务
+ *        使能此宏并设置`shell->wait`后，`shellTask()`调用`shellPoll()`等待输入，
+ *        有数据时一次处理所有已经接收到的数据，不再循环调用`shell->read`
+ * @note 此时`shell->read`在没有数据时需要立即返回
+ */
+#define     SHELL_USING_POLL            0
+#endif /** SHELL_USING_POLL */
+
+#ifndef SHELL_POLL_TIMEOUT
+/**
+ * @brief `shellTask()`等待输入的超时时间
+ *        单位由`shell->wait`的实现决定，-1表示一直等待
+ */
+#define     SHELL_POLL_TIMEOUT          -1
+#endif /** SHELL_POLL_TIMEOUT */
+
 #ifndef SHELL_HELP_LIST_USER
 /**
  * @brief 是否在输出命令列表中列出用户
@@ -114,10 +206,22 @@
 /**
  * @brief shell命令参数最大数量
  *        包含命令名在内，超过16个参数并且使用了参数自动转换的情况下，需要修改源码
+ *        使能`SHELL_ARENA_SIZE`时，只限制普通C函数形式的命令
  */
 #define     SHELL_PARAMETER_MAX_NUMBER  8
 #endif /** SHELL_PARAMETER_MAX_NUMBER */
 
+#ifndef SHELL_ARENA_SIZE
+/**
+ * @brief 命令参数内存池大小
+ *        大于0时，命令参数列表，数组参数等在每次执行命令时从内存池中分配，命令返回后一次性释放，
+ *        main形式的命令参数数量只受内存池大小限制，普通C函数形式的命令仍然受`SHELL_PARAMETER_MAX_NUMBER`限制
+ *        建议不小于`(命令行长度 / 2 + 1) * sizeof(char *)`
+ *        设置为0时不使用内存池
+ */
+#define     SHELL_ARENA_SIZE            0
+#endif /** SHELL_ARENA_SIZE */
+
 #ifndef SHELL_HISTORY_MAX_NUMBER
 /**
  * @brief 历史命令记录数量
@@ -125,6 +229,52 @@
 #define     SHELL_HISTORY_MAX_NUMBER    5
 #endif /** SHELL_HISTORY_MAX_NUMBER */
 
+#ifndef SHELL_HISTORY_POOL
+/**
+ * @brief 使用可变长度的历史记录
+ *        使能后，shell缓冲的前`SHELL_COMMAND_MAX_LENGTH`字节作为命令行缓冲，其余部分作为历史记录池，
+ *        历史记录按照实际长度依次存放，池满时丢弃最旧的记录，记录数量不再受`SHELL_HISTORY_MAX_NUMBER`限制，
+ *        `SHELL_HISTORY_MAX_NUMBER`为0时仍然关闭历史记录
+ */
+#define     SHELL_HISTORY_POOL          0
+#endif /** SHELL_HISTORY_POOL */
+
+#ifndef SHELL_COMMAND_MAX_LENGTH
+/**
+ * @brief shell命令最大长度(包括结束符)
+ *        使能`SHELL_HISTORY_POOL`时使用，最大为shell缓冲的一半
+ */
+#define     SHELL_COMMAND_MAX_LENGTH    128
+#endif /** SHELL_COMMAND_MAX_LENGTH */
+
+#ifndef SHELL_HISTORY_SEARCH_LENGTH
+/**
+ * @brief 历史记录反向搜索(Ctrl-R)的最大搜索长度
+ *        设置为0时不使用历史记录搜索
+ * @note 需要使能`SHELL_HISTORY_POOL`
+ */
+#define     SHELL_HISTORY_SEARCH_LENGTH 0
+#endif /** SHELL_HISTORY_SEARCH_LENGTH */
+
+#ifndef SHELL_EXEC_CACHE_SIZE
+/**
+ * @brief 命令解析缓存数量
+ *        大于0时，shell缓存最近执行的命令行的分割结果，命令和数值参数的解析结果，
+ *        再次执行相同的命令行(比如从历史记录中调出)时，不再重新分割，查找命令和解析数值参数
+ *        此值必须为2的幂，切换用户或者命令表变化时缓存失效
+ *        设置为0时不使用命令解析缓存
+ */
+#define     SHELL_EXEC_CACHE_SIZE       0
+#endif /** SHELL_EXEC_CACHE_SIZE */
+
+#ifndef SHELL_EXEC_CACHE_LENGTH
+/**
+ * @brief 命令解析缓存的命令行最大长度(包括结束符)
+ *        超过此长度的命令行不会被缓存
+ */
+#define     SHELL_EXEC_CACHE_LENGTH     32
+#endif /** SHELL_EXEC_CACHE_LENGTH */
+
 #ifndef SHELL_DOUBLE_CLICK_TIME
 /**
  * @brief 双击间隔(ms)
@@ -159,12 +309,22 @@
 
 #ifndef SHELL_PRINT_BUFFER
 /**
- * @brief shell格式化输出的缓冲大小
+ * @brief shell格式化输出的分块大小
+ *        格式化结果直接写入输出缓冲，没有使用输出缓冲(`SHELL_WRITE_BUFFER`)时，
+ *        按照此大小分块输出，输出长度不受此限制
  *        为0时不使用shell格式化输出
  */
-#define     SHELL_PRINT_BUFFER          128
+#define     SHELL_PRINT_BUFFER          32
 #endif /** SHELL_PRINT_BUFFER */
 
+#ifndef SHELL_PRINT_FLOAT
+/**
+ * @brief shell格式化是否支持浮点数
+ *        为0时不支持`%f` `%e` `%g`，可以减小代码体积，浮点转换会原样输出
+ */
+#define     SHELL_PRINT_FLOAT           1
+#endif /** SHELL_PRINT_FLOAT */
+
 #ifndef SHELL_SCAN_BUFFER
 /**
  * @brief shell格式化输入的缓冲大小
@@ -174,6 +334,46 @@
 #define     SHELL_SCAN_BUFFER          0
 #endif /** SHELL_SCAN_BUFFER */
 
+#ifndef SHELL_READ_BUFFER
+/**
+ * @brief shell任务每次读取的最大字节数
+ *        大于1时，`shellTask()`每次调用`shell->read`读取多个字节，并使用`shellHandlerBlock()`整块处理，
+ *        此时`shell->read`需要返回当前已经接收到的数据，而不是等待读满指定的长度
+ * @note 命令执行过程中通过`shell->read`读取输入时，同一次读取到的命令之后的数据会在命令结束后才被处理
+ */
+#define     SHELL_READ_BUFFER           1
+#endif /** SHELL_READ_BUFFER */
+
+#ifndef SHELL_WRITE_BUFFER
+/**
+ * @brief shell输出缓冲大小
+ *        大于0时，shell的输出会先写入shell对象内的缓冲，在输出提示符，命令执行前后，缓冲满，
+ *        输入处理结束，或者调用`shellFlush()`时一次性调用`shell->write`输出
+ *        命令在等待输入前需要调用`shellFlush()`，保证之前的输出已经发送
+ *        设置为0时不使用输出缓冲
+ */
+#define     SHELL_WRITE_BUFFER          0
+#endif /** SHELL_WRITE_BUFFER */
+
+#ifndef SHELL_USING_TX
+/**
+ * @brief 是否使用异步输出
+ *        使能后，可以通过`shell->tx`为shell设置TX环形缓冲，shell的输出写入缓冲后立即返回，
+ *        由`ShellTx`的`kick`启动发送，发送完成后调用`shellTxComplete()`
+ */
+#define     SHELL_USING_TX              0
+#endif /** SHELL_USING_TX */
+
+#ifndef SHELL_ANSI_EDIT
+/**
+ * @brief 使用ANSI控制序列编辑命令行
+ *        使能后，命令行中间的插入和删除使用插入/删除字符序列(`ESC[@`, `ESC[P`)，光标移动使用带计数的
+ *        光标移动序列，历史命令和补全只重绘和当前命令行不同的部分，可以减少低速串口上的输出数据量
+ *        终端不支持ANSI控制序列时需要关闭，此时使用重新输出整行的方式
+ */
+#define     SHELL_ANSI_EDIT             0
+#endif /** SHELL_ANSI_EDIT */
+
 #ifndef SHELL_GET_TICK
 /**
  * @brief 获取系统时间(ms)
@@ -183,6 +383,17 @@
 #define     SHELL_GET_TICK()            0
 #endif /** SHELL_GET_TICK */
 
+#ifndef SHELL_GET_TASK
+/**
+ * @brief 获取当前任务标识
+ *        定义此宏为获取当前任务(线程)的标识，如`xTaskGetCurrentTaskHandle()`，
+ *        多个shell在不同的任务中执行命令(如后台任务)时，`shellGetCurrent`优先返回当前任务中活动的shell，
+ *        使用锁时，输出锁的嵌套由shell按照任务记录，输出锁使用普通互斥锁即可
+ * @note 此宏不定义时，`shellGetCurrent`返回第一个活动的shell，输出锁需要支持嵌套
+ */
+#define     SHELL_GET_TASK()            0
+#endif /** SHELL_GET_TASK */
+
 #ifndef SHELL_USING_LOCK
 /**
  * @brief 使用锁
@@ -207,6 +418,110 @@
 #define     SHELL_FREE(obj)             0
 #endif /** SHELL_FREE */
 
+#ifndef SHELL_ATOMIC_ENTER
+/**
+ * @brief shell原子操作临界区
+ *        不支持GCC`__atomic`内建函数的编译器(如ARMCC5, IAR)使用普通读写实现原子操作，
+ *        原子比较交换在此临界区中进行，多个任务或中断同时使用shell时，需要定义为关闭和打开中断(或调度器)，
+ *        必须是表达式，如`__disable_irq()`，使用GCC/Clang时不使用
+ */
+#define     SHELL_ATOMIC_ENTER()        ((void)0)
+#define     SHELL_ATOMIC_EXIT()         ((void)0)
+#endif /** SHELL_ATOMIC_ENTER */
+
+#if defined(__GNUC__) && !defined(__CC_ARM)
+#ifndef SHELL_ATOMIC_LOAD
+/**
+ * @brief shell原子读(acquire)
+ *        shell列表，命令提交队列等无锁结构使用，默认使用GCC/Clang的`__atomic`内建函数，
+ *        其他编译器默认使用普通读写和`SHELL_ATOMIC_ENTER`临界区实现
+ */
+#define     SHELL_ATOMIC_LOAD(ptr)      __atomic_load_n(ptr, __ATOMIC_ACQUIRE)
+#endif /** SHELL_ATOMIC_LOAD */
+
+#ifndef SHELL_ATOMIC_STORE
+/**
+ * @brief shell原子写(release)
+ */
+#define     SHELL_ATOMIC_STORE(ptr, value) \
+            __atomic_store_n(ptr, value, __ATOMIC_RELEASE)
+#endif /** SHELL_ATOMIC_STORE */
+
+#ifndef SHELL_ATOMIC_CAS
+/**
+ * @brief shell原子比较交换
+ *        `*ptr`等于`*expected`时写入`value`并返回1，否则将`*ptr`读入`*expected`并返回0
+ */
+#define     SHELL_ATOMIC_CAS(ptr, expected, value) \
+            __atomic_compare_exchange_n(ptr, expected, value, 1, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)
+#endif /** SHELL_ATOMIC_CAS */
+
+#ifndef SHELL_ATOMIC_FENCE
+/**
+ * @brief shell原子内存屏障(seq_cst)
+ *        动态命令表的读者和写者使用，保证写入自身状态之后才读取对方的状态
+ */
+#define     SHELL_ATOMIC_FENCE()        __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#endif /** SHELL_ATOMIC_FENCE */
+#else
+#ifndef SHELL_ATOMIC_LOAD
+/**
+ * @brief shell原子读，普通读
+ */
+#define     SHELL_ATOMIC_LOAD(ptr)      (*(ptr))
+#endif /** SHELL_ATOMIC_LOAD */
+
+#ifndef SHELL_ATOMIC_STORE
+/**
+ * @brief shell原子写，普通写
+ */
+#define     SHELL_ATOMIC_STORE(ptr, value) \
+            (*(ptr) = (value))
+#endif /** SHELL_ATOMIC_STORE */
+
+#ifndef SHELL_ATOMIC_CAS
+/**
+ * @brief shell原子比较交换，在`SHELL_ATOMIC_ENTER`临界区中比较和写入
+ */
+#define     SHELL_ATOMIC_CAS(ptr, expected, value) \
+            (SHELL_ATOMIC_ENTER(), \
+             (*(ptr) == *(expected) \
+                 ? (*(ptr) = (value), SHELL_ATOMIC_EXIT(), 1) \
+                 : (*(expected) = *(ptr), SHELL_ATOMIC_EXIT(), 0)))
+#endif /** SHELL_ATOMIC_CAS */
+
+#ifndef SHELL_ATOMIC_FENCE
+/**
+ * @brief shell原子内存屏障，单核MCU上不需要
+ */
+#define     SHELL_ATOMIC_FENCE()        ((void)0)
+#endif /** SHELL_ATOMIC_FENCE */
+#endif /** defined(__GNUC__) && !defined(__CC_ARM) */
+
+#ifndef SHELL_TX_CRITICAL_ENTER
+/**
+ * @brief TX环形缓冲临界区
+ *        默认使用`SHELL_ATOMIC_CAS`实现的自旋锁，适用于在其他线程中调用`shellTxComplete()`的情况，
+ *        在中断中调用`shellTxComplete()`时，需要定义为关闭中断和打开中断
+ */
+#define     SHELL_TX_CRITICAL_ENTER(tx) \
+            do { \
+                unsigned int __expected = 0; \
+                while (!SHELL_ATOMIC_CAS(&(tx)->spin, &__expected, 1)) { __expected = 0; } \
+            } while (0)
+#define     SHELL_TX_CRITICAL_EXIT(tx) \
+            SHELL_ATOMIC_STORE(&(tx)->spin, 0)
+#endif /** SHELL_TX_CRITICAL_ENTER */
+
+#ifndef SHELL_TX_WAIT
+/**
+ * @brief TX环形缓冲等待发送
+ *        缓冲满，需要等待发送完成时循环调用，默认为空循环，
+ *        使用RTOS并且发送线程优先级较低时，需要定义为让出CPU，如`osDelay(1)`
+ */
+#define     SHELL_TX_WAIT(tx)
+#endif /** SHELL_TX_WAIT */
+
 #ifndef SHELL_SHOW_INFO
 /**
  * @brief 是否显示shell信息
@@ -259,9 +574,111 @@
 /**
  * @brief 支持数组参数
  *        使能后，可以在命令中使用数组参数，如`cmd [1,2,3]`
- *        需要使能 `SHELL_USING_FUNC_SIGNATURE` 宏，并且配置 `SHELL_MALLOC`, `SHELL_FREE`
+ *        需要使能 `SHELL_USING_FUNC_SIGNATURE` 宏，并且配置 `SHELL_MALLOC`, `SHELL_FREE`，
+ *        使能`SHELL_ARENA_SIZE`时，数组从参数内存池中分配，不需要`SHELL_MALLOC`, `SHELL_FREE`
  */
 #define     SHELL_SUPPORT_ARRAY_PARAM   0
 #endif /** SHELL_SUPPORT_ARRAY_PARAM */
 
+#ifndef SHELL_CMD_INDEX_SIZE
+/**
+ * @brief 命令索引大小
+ *        大于0时，shell在初始化时为命令表建立一个哈希索引，命令查找不再需要遍历命令表
+ *        此值为索引的槽位数量，必须为2的幂，并且需要大于命令表的条目数量，建议为条目数量的1.5倍以上
+ *        索引占用RAM约为`SHELL_CMD_INDEX_SIZE * 10`字节，同时用于tab补全，索引建立失败时自动退化为遍历查找
+ *        设置为0时不使用索引
+ */
+#define     SHELL_CMD_INDEX_SIZE        0
+#endif /** SHELL_CMD_INDEX_SIZE */
+
+#ifndef SHELL_CMD_SORTED_SECTION
+/**
+ * @brief 使用排序的命令段
+ *        使能后，导出的命令，变量和用户会按照名称放入`shellCommand.<name>`段，链接时需要按段名排序，
+ *        shell在初始化时检查命令表的排序，对有序的部分使用二分查找，不占用额外的RAM
+ *        链接脚本的配置参考README，命令表未排序或者存在重名时，初始化时会输出警告，并退化为遍历查找
+ */
+#define     SHELL_CMD_SORTED_SECTION    0
+#endif /** SHELL_CMD_SORTED_SECTION */
+
+#ifndef SHELL_CMD_COMPACT
+/**
+ * @brief 使用紧凑的命令表
+ *        使能后，每个命令条目只包含属性和两个指针，命令名，描述和函数签名合并为一个字符串，
+ *        按键键值和描述合并存放，参数解析器的解析函数和清理函数单独存放，
+ *        32位平台每个条目从16~20字节减少到12字节，字符串直接使用字面量，可以被链接器合并
+ *        使能后不能通过`SHELL_EXPORT_CMD()`的可变参数设置函数签名，需要使用`SHELL_EXPORT_CMD_SIGN()`
+ */
+#define     SHELL_CMD_COMPACT           0
+#endif /** SHELL_CMD_COMPACT */
+
+#ifndef SHELL_DESC_STRIP
+/**
+ * @brief 剥离命令描述
+ *        使能后，导出的命令，变量，用户和按键的描述放入单独的`shellDesc`段，shell不再读取描述，
+ *        列出命令和命令帮助时输出描述的ID(描述在段中的偏移)，生成固件时可以剥离此段，
+ *        在主机上使用`tools/shellTools.py`从elf文件生成描述字典，并还原终端输出中的描述ID
+ *        需要使能`SHELL_USING_CMD_EXPORT`，并且不能和`SHELL_CMD_COMPACT`同时使用
+ */
+#define     SHELL_DESC_STRIP            0
+#endif /** SHELL_DESC_STRIP */
+
+#ifndef SHELL_DYNAMIC_CMD_NUMBER
+/**
+ * @brief 动态命令表数量
+ *        大于0时，可以使用`shellRegisterCommands()`在运行时注册命令表，注册的命令表在所有shell中可用，
+ *        查找静态命令表失败后再查找动态命令表，没有注册命令表时，只增加一次原子读
+ *        动态命令表的更新使用RCU方式，读者不加锁，注册和注销会等待所有读者退出旧的快照，
+ *        读者计数不依赖shell列表，没有加入shell列表的shell同样可以安全地使用动态命令
+ */
+#define     SHELL_DYNAMIC_CMD_NUMBER    0
+#endif /** SHELL_DYNAMIC_CMD_NUMBER */
+
+#ifndef SHELL_DYNAMIC_CMD_WAIT
+/**
+ * @brief 动态命令表写者等待
+ *        注册和注销命令表等待写者锁和宽限期时循环调用，默认为空循环，
+ *        使用RTOS时需要定义为让出CPU，如`osDelay(1)`，否则高优先级的写者会一直占用CPU，
+ *        持有写者锁的低优先级写者和临界区中的低优先级读者无法运行(优先级反转)
+ */
+#define     SHELL_DYNAMIC_CMD_WAIT()
+#endif /** SHELL_DYNAMIC_CMD_WAIT */
+
+#ifndef SHELL_KEY_TRIE_SIZE
+/**
+ * @brief 按键前缀树节点数量
+ *        大于0时，shell在初始化时将按键定义编译为前缀树，每个输入字节只需要查找一次前缀树，
+ *        不再需要遍历命令表，同时支持使用`SHELL_EXPORT_KEY_SEQUENCE()`定义超过4字节的按键序列
+ *        此值需要不小于所有按键序列的字节数之和(公共前缀只计算一次)，前缀树建立失败时自动退化为遍历匹配
+ *        设置为0时不使用前缀树
+ * @note 按键定义增加一个按键序列指针，不使用`SHELL_CMD_COMPACT`时，按键成为命令表中最大的成员，
+ *       每个`ShellCommand`(包括命令，变量和用户)都会增加一个指针的大小，增加Flash占用，
+ *       使能`SHELL_USING_FUNC_SIGNATURE`时命令定义已经包含签名指针，命令表大小不变
+ */
+#define     SHELL_KEY_TRIE_SIZE         0
+#endif /** SHELL_KEY_TRIE_SIZE */
+
+#ifndef SHELL_CMD_VIEW_NUMBER
+/**
+ * @brief 用户命令视图缓存数量
+ *        大于0时，shell在切换用户时为用户权限建立命令表的访问位图，权限检查，命令查找和命令列出
+ *        直接使用位图，不再逐条检查权限，视图由使用相同权限的shell共享，
+ *        只有没有shell使用的视图会被替换重建，没有可用的视图时shell逐条检查权限
+ *        需要使能`SHELL_CMD_INDEX_SIZE`，每个视图占用RAM约为`SHELL_CMD_INDEX_SIZE / 4`字节
+ *        设置为0时不使用命令视图
+ */
+#define     SHELL_CMD_VIEW_NUMBER       0
+#endif /** SHELL_CMD_VIEW_NUMBER */
+
+#ifndef SHELL_SIGN_POOL_SIZE
+/**
+ * @brief 预编译函数签名的参数数量
+ *        大于0时，shell在初始化时把命令表中的函数签名编译为参数类型数组，并解析好自定义类型的解析器，
+ *        执行命令时直接按照参数类型解析参数，不再遍历签名字符串和比较类型
+ *        此值为所有函数签名的参数数量之和，每个参数占用RAM 4字节，空间不足的签名在执行时解析
+ *        需要使能`SHELL_USING_FUNC_SIGNATURE`和`SHELL_CMD_INDEX_SIZE`，设置为0时不预编译函数签名
+ */
+#define     SHELL_SIGN_POOL_SIZE        0
+#endif /** SHELL_SIGN_POOL_SIZE */
+
 #endif
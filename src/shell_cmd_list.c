@@ -42,9 +42,14 @@ SHELL_AGENCY_FUNC(shellRun, shellGetCurrent(), (const char *)p1);
 const ShellCommand shellCommandList[] = 
 {
     {.attr.value=SHELL_CMD_PERMISSION(0)|SHELL_CMD_TYPE(SHELL_TYPE_USER),
+#if SHELL_CMD_COMPACT == 1
+    .data.user.name = SHELL_DEFAULT_USER "\0" "default user",
+    .data.user.password = SHELL_DEFAULT_USER_PASSWORD},
+#else
     .data.user.name = SHELL_DEFAULT_USER,
     .data.user.password = SHELL_DEFAULT_USER_PASSWORD,
     .data.user.desc = "default user"},
+#endif
     SHELL_CMD_ITEM(SHELL_CMD_PERMISSION(0)|SHELL_CMD_TYPE(SHELL_TYPE_CMD_FUNC),
                    setVar, shellSetVar, set var),
     SHELL_KEY_ITEM(SHELL_CMD_PERMISSION(0), 0x1B5B4100, shellUp, up),
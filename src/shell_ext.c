@@ -13,21 +13,78 @@
 #include "shell.h"
 #include "shell_ext.h"
 #include "string.h"
+#include "stdlib.h"
 
 extern ShellCommand* shellSeekCommand(Shell *shell,
                                       const char *cmd,
                                       ShellCommand *base,
                                       unsigned short compareLength);
 extern int shellGetVarValue(Shell *shell, ShellCommand *command);
+extern signed char shellCheckPermission(Shell *shell, ShellCommand *command);
+
+/**
+ * @brief 扫描得到的数字
+ */
+typedef struct
+{
+    unsigned long long mantissa;                        /**< 整数值，小数为有效数字 */
+    int exponent;                                       /**< 小数的十进制指数 */
+    unsigned char type;                                 /**< 数字类型 ShellNumType */
+    unsigned char negative;                             /**< 负数 */
+    unsigned char truncated;                            /**< 有效数字超过19位，被截断 */
+} ShellNumber;
 
 #if SHELL_SUPPORT_ARRAY_PARAM == 1
 extern int shellSplit(char *string, unsigned short strLen, char *array[], char splitKey, short maxNum);
 
-static int shellExtParseArray(Shell *shell, char *string, char *type, size_t *result);
-static int shellExtCleanerArray(Shell *shell, char *type, void *param);
+static int shellExtParseArray(Shell *shell, char *string, const ShellParamCode *code, size_t *result);
+static int shellExtCleanerArray(Shell *shell, const ShellParamCode *code, void *param);
 #endif /** SHELL_SUPPORT_ARRAY_PARAM == 1 */
 
+#if SHELL_SIGN_POOL_SIZE > 0
+/**
+ * @brief 预编译的函数签名
+ *        命令表中所有函数签名编译后的参数类型依次存放，按照命令在命令表中的序号查找
+ */
+static struct
+{
+    ShellCommand *base;                                 /**< 编译签名的命令表基址 */
+    unsigned short count;                               /**< 编译签名的命令表条目数量 */
+    unsigned short offset[SHELL_CMD_INDEX_SIZE];        /**< 命令的参数类型在池中的位置 + 1，0表示没有编译 */
+    unsigned char number[SHELL_CMD_INDEX_SIZE];         /**< 命令的参数数量 */
+    ShellParamCode code[SHELL_SIGN_POOL_SIZE];          /**< 参数类型池 */
+} shellSign;
+#endif /** SHELL_SIGN_POOL_SIZE > 0 */
+
 #if SHELL_USING_FUNC_SIGNATURE == 1
+#if SHELL_CMD_COMPACT == 1
+#define     shellExtGetParser(_parser)      ((_parser)->data.paramParser.func->parser)
+#define     shellExtGetCleaner(_parser)     ((_parser)->data.paramParser.func->cleaner)
+#else
+#define     shellExtGetParser(_parser)      ((_parser)->data.paramParser.parser)
+#define     shellExtGetCleaner(_parser)     ((_parser)->data.paramParser.cleaner)
+#endif /** SHELL_CMD_COMPACT == 1 */
+
+/**
+ * @brief 获取命令的函数签名
+ *        紧凑命令表中，函数签名存放在命令描述之后，空字符串表示没有签名
+ * 
+ * @param command 命令
+ * 
+ * @return const char* 函数签名，没有签名返回NULL
+ */
+static const char* shellExtGetSignature(const ShellCommand *command)
+{
+#if SHELL_CMD_COMPACT == 1
+    const char *string = command->data.cmd.name;
+    string += strlen(string) + 1;
+    string += strlen(string) + 1;
+    return *string ? string : NULL;
+#else
+    return command->data.cmd.signature;
+#endif
+}
+
 /**
  * @brief 获取下一个参数类型
  * 
@@ -67,106 +124,103 @@ static int shellGetNextParamType(const char *signature, int index, char *type)
 }
 
 /**
- * @brief 获取期待的参数个数
- * 
- * @param signature 函数签名
+ * @brief 编译参数类型
  * 
- * @return int 参数个数
- */
-static int shellGetParamNumExcept(const char *signature)
-{
-    int num = 0;
-    const char *p = signature;
-    
-    while (*p)
-    {
-    #if SHELL_SUPPORT_ARRAY_PARAM == 1
-        if (*p == '[')
-        {
-            p++;
-        }
-    #endif /** SHELL_SUPPORT_ARRAY_PARAM == 1 */
-        if (*p == 'L')
-        {
-            while (*p != ';' && *p != 0)
-            {
-                p++;
-            }
-            p++;
-        }
-        else
-        {
-            p++;
-        }
-        num++;
-    }
-    return num;
-}
-#endif
-
-/**
- * @brief 判断数字进制
+ * @param shell shell对象
+ * @param type 参数类型
+ * @param code 编译后的参数类型
  * 
- * @param string 参数字符串
- * @return ShellNumType 进制
+ * @return int 0 编译成功 -1 找不到自定义类型的解析器
  */
-static ShellNumType shellExtNumType(char *string)
+static int shellExtTypeCode(Shell *shell, const char *type, ShellParamCode *code)
 {
-    char *p = string;
-    ShellNumType type = NUM_TYPE_DEC;
-
-    if ((*p == '0') && ((*(p + 1) == 'x') || (*(p + 1) == 'X')))
-    {
-        type = NUM_TYPE_HEX;
-    }
-    else if ((*p == '0') && ((*(p + 1) == 'b') || (*(p + 1) == 'B')))
-    {
-        type = NUM_TYPE_BIN;
-    }
-    else if (*p == '0')
+    code->array = 0;
+    code->parser = 0;
+#if SHELL_SUPPORT_ARRAY_PARAM == 1
+    if (*type == '[')
     {
-        type = NUM_TYPE_OCT;
+        code->array = 1;
+        type++;
     }
-    
-    while (*p++)
+#endif /** SHELL_SUPPORT_ARRAY_PARAM == 1 */
+    if (type[0] != 0 && type[1] == 0)
     {
-        if (*p == '.' && *(p + 1) != 0)
+        switch (type[0])
         {
-            type = NUM_TYPE_FLOAT;
+        case 'c':
+            code->type = PARAM_TYPE_CHAR;
+            return 0;
+        case 'q':
+            code->type = PARAM_TYPE_INT8;
+            return 0;
+        case 'h':
+            code->type = PARAM_TYPE_INT16;
+            return 0;
+        case 'i':
+            code->type = PARAM_TYPE_INT32;
+            return 0;
+        case 'f':
+            code->type = PARAM_TYPE_FLOAT;
+            return 0;
+        case 'p':
+            code->type = PARAM_TYPE_POINTER;
+            return 0;
+        case 'l':
+            code->type = PARAM_TYPE_INT64;
+            return 0;
+        case 'd':
+            code->type = PARAM_TYPE_DOUBLE;
+            return 0;
+        case 's':
+            code->type = PARAM_TYPE_STRING;
+            return 0;
+        default:
             break;
         }
     }
-
-    return type;
+    ShellCommand *parser = shellSeekCommand(shell,
+                                            type,
+                                            shell->commandList.base,
+                                            0);
+    if (parser == NULL)
+    {
+        return -1;
+    }
+    code->type = PARAM_TYPE_CUSTOM;
+    code->parser = parser - (ShellCommand *)shell->commandList.base + 1;
+    return 0;
 }
 
-
 /**
- * @brief 字符转数字
+ * @brief 编译函数签名
+ *        超过`max`的参数只计数，不编译
  * 
- * @param code 字符
- * @return char 数字
+ * @param shell shell对象
+ * @param signature 函数签名
+ * @param code 编译后的参数类型
+ * @param max 最多编译的参数数量
+ * @param type 类型缓冲，编译失败时为找不到解析器的类型
+ * 
+ * @return int 参数数量，-1 编译失败
  */
-static char shellExtToNum(char code)
+static int shellExtSignCompile(Shell *shell, const char *signature,
+                               ShellParamCode *code, int max, char *type)
 {
-    if ((code >= '0') && (code <= '9'))
-    {
-        return code -'0';
-    }
-    else if ((code >= 'a') && (code <= 'f'))
-    {
-        return code - 'a' + 10;
-    }
-    else if ((code >= 'A') && (code <= 'F'))
-    {
-        return code - 'A' + 10;
-    }
-    else
+    int index = 0;
+    int number = 0;
+
+    while (signature[index])
     {
-        return 0;
+        index = shellGetNextParamType(signature, index, type);
+        if (number < max && shellExtTypeCode(shell, type, &code[number]) != 0)
+        {
+            return -1;
+        }
+        number++;
     }
+    return number;
 }
-
+#endif
 
 /**
  * @brief 解析字符参数
@@ -251,73 +305,245 @@ static char* shellExtParseString(char *string)
 
 
 /**
- * @brief 解析数字参数
+ * @brief 扫描数字参数
+ *        一次遍历完成符号，进制和数字的解析，整数按照64位无符号数累加并检查溢出，
+ *        十进制小数保存最多19位有效数字和十进制指数，由`shellExtNumberToDouble`等转换，
+ *        超出64位的十进制整数按照小数处理，
+ *        以0开头的数字包含`.`，`e`或者数字8，9时按照十进制解析，否则按照八进制解析
+ *        格式错误时，number中保存已经解析的部分
  * 
  * @param string 字符串参数
- * @return size_t 解析出的数字
+ * @param number 解析出的数字
+ * 
+ * @return int 0 解析成功 -1 格式错误或溢出
  */
-static size_t shellExtParseNumber(char *string)
+static int shellExtScanNumber(const char *string, ShellNumber *number)
 {
-    ShellNumType type = NUM_TYPE_DEC;
-    char radix = 10;
-    char *p = string;
-    char offset = 0;
-    signed char sign = 1;
-    size_t valueInt = 0;
-    float valueFloat = 0.0;
-    size_t devide = 0;
+    const char *p = string;
+    unsigned char radix = 10;
+    unsigned char digit;
+    unsigned char dot = 0;
+    unsigned char digits = 0;
+
+    number->mantissa = 0;
+    number->exponent = 0;
+    number->type = NUM_TYPE_DEC;
+    number->negative = 0;
+    number->truncated = 0;
 
-    if (*string == '-')
+    if (*p == '-' || *p == '+')
     {
-        sign = -1;
+        number->negative = (*p++ == '-');
     }
-
-    type = shellExtNumType(string + ((sign == -1) ? 1 : 0));
-
-    switch ((char)type)
+    if (*p == '\'')
     {
-    case NUM_TYPE_HEX:
+        number->mantissa = (unsigned char)shellExtParseChar((char *)p);
+        return 0;
+    }
+    if (p[0] == '0' && (p[1] | 0x20) == 'x')
+    {
+        number->type = NUM_TYPE_HEX;
         radix = 16;
-        offset = 2;
-        break;
-    
-    case NUM_TYPE_OCT:
-        radix = 8;
-        offset = 1;
-        break;
-
-    case NUM_TYPE_BIN:
+        p += 2;
+    }
+    else if (p[0] == '0' && (p[1] | 0x20) == 'b')
+    {
+        number->type = NUM_TYPE_BIN;
         radix = 2;
-        offset = 2;
-        break;
-    
-    default:
-        break;
+        p += 2;
+    }
+    else if (p[0] == '0' && p[1] >= '0' && p[1] <= '9' && strpbrk(p, ".eE89") == NULL)
+    {
+        number->type = NUM_TYPE_OCT;
+        radix = 8;
+        p += 1;
     }
 
-    p = string + offset + ((sign == -1) ? 1 : 0);
-
-    while (*p)
+    for (; *p; p++)
     {
-        if (*p == '.')
+        if (*p >= '0' && *p <= '9')
         {
-            devide = 1;
-            p++;
+            digit = *p - '0';
+        }
+        else if (radix == 16 && (*p | 0x20) >= 'a' && (*p | 0x20) <= 'f')
+        {
+            digit = (*p | 0x20) - 'a' + 10;
+        }
+        else if (radix == 10 && *p == '.' && !dot)
+        {
+            dot = 1;
+            number->type = NUM_TYPE_FLOAT;
             continue;
         }
-        valueInt = valueInt * radix + shellExtToNum(*p);
-        devide *= 10;
-        p++;
+        else if (radix == 10 && (*p | 0x20) == 'e' && digits > 0)
+        {
+            int exponent = 0;
+            unsigned char negative = 0;
+            number->type = NUM_TYPE_FLOAT;
+            if (*++p == '-' || *p == '+')
+            {
+                negative = (*p++ == '-');
+            }
+            if (*p < '0' || *p > '9')
+            {
+                return -1;
+            }
+            for (; *p >= '0' && *p <= '9'; p++)
+            {
+                if (exponent < 10000)
+                {
+                    exponent = exponent * 10 + (*p - '0');
+                }
+            }
+            number->exponent += negative ? -exponent : exponent;
+            return *p ? -1 : 0;
+        }
+        else
+        {
+            return -1;
+        }
+        if (digit >= radix)
+        {
+            return -1;
+        }
+        digits++;
+        if (radix == 10)
+        {
+            if (number->mantissa < 1844674407370955161ULL
+                || (number->mantissa == 1844674407370955161ULL && digit <= 5))
+            {
+                number->mantissa = number->mantissa * 10 + digit;
+                number->exponent -= dot;
+            }
+            else
+            {
+                number->exponent += !dot;
+                number->truncated |= (digit != 0);
+            }
+        }
+        else
+        {
+            if (number->mantissa > (~0ULL - digit) / radix)
+            {
+                return -1;
+            }
+            number->mantissa = number->mantissa * radix + digit;
+        }
     }
-    if (type == NUM_TYPE_FLOAT && devide != 0)
+    if (digits == 0)
     {
-        valueFloat = (float)valueInt / devide * sign;
-        return *(size_t *)(&valueFloat);
+        return -1;
     }
-    else
+    if (number->type == NUM_TYPE_DEC
+        && (number->exponent != 0
+            || (number->negative && number->mantissa > (1ULL << 63))))
+    {
+        number->type = NUM_TYPE_FLOAT;
+    }
+    else if (number->type != NUM_TYPE_FLOAT
+             && number->negative && number->mantissa > (1ULL << 63))
+    {
+        return -1;
+    }
+    return 0;
+}
+
+
+/**
+ * @brief 10的整数次幂，双精度浮点可以精确表示的部分
+ */
+static const double shellExtPow10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+
+#if SHELL_USING_FUNC_SIGNATURE == 1
+/**
+ * @brief 数字转换为双精度浮点
+ *        有效数字不超过2^53并且10的指数可以精确表示时，一次乘法或除法得到正确舍入的结果，
+ *        其他情况使用`strtod`
+ * 
+ * @param number 扫描得到的数字
+ * @param string 字符串参数
+ * 
+ * @return double 转换结果
+ */
+static double shellExtNumberToDouble(const ShellNumber *number, const char *string)
+{
+    unsigned long long mantissa = number->mantissa;
+    int exponent = number->exponent;
+    double value;
+
+    if (number->type != NUM_TYPE_FLOAT)
+    {
+        return number->negative ? -(double)mantissa : (double)mantissa;
+    }
+    while (exponent > 22 && mantissa <= (1ULL << 53) / 10 && !number->truncated)
     {
-        return valueInt * sign;
+        mantissa *= 10;
+        exponent--;
     }
+    if (number->truncated || mantissa > (1ULL << 53) || exponent < -22 || exponent > 22)
+    {
+        return strtod(string, NULL);
+    }
+    value = (double)mantissa;
+    value = exponent < 0 ? value / shellExtPow10[-exponent] : value * shellExtPow10[exponent];
+    return number->negative ? -value : value;
+}
+#endif /** SHELL_USING_FUNC_SIGNATURE == 1 */
+
+
+/**
+ * @brief 数字转换为单精度浮点
+ *        有效数字不超过2^24并且10的指数不超过10时直接计算，其他情况使用`strtof`，
+ *        不经过双精度浮点，避免两次舍入
+ * 
+ * @param number 扫描得到的数字
+ * @param string 字符串参数
+ * 
+ * @return float 转换结果
+ */
+static float shellExtNumberToFloat(const ShellNumber *number, const char *string)
+{
+    float value;
+
+    if (number->type != NUM_TYPE_FLOAT)
+    {
+        return number->negative ? -(float)number->mantissa : (float)number->mantissa;
+    }
+    if (number->truncated || number->mantissa > (1UL << 24)
+        || number->exponent < -10 || number->exponent > 10)
+    {
+        return strtof(string, NULL);
+    }
+    value = (float)number->mantissa;
+    value = number->exponent < 0 ? value / (float)shellExtPow10[-number->exponent]
+                                 : value * (float)shellExtPow10[number->exponent];
+    return number->negative ? -value : value;
+}
+
+
+/**
+ * @brief 解析数字参数
+ * 
+ * @param string 字符串参数
+ * @return size_t 解析出的数字，小数返回单精度浮点的二进制值
+ */
+static size_t shellExtParseNumber(char *string)
+{
+    ShellNumber number;
+    size_t value = 0;
+
+    shellExtScanNumber(string, &number);
+    if (number.type == NUM_TYPE_FLOAT)
+    {
+        float valueFloat = shellExtNumberToFloat(&number, string);
+        memcpy(&value, &valueFloat, sizeof(float));
+        return value;
+    }
+    return (size_t)(number.negative ? 0 - number.mantissa : number.mantissa);
 }
 
 
@@ -348,6 +574,171 @@ static int shellExtParseVar(Shell *shell, char *var, size_t *result)
 }
 
 
+#if SHELL_USING_FUNC_SIGNATURE == 1
+/**
+ * @brief 基本参数类型对应的签名字符，按照`ShellParamType`排列
+ */
+static const char shellExtTypeChar[] = "cqhifplds";
+
+
+/**
+ * @brief 检查整数是否在参数类型的范围内
+ *        正数按照无符号范围检查，负数按照有符号范围检查，比如`q`类型可以输入-128到255
+ * 
+ * @param number 扫描得到的数字
+ * @param type 参数类型
+ * 
+ * @return int 1 在范围内 0 超出范围
+ */
+static int shellExtNumberInRange(const ShellNumber *number, ShellParamType type)
+{
+    unsigned char bits = type == PARAM_TYPE_INT8 ? 8
+                       : type == PARAM_TYPE_INT16 ? 16
+                       : type == PARAM_TYPE_INT32 ? 32
+                       : sizeof(void *) * 8;
+
+    if (bits >= 64)
+    {
+        return 1;
+    }
+    return number->negative ? number->mantissa <= (1ULL << (bits - 1))
+                            : number->mantissa < (1ULL << bits);
+}
+
+
+/**
+ * @brief 按照编译后的参数类型解析参数
+ *        64位整型和双精度浮点参数以指针传递，解析前`*result`需要指向保存结果的8字节内存，
+ *        变量参数(`$var`)同样转换后写入这块内存
+ * 
+ * @param shell shell对象
+ * @param string 参数
+ * @param code 参数类型
+ * @param result 解析结果
+ * 
+ * @return int 0 解析成功 --1 解析失败
+ */
+static int shellExtParseCode(Shell *shell, char *string,
+                             const ShellParamCode *code, size_t *result)
+{
+    if (*string == '$' && *(string + 1))
+    {
+        if (code->array
+            || (code->type != PARAM_TYPE_INT64 && code->type != PARAM_TYPE_DOUBLE))
+        {
+            return shellExtParseVar(shell, string, result);
+        }
+        size_t var;
+        if (shellExtParseVar(shell, string, &var) != 0)
+        {
+            return -1;
+        }
+        if (code->type == PARAM_TYPE_INT64)
+        {
+            long long value = (int) var;
+            memcpy((void *)*result, &value, sizeof(value));
+        }
+        else
+        {
+            double value = (int) var;
+            memcpy((void *)*result, &value, sizeof(value));
+        }
+        return 0;
+    }
+#if SHELL_SUPPORT_ARRAY_PARAM == 1
+    if (code->array)
+    {
+        return shellExtParseArray(shell, string, code, result);
+    }
+#endif /** SHELL_SUPPORT_ARRAY_PARAM == 1 */
+    ShellNumber number;
+    switch (code->type)
+    {
+    case PARAM_TYPE_CHAR:
+        *result = (size_t)shellExtParseChar(string);
+        return 0;
+    case PARAM_TYPE_INT8:
+    case PARAM_TYPE_INT16:
+    case PARAM_TYPE_INT32:
+    case PARAM_TYPE_POINTER:
+        if (shellExtScanNumber(string, &number) != 0 || number.type == NUM_TYPE_FLOAT
+            || !shellExtNumberInRange(&number, code->type))
+        {
+            break;
+        }
+        *result = (size_t)(number.negative ? 0 - number.mantissa : number.mantissa);
+        return 0;
+    case PARAM_TYPE_FLOAT:
+        if (shellExtScanNumber(string, &number) != 0)
+        {
+            break;
+        }
+        else
+        {
+            float value = shellExtNumberToFloat(&number, string);
+            *result = 0;
+            memcpy(result, &value, sizeof(float));
+        }
+        return 0;
+    case PARAM_TYPE_INT64:
+        if (shellExtScanNumber(string, &number) != 0 || number.type == NUM_TYPE_FLOAT)
+        {
+            break;
+        }
+        else
+        {
+            unsigned long long value = number.negative ? 0 - number.mantissa : number.mantissa;
+            memcpy((void *)*result, &value, sizeof(value));
+        }
+        return 0;
+    case PARAM_TYPE_DOUBLE:
+        if (shellExtScanNumber(string, &number) != 0)
+        {
+            break;
+        }
+        else
+        {
+            double value = shellExtNumberToDouble(&number, string);
+            memcpy((void *)*result, &value, sizeof(value));
+        }
+        return 0;
+    case PARAM_TYPE_STRING:
+        *result = (size_t)shellExtParseString(string);
+        return 0;
+    default:
+        break;
+    }
+    if (code->type != PARAM_TYPE_CUSTOM)
+    {
+        char type[2] = {shellExtTypeChar[code->type], 0};
+        shellWriteString(shell, "Parse param for type: ");
+        shellWriteString(shell, type);
+        shellWriteString(shell, " failed\r\n");
+        return -1;
+    }
+
+    ShellCommand *parser = (ShellCommand *)shell->commandList.base + code->parser - 1;
+    void *param;
+    if (shellCheckPermission(shell, parser) != 0)
+    {
+        shellWriteString(shell, "Can't find the param parser for type: ");
+        shellWriteString(shell, parser->data.paramParser.type);
+        shellWriteString(shell, "\r\n");
+        return -1;
+    }
+    if (shellExtGetParser(parser)(shellExtParseString(string), &param) == 0)
+    {
+        *result = (size_t)param;
+        return 0;
+    }
+    shellWriteString(shell, "Parse param for type: ");
+    shellWriteString(shell, parser->data.paramParser.type);
+    shellWriteString(shell, " failed\r\n");
+    return -1;
+}
+#endif /** SHELL_USING_FUNC_SIGNATURE == 1 */
+
+
 /**
  * @brief 解析参数
  * 
@@ -385,65 +776,15 @@ int shellExtParsePara(Shell *shell, char *string, char *type, size_t *result)
 #if SHELL_USING_FUNC_SIGNATURE == 1
     else
     {
-        if (*string == '$' && *(string + 1))
+        ShellParamCode code;
+        if (shellExtTypeCode(shell, type, &code) != 0)
         {
-            return shellExtParseVar(shell, string, result);
-        }
-    #if SHELL_SUPPORT_ARRAY_PARAM == 1
-        else if (type[0] == '[')
-        {
-            return shellExtParseArray(shell, string, type, result);
-        }
-    #endif /** SHELL_SUPPORT_ARRAY_PARAM == 1 */
-        else if (strcmp("c", type) == 0)
-        {
-            *result = (size_t)shellExtParseChar(string);
-            return 0;
-        }
-        else if (strcmp("q", type) == 0
-                 || strcmp("h", type) == 0
-                 || strcmp("i", type) == 0
-                 || strcmp("f", type) == 0
-                 || strcmp("p", type) == 0)
-        {
-            *result = shellExtParseNumber(string);
-            return 0;
-        }
-        else if (strcmp("s", type) == 0)
-        {
-            *result = (size_t)shellExtParseString(string);
-            return 0;
-        }
-        else
-        {
-            ShellCommand *command = shellSeekCommand(shell,
-                                                     type,
-                                                     shell->commandList.base,
-                                                     0);
-            if (command != NULL)
-            {
-                void *param;
-                if (command->data.paramParser.parser(shellExtParseString(string), &param) == 0)
-                {
-                    *result = (size_t)param;
-                    return 0;
-                }
-                else
-                {
-                    shellWriteString(shell, "Parse param for type: ");
-                    shellWriteString(shell, type);
-                    shellWriteString(shell, " failed\r\n");
-                    return -1;
-                }
-            }
-            else
-            {
-                shellWriteString(shell, "Can't find the param parser for type: ");
-                shellWriteString(shell, type);
-                shellWriteString(shell, "\r\n");
-                return -1;
-            }
+            shellWriteString(shell, "Can't find the param parser for type: ");
+            shellWriteString(shell, type);
+            shellWriteString(shell, "\r\n");
+            return -1;
         }
+        return shellExtParseCode(shell, string, &code, result);
     }
 #endif /** SHELL_USING_FUNC_SIGNATURE == 1 */
     return -1;
@@ -451,6 +792,36 @@ int shellExtParsePara(Shell *shell, char *string, char *type, size_t *result)
 
 
 #if SHELL_USING_FUNC_SIGNATURE == 1
+/**
+ * @brief 按照编译后的参数类型清理参数
+ * 
+ * @param shell shell对象
+ * @param code 参数类型
+ * @param param 参数
+ * 
+ * @return int 0 清理成功 -1 清理失败
+ */
+static int shellExtCleanerCode(Shell *shell, const ShellParamCode *code, size_t param)
+{
+#if SHELL_SUPPORT_ARRAY_PARAM == 1
+    if (code->array)
+    {
+        return shellExtCleanerArray(shell, code, (void *) param);
+    }
+#endif /** SHELL_SUPPORT_ARRAY_PARAM == 1 */
+    if (code->type != PARAM_TYPE_CUSTOM)
+    {
+        return 0;
+    }
+    ShellCommand *parser = (ShellCommand *)shell->commandList.base + code->parser - 1;
+    if (shellExtGetCleaner(parser) != NULL)
+    {
+        return shellExtGetCleaner(parser)((void *)param);
+    }
+    return -1;
+}
+
+
 /**
  * @brief 清理参数
  * 
@@ -462,44 +833,45 @@ int shellExtParsePara(Shell *shell, char *string, char *type, size_t *result)
  */
 int shellExtCleanerPara(Shell *shell, char *type, size_t param)
 {
+    ShellParamCode code;
+
     if (type == NULL)
     {
         return 0;
     }
-    else
+    if (shellExtTypeCode(shell, type, &code) != 0)
     {
-    #if SHELL_SUPPORT_ARRAY_PARAM == 1
-        if (type[0] == '[') {
-            return shellExtCleanerArray(shell, type, (void *) param);
-        }
-        else
-    #endif /** SHELL_SUPPORT_ARRAY_PARAM == 1 */
-        if (strcmp("c", type) == 0
-            || strcmp("q", type) == 0
-            || strcmp("h", type) == 0
-            || strcmp("i", type) == 0
-            || strcmp("f", type) == 0
-            || strcmp("p", type) == 0
-            || strcmp("s", type) == 0)
-        {
-            return 0;
-        }
-        else
-        {
-            ShellCommand *command = shellSeekCommand(shell,
-                                                     type,
-                                                     shell->commandList.base,
-                                                     0);
-            if (command != NULL && command->data.paramParser.cleaner != NULL)
-            {
-                return command->data.paramParser.cleaner((void *)param);
-            }
-        }
+        return -1;
     }
-    return -1;
+    return shellExtCleanerCode(shell, &code, param);
 }
 #endif /** SHELL_USING_FUNC_SIGNATURE == 1 */
 
+#if SHELL_EXEC_CACHE_SIZE > 0
+/**
+ * @brief 判断参数的解析结果是否可以缓存
+ *        只缓存数值和字符参数，字符串，变量，数组和自定义类型每次执行时重新解析
+ * 
+ * @param string 参数
+ * @param code 参数类型，NULL表示没有函数签名
+ * 
+ * @return int 1 可以缓存 0 不能缓存
+ */
+static int shellExtParaCacheable(char *string, const ShellParamCode *code)
+{
+    if (*string == '$')
+    {
+        return 0;
+    }
+    if (code != NULL)
+    {
+        return !code->array && code->type <= PARAM_TYPE_POINTER;
+    }
+    return (*string == '\'' && *(string + 1))
+           || *string == '-' || (*string >= '0' && *string <= '9');
+}
+#endif /** SHELL_EXEC_CACHE_SIZE > 0 */
+
 #if SHELL_SUPPORT_ARRAY_PARAM == 1
 /**
  * @brief 估算数组长度
@@ -531,7 +903,7 @@ static int shellEstimateArrayLength(char *string)
  * 
  * @return int 数组长度
  */
-static int shellSplitArray(char *string, char ***array)
+static int shellSplitArray(Shell *shell, char *string, char ***array)
 {
     int strLen = strlen(string);
     if (string[strLen - 1] == ']')
@@ -544,7 +916,15 @@ static int shellSplitArray(char *string, char ***array)
         string++;
     }
     int size = shellEstimateArrayLength(string);
+#if SHELL_ARENA_SIZE > 0
+    *array = shellArenaAlloc(shell, size * sizeof(char *));
+#else
     *array = SHELL_MALLOC(size * sizeof(char *));
+#endif
+    if (*array == NULL)
+    {
+        return -1;
+    }
     return shellSplit(string, strLen, *array, ',', size);
 }
 
@@ -553,47 +933,78 @@ static int shellSplitArray(char *string, char ***array)
  * 
  * @param shell shell 对象
  * @param string 数组参数
- * @param type 参数类型
+ * @param code 参数类型
  * @param result 解析结果
  * 
  * @return int 0 解析成功 -1 解析失败
  */
-static int shellExtParseArray(Shell *shell, char *string, char *type, size_t *result)
+static int shellExtParseArray(Shell *shell, char *string, const ShellParamCode *code, size_t *result)
 {
     char **params;
-    int size = shellSplitArray(string, &params);
+    int size = shellSplitArray(shell, string, &params);
     int elementBytes = sizeof(void *);
 
-    if (strcmp(type + 1, "q") == 0)
+    if (size < 0)
+    {
+        return -1;
+    }
+
+    ShellParamCode element = *code;
+
+    element.array = 0;
+    if (code->type == PARAM_TYPE_INT8)
     {
         elementBytes = sizeof(char);
     }
-    else if (strcmp(type + 1, "h") == 0)
+    else if (code->type == PARAM_TYPE_INT16)
     {
         elementBytes = sizeof(short);
     }
-    else if (strcmp(type + 1, "i") == 0)
+    else if (code->type == PARAM_TYPE_INT32)
     {
         elementBytes = sizeof(int);
     }
+    else if (code->type == PARAM_TYPE_FLOAT)
+    {
+        elementBytes = sizeof(float);
+    }
+    else if (code->type == PARAM_TYPE_INT64 || code->type == PARAM_TYPE_DOUBLE)
+    {
+        elementBytes = sizeof(unsigned long long);
+    }
 
+#if SHELL_ARENA_SIZE > 0
+    ShellArrayHeader *header = shellArenaAlloc(shell, elementBytes * size + sizeof(ShellArrayHeader));
+    if (header == NULL)
+    {
+        return -1;
+    }
+#else
     ShellArrayHeader *header = SHELL_MALLOC(elementBytes * size + sizeof(ShellArrayHeader));
+#endif
     *result = (size_t) ((size_t) header + sizeof(ShellArrayHeader));
     header->size = size;
     header->elementBytes = elementBytes;
     for (short i = 0; i < size; i++)
     {
-        size_t value;
-        if (shellExtParsePara(shell, params[i], type + 1, &value) != 0)
+        size_t value = (size_t) *result + elementBytes * i;
+        if (shellExtParseCode(shell, params[i], &element, &value) != 0)
         {
+        #if SHELL_ARENA_SIZE == 0
             SHELL_FREE(header);
             SHELL_FREE(params);
+        #endif
             return -1;
         }
-        memcpy((void *) ((size_t) *result + elementBytes * i), &value, elementBytes);
+        if (element.type != PARAM_TYPE_INT64 && element.type != PARAM_TYPE_DOUBLE)
+        {
+            memcpy((void *) ((size_t) *result + elementBytes * i), &value, elementBytes);
+        }
     }
 
+#if SHELL_ARENA_SIZE == 0
     SHELL_FREE(params);
+#endif
     return 0;
 }
 
@@ -601,22 +1012,27 @@ static int shellExtParseArray(Shell *shell, char *string, char *type, size_t *re
  * @brief 清理数组参数
  * 
  * @param shell shell 对象
- * @param type 参数类型
+ * @param code 参数类型
  * @param param 参数
  * 
  * @return int 0 清理成功 -1 清理失败
  */
-static int shellExtCleanerArray(Shell *shell, char *type, void *param)
+static int shellExtCleanerArray(Shell *shell, const ShellParamCode *code, void *param)
 {
     ShellArrayHeader *header = (ShellArrayHeader *) ((size_t) param - sizeof(ShellArrayHeader));
-    for (short i = 0; i < header->size; i++)
+    ShellParamCode element = *code;
+
+    element.array = 0;
+    for (short i = 0; element.type == PARAM_TYPE_CUSTOM && i < header->size; i++)
     {
-        if (shellExtCleanerPara(shell, type + 1, *(size_t *) ((size_t) param + header->elementBytes * i)) != 0)
+        if (shellExtCleanerCode(shell, &element, *(size_t *) ((size_t) param + header->elementBytes * i)) != 0)
         {
             return -1;
         }
     }
+#if SHELL_ARENA_SIZE == 0
     SHELL_FREE(header);
+#endif
     return 0;
 }
 
@@ -635,8 +1051,88 @@ int shellGetArrayParamSize(void *param)
 #endif /** SHELL_SUPPORT_ARRAY_PARAM == 1 */
 
 
+#if SHELL_SIGN_POOL_SIZE > 0
+/**
+ * @brief 预编译命令表中的函数签名
+ *        命令表在各个shell之间共享，只会在命令表变化时重新编译，
+ *        池空间不足或者解析器无法在初始化时找到的签名不编译，执行时再解析
+ * 
+ * @param shell shell对象
+ */
+void shellExtSignBuild(Shell *shell)
+{
+    ShellCommand *base = (ShellCommand *)shell->commandList.base;
+    unsigned short count = shell->commandList.count;
+    unsigned short used = 0;
+    char type[16];
+    int number;
+
+    if (shellSign.base == base && shellSign.count == count)
+    {
+        return;
+    }
+    shellSign.base = NULL;
+    if (count > SHELL_CMD_INDEX_SIZE)
+    {
+        return;
+    }
+    for (unsigned short i = 0; i < count; i++)
+    {
+        shellSign.offset[i] = 0;
+        if (base[i].attr.attrs.type > SHELL_TYPE_CMD_FUNC
+            || shellExtGetSignature(&base[i]) == NULL)
+        {
+            continue;
+        }
+        number = shellExtSignCompile(shell, shellExtGetSignature(&base[i]),
+                                     &shellSign.code[used], SHELL_SIGN_POOL_SIZE - used, type);
+        if (number < 0 || number > SHELL_SIGN_POOL_SIZE - used
+            || number >= SHELL_PARAMETER_MAX_NUMBER)
+        {
+            continue;
+        }
+        shellSign.offset[i] = used + 1;
+        shellSign.number[i] = number;
+        used += number;
+    }
+    shellSign.base = base;
+    shellSign.count = count;
+}
+
+
+/**
+ * @brief 获取预编译的函数签名
+ * 
+ * @param shell shell对象
+ * @param command 命令
+ * @param number 参数数量
+ * 
+ * @return const ShellParamCode* 编译后的参数类型，没有编译时返回NULL
+ */
+static const ShellParamCode *shellExtSignGet(Shell *shell, ShellCommand *command, int *number)
+{
+    ShellCommand *base = (ShellCommand *)shell->commandList.base;
+    unsigned short index;
+
+    if (shellSign.base != base || shellSign.count != shell->commandList.count
+        || command < base || command >= base + shellSign.count)
+    {
+        return NULL;
+    }
+    index = command - base;
+    if (shellSign.offset[index] == 0)
+    {
+        return NULL;
+    }
+    *number = shellSign.number[index];
+    return &shellSign.code[shellSign.offset[index] - 1];
+}
+#endif /** SHELL_SIGN_POOL_SIZE > 0 */
+
+
 /**
  * @brief 执行命令
+ * @note 使用参数内存池时，参数个数超过`SHELL_PARAMETER_MAX_NUMBER`直接返回-1，由调用者输出错误
  * 
  * @param shell shell对象
  * @param command 命令
@@ -650,39 +1146,99 @@ int shellExtRun(Shell *shell, ShellCommand *command, int argc, char *argv[])
     size_t params[SHELL_PARAMETER_MAX_NUMBER] = {0};
     int paramNum = command->attr.attrs.paramNum > (argc - 1) ? 
         command->attr.attrs.paramNum : (argc - 1);
+#if SHELL_USING_FUNC_SIGNATURE == 1 || SHELL_EXEC_CACHE_SIZE > 0
+    const ShellParamCode *code = NULL;
+#endif
 #if SHELL_USING_FUNC_SIGNATURE == 1
+    ShellParamCode codeBuffer[SHELL_PARAMETER_MAX_NUMBER];
+    unsigned long long wide[SHELL_PARAMETER_MAX_NUMBER];
     char type[16];
-    int index = 0;
-    
-    if (command->data.cmd.signature != NULL)
+#endif
+#if SHELL_ARENA_SIZE > 0
+    if (argc > SHELL_PARAMETER_MAX_NUMBER)
+    {
+        return -1;
+    }
+#endif
+#if SHELL_USING_FUNC_SIGNATURE == 1
+    const char *signature = shellExtGetSignature(command);
+    if (signature != NULL)
     {
-        int except = shellGetParamNumExcept(command->data.cmd.signature);
+        int except = -1;
+    #if SHELL_SIGN_POOL_SIZE > 0
+        code = shellExtSignGet(shell, command, &except);
+    #endif
+        if (code == NULL)
+        {
+            except = shellExtSignCompile(shell, signature,
+                                         codeBuffer, SHELL_PARAMETER_MAX_NUMBER, type);
+            code = codeBuffer;
+        }
+        if (except < 0)
+        {
+            shellWriteString(shell, "Can't find the param parser for type: ");
+            shellWriteString(shell, type);
+            shellWriteString(shell, "\r\n");
+            return -1;
+        }
         if (except != argc - 1)
         {
             shellWriteString(shell, "Parameters number incorrect\r\n");
             return -1;
         }
     }
+#endif
+#if SHELL_EXEC_CACHE_SIZE > 0
+    ShellExecCache *cache = shell->execCache.current;
+    shell->execCache.current = NULL;
+    if (cache && (cache->command != command || cache->paramCount != argc))
+    {
+        cache = NULL;
+    }
 #endif
     for (int i = 0; i < argc - 1; i++)
     {
+    #if SHELL_EXEC_CACHE_SIZE > 0
+        if (cache && (cache->parsed & (1u << i)))
+        {
+            params[i] = cache->value[i];
+            continue;
+        }
+    #endif
     #if SHELL_USING_FUNC_SIGNATURE == 1
-        if (command->data.cmd.signature != NULL) {
-            index = shellGetNextParamType(command->data.cmd.signature, index, type);
-            if (shellExtParsePara(shell, argv[i + 1], type, &params[i]) != 0)
+        if (code != NULL)
+        {
+            if (!code[i].array
+                && (code[i].type == PARAM_TYPE_INT64 || code[i].type == PARAM_TYPE_DOUBLE))
+            {
+                params[i] = (size_t) &wide[i];
+            }
+            if (shellExtParseCode(shell, argv[i + 1], &code[i], &params[i]) != 0)
             {
                 return -1;
             }
         }
         else
     #endif /** SHELL_USING_FUNC_SIGNATURE == 1 */
+        if (shellExtParsePara(shell, argv[i + 1], NULL, &params[i]) != 0)
         {
-            if (shellExtParsePara(shell, argv[i + 1], NULL, &params[i]) != 0)
-            {
-                return -1;
-            }
+            return -1;
+        }
+    #if SHELL_EXEC_CACHE_SIZE > 0
+        if (cache && !cache->resolved
+            && shellExtParaCacheable(argv[i + 1], code ? &code[i] : NULL))
+        {
+            cache->value[i] = params[i];
+            cache->parsed |= 1u << i;
         }
+    #endif
     }
+#if SHELL_EXEC_CACHE_SIZE > 0
+    if (cache)
+    {
+        cache->resolved = 1;
+    }
+#endif
     switch (paramNum)
     {
 #if SHELL_PARAMETER_MAX_NUMBER >= 1
@@ -840,12 +1396,10 @@ int shellExtRun(Shell *shell, ShellCommand *command, int argc, char *argv[])
     }
     
 #if SHELL_USING_FUNC_SIGNATURE == 1
-    if (command->data.cmd.signature != NULL) {
-        index = 0;
+    if (code != NULL) {
         for (int i = 0; i < argc - 1; i++)
         {
-            index = shellGetNextParamType(command->data.cmd.signature, index, type);
-            shellExtCleanerPara(shell, type, params[i]);
+            shellExtCleanerCode(shell, &code[i], params[i]);
         }
     }
 #endif /** SHELL_USING_FUNC_SIGNATURE == 1 */
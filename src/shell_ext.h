@@ -28,6 +28,35 @@ typedef enum
     NUM_TYPE_FLOAT                                          /**< 浮点型 */
 } ShellNumType;
 
+/**
+ * @brief 函数签名参数类型
+ * 
+ */
+typedef enum
+{
+    PARAM_TYPE_CHAR,                                        /**< 字符 `c` */
+    PARAM_TYPE_INT8,                                        /**< 8位整型 `q` */
+    PARAM_TYPE_INT16,                                       /**< 16位整型 `h` */
+    PARAM_TYPE_INT32,                                       /**< 32位整型 `i` */
+    PARAM_TYPE_FLOAT,                                       /**< 浮点型 `f` */
+    PARAM_TYPE_POINTER,                                     /**< 指针 `p` */
+    PARAM_TYPE_INT64,                                       /**< 64位整型 `l`，以指针传递 */
+    PARAM_TYPE_DOUBLE,                                      /**< 双精度浮点 `d`，以指针传递 */
+    PARAM_TYPE_STRING,                                      /**< 字符串 `s` */
+    PARAM_TYPE_CUSTOM,                                      /**< 自定义类型 `L...;` */
+} ShellParamType;
+
+/**
+ * @brief 编译后的函数签名参数
+ * 
+ */
+typedef struct
+{
+    unsigned char type;                                     /**< 参数类型 */
+    unsigned char array;                                    /**< 是否为数组参数 */
+    unsigned short parser;                                  /**< 自定义类型解析器在命令表中的序号 + 1 */
+} ShellParamCode;
+
 #if SHELL_SUPPORT_ARRAY_PARAM == 1
 typedef struct
 {
@@ -43,6 +72,9 @@ int shellExtCleanerPara(Shell *shell, char *type, size_t param);
 #if SHELL_SUPPORT_ARRAY_PARAM == 1
 int shellGetArrayParamSize(void *param);
 #endif /** SHELL_SUPPORT_ARRAY_PARAM == 1 */
+#if SHELL_SIGN_POOL_SIZE > 0
+void shellExtSignBuild(Shell *shell);
+#endif /** SHELL_SIGN_POOL_SIZE > 0 */
 int shellExtRun(Shell *shell, ShellCommand *command, int argc, char *argv[]);
 
 #endif
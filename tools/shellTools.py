@@ -17,9 +17,13 @@ Copyright
 import os
 import sys
 import re
+import struct
+import json
 
 FILE_PATTERN = r"^.*?\.(cpp|c|h)$"
 SHELL_EXPORT_PATTERN = r"^\s*SHELL_EXPORT_(CMD|CMD_AGENCY|VAR|USER|KEY|KEY_AGENCY|CMD_GROUP|PASSTROUGH)\s*\(\s*\S+\s*,\s*(\S+)\s*,.*$"
+SHELL_DESC_SECTION = "shellDesc"
+SHELL_DESC_ID_PATTERN = r"\{(desc|brief):([0-9a-f]{8})\}"
 
 def isCodeFile(name):
     return re.match(FILE_PATTERN, name) != None
@@ -50,9 +54,93 @@ def getFileEcoding(name):
         except:
             encoding = "ascii"
     return encoding
-    
+
+def readElfSection(name, section):
+    """
+    读取elf文件中的段，返回段地址和段数据
+    """
+    with open(name, "rb") as f:
+        data = f.read()
+    if data[:4] != b"\x7fELF":
+        raise ValueError("%s is not an elf file" % name)
+    is64 = data[4] == 2
+    endian = "<" if data[5] == 1 else ">"
+    if is64:
+        shoff, = struct.unpack_from(endian + "Q", data, 0x28)
+        shentsize, shnum, shstrndx = struct.unpack_from(endian + "HHH", data, 0x3A)
+        headerFormat = endian + "IIQQQQ"
+    else:
+        shoff, = struct.unpack_from(endian + "I", data, 0x20)
+        shentsize, shnum, shstrndx = struct.unpack_from(endian + "HHH", data, 0x2E)
+        headerFormat = endian + "IIIIII"
+    headers = [struct.unpack_from(headerFormat, data, shoff + i * shentsize)
+               for i in range(shnum)]
+    strtab = headers[shstrndx]
+    for header in headers:
+        nameOffset = strtab[4] + header[0]
+        sectionName = data[nameOffset:data.index(b"\0", nameOffset)].decode()
+        if sectionName == section:
+            return header[3], data[header[4]:header[4] + header[5]]
+    raise ValueError("section %s not found in %s" % (section, name))
+
+def getDescDict(name):
+    """
+    从elf文件的shellDesc段生成描述字典，键为描述ID(描述在段中的偏移)
+    """
+    _, data = readElfSection(name, SHELL_DESC_SECTION)
+    descDict = {}
+    start = 0
+    while start < len(data):
+        end = data.index(b"\0", start)
+        if end > start:
+            descDict["%08x" % start] = \
+                data[start:end].decode("utf-8", "replace")
+        start = end + 1
+    return descDict
+
+def getBriefDesc(desc):
+    """
+    获取描述的第一行，和shell列出命令时的显示一致
+    """
+    brief = re.split(r"[\r\n]", desc)[0]
+    return brief[:36] + "..." if len(brief) > 36 else brief
+
+def resolveDescId(descDict, stream, output):
+    """
+    还原终端输出中的描述ID
+    """
+    def replace(matcher):
+        desc = descDict.get(matcher.group(2))
+        if desc is None:
+            return matcher.group(0)
+        return getBriefDesc(desc) if matcher.group(1) == "brief" else desc
+    for line in stream:
+        output.write(re.sub(SHELL_DESC_ID_PATTERN, replace, line))
+        output.flush()
+
+def printUsage():
+    print("usage: shellTools.py <path>              list shell exports in source files")
+    print("       shellTools.py -d <elf> [dict]     generate description dictionary from elf")
+    print("       shellTools.py -r <dict>           resolve description ids from stdin")
+
 
 if __name__ == "__main__":
+    if len(sys.argv) < 2:
+        printUsage()
+        sys.exit(1)
+    if sys.argv[1] == "-d":
+        descDict = getDescDict(sys.argv[2])
+        if len(sys.argv) > 3:
+            with open(sys.argv[3], "w", encoding="utf-8") as f:
+                json.dump(descDict, f, ensure_ascii=False, indent=4)
+        else:
+            print(json.dumps(descDict, ensure_ascii=False, indent=4))
+        sys.exit(0)
+    if sys.argv[1] == "-r":
+        with open(sys.argv[2], encoding="utf-8") as f:
+            descDict = json.load(f)
+        resolveDescId(descDict, sys.stdin, sys.stdout)
+        sys.exit(0)
     path = sys.argv[1]
     itemList = []
     codeLine = ""